@@ -12,7 +12,12 @@ INCLUDEPATH += \
     src/soundcloud
 
 HEADERS += \
+    src/audioplayer/audiocache.h \
+    src/audioplayer/audiocacheconnection.h \
     src/audioplayer/audioplayer.h \
+    src/audioplayer/folderscanner.h \
+    src/audioplayer/queuestore.h \
+    src/audioplayer/shuffleorder.h \
     src/audioplayer/trackmodel.h \
     src/base/artist.h \
     src/base/categorymodel.h \
@@ -20,17 +25,29 @@ HEADERS += \
     src/base/clipboard.h \
     src/base/comment.h \
     src/base/concurrenttransfersmodel.h \
+    src/base/coverart.h \
     src/base/database.h \
+    src/base/downloadindex.h \
+    src/base/imagecache.h \
+    src/base/imagediskcache.h \
+    src/base/imagememorycache.h \
     src/base/json.h \
+    src/base/locallibrary.h \
+    src/base/locallibraryscanner.h \
     src/base/localtrack.h \
+    src/base/localtrackmodel.h \
     src/base/networkproxytypemodel.h \
     src/base/playlist.h \
     src/base/resources.h \
+    src/base/roletable.h \
     src/base/searchhistorymodel.h \
     src/base/selectionmodel.h \
     src/base/servicemodel.h \
     src/base/settings.h \
+    src/base/tagreader.h \
     src/base/track.h \
+    src/base/trackrecord.h \
+    src/base/trackrecordtask.h \
     src/base/transfer.h \
     src/base/transfers.h \
     src/base/utils.h \
@@ -62,25 +79,43 @@ HEADERS += \
     src/soundcloud/soundcloudplaylistmodel.h \
     src/soundcloud/soundcloudsearchtypemodel.h \
     src/soundcloud/soundcloudstreammodel.h \
+    src/soundcloud/soundcloudsync.h \
     src/soundcloud/soundcloudtrack.h \
     src/soundcloud/soundcloudtrackmodel.h \
     src/soundcloud/soundcloudtransfer.h
 
 SOURCES += \
+    src/audioplayer/audiocache.cpp \
+    src/audioplayer/audiocacheconnection.cpp \
     src/audioplayer/audioplayer.cpp \
+    src/audioplayer/folderscanner.cpp \
+    src/audioplayer/queuestore.cpp \
+    src/audioplayer/shuffleorder.cpp \
     src/audioplayer/trackmodel.cpp \
     src/base/artist.cpp \
     src/base/categorymodel.cpp \
     src/base/clipboard.cpp \
     src/base/comment.cpp \
+    src/base/coverart.cpp \
+    src/base/downloadindex.cpp \
+    src/base/imagecache.cpp \
+    src/base/imagediskcache.cpp \
+    src/base/imagememorycache.cpp \
     src/base/json.cpp \
+    src/base/locallibrary.cpp \
+    src/base/locallibraryscanner.cpp \
     src/base/localtrack.cpp \
+    src/base/localtrackmodel.cpp \
     src/base/playlist.cpp \
     src/base/resources.cpp \
+    src/base/roletable.cpp \
     src/base/searchhistorymodel.cpp \
     src/base/selectionmodel.cpp \
     src/base/settings.cpp \
+    src/base/tagreader.cpp \
     src/base/track.cpp \
+    src/base/trackrecord.cpp \
+    src/base/trackrecordtask.cpp \
     src/base/transfer.cpp \
     src/base/transfers.cpp \
     src/base/utils.cpp \
@@ -108,6 +143,7 @@ SOURCES += \
     src/soundcloud/soundcloudplaylist.cpp \
     src/soundcloud/soundcloudplaylistmodel.cpp \
     src/soundcloud/soundcloudstreammodel.cpp \
+    src/soundcloud/soundcloudsync.cpp \
     src/soundcloud/soundcloudtrack.cpp \
     src/soundcloud/soundcloudtrackmodel.cpp \
     src/soundcloud/soundcloudtransfer.cpp
@@ -137,7 +173,6 @@ maemo5 {
         src/maemo5/drawing.h \
         src/maemo5/filterbox.h \
         src/maemo5/image.h \
-        src/maemo5/imagecache.h \
         src/maemo5/listview.h \
         src/maemo5/mainwindow.h \
         src/maemo5/navdelegate.h \
@@ -153,6 +188,7 @@ maemo5 {
         src/maemo5/settingsdialog.h \
         src/maemo5/stackedwindow.h \
         src/maemo5/textbrowser.h \
+        src/maemo5/themecache.h \
         src/maemo5/trackdelegate.h \
         src/maemo5/transferswindow.h \
         src/maemo5/valueselector.h \
@@ -197,7 +233,6 @@ maemo5 {
         src/maemo5/dialog.cpp \
         src/maemo5/filterbox.cpp \
         src/maemo5/image.cpp \
-        src/maemo5/imagecache.cpp \
         src/maemo5/listview.cpp \
         src/maemo5/main.cpp \
         src/maemo5/mainwindow.cpp \
@@ -213,6 +248,7 @@ maemo5 {
         src/maemo5/settingsdialog.cpp \
         src/maemo5/stackedwindow.cpp \
         src/maemo5/textbrowser.cpp \
+        src/maemo5/themecache.cpp \
         src/maemo5/trackdelegate.cpp \
         src/maemo5/transferswindow.cpp \
         src/maemo5/valueselector.cpp \
@@ -273,6 +309,7 @@ maemo5 {
         src/harmattan
     
     HEADERS += \
+        src/base/imageprovider.h \
         src/harmattan/activecolormodel.h \
         src/harmattan/cookiejar.h \
         src/harmattan/definitions.h \
@@ -283,6 +320,7 @@ maemo5 {
         src/harmattan/shareui.h
         
     SOURCES += \
+        src/base/imageprovider.cpp \
         src/harmattan/cookiejar.cpp \
         src/harmattan/main.cpp \
         src/harmattan/maskeditem.cpp \
@@ -334,11 +372,13 @@ maemo5 {
     INCLUDEPATH += src/desktop-qml
     
     HEADERS += \
+        src/base/imageprovider.h \
         src/base/transfermodel.h \
         src/base/transferprioritymodel.h \
         src/desktop-qml/definitions.h
     
     SOURCES += \
+        src/base/imageprovider.cpp \
         src/base/transfermodel.cpp \
         src/desktop-qml/main.cpp
     
@@ -0,0 +1,462 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "audiocache.h"
+#include "audiocacheconnection.h"
+#include "definitions.h"
+#include "settings.h"
+#include "transfers.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QNetworkAccessManager>
+#include <QNetworkProxy>
+#include <QTcpSocket>
+#ifdef MUSIKLOUD_DEBUG
+#include <QDebug>
+#endif
+
+static const quint32 INDEX_MAGIC = 0x4d4b4143; // "MKAC"
+static const quint32 INDEX_VERSION = 1;
+
+// The index is written at most this often while streams are being cached
+static const int SAVE_INTERVAL = 5000;
+
+AudioCache* AudioCache::self = 0;
+
+AudioCache::AudioCache(QObject *parent) :
+    QObject(parent),
+    m_manager(new QNetworkAccessManager(this)),
+    m_directory(CACHE_PATH + "audio/"),
+    m_size(0),
+    m_maximumSize(qint64(DEFAULT_AUDIO_CACHE_SIZE) * 1024 * 1024)
+{
+    if (!self) {
+        self = this;
+    }
+
+    if (Settings *settings = Settings::instance()) {
+        m_maximumSize = qint64(settings->audioCacheSize()) * 1024 * 1024;
+        connect(settings, SIGNAL(audioCacheSizeChanged()), this, SLOT(onAudioCacheSizeChanged()));
+    }
+
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(SAVE_INTERVAL);
+    connect(&m_saveTimer, SIGNAL(timeout()), this, SLOT(save()));
+
+    load();
+
+    // The application proxy must not be used for connections from the media backend
+    m_server.setProxy(QNetworkProxy::NoProxy);
+    connect(&m_server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+
+    if (!m_server.listen(QHostAddress::LocalHost)) {
+#ifdef MUSIKLOUD_DEBUG
+        qDebug() << "AudioCache: Cannot listen:" << m_server.errorString();
+#endif
+    }
+}
+
+AudioCache::~AudioCache() {
+    m_server.close();
+    save();
+
+    if (self == this) {
+        self = 0;
+    }
+}
+
+AudioCache* AudioCache::instance() {
+    return self;
+}
+
+QString AudioCache::directory() const {
+    return m_directory;
+}
+
+qint64 AudioCache::maximumSize() const {
+    return m_maximumSize;
+}
+
+void AudioCache::setMaximumSize(qint64 size) {
+    m_maximumSize = qMax(qint64(0), size);
+    expire();
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioCache::setMaximumSize" << m_maximumSize;
+#endif
+}
+
+qint64 AudioCache::size() const {
+    return m_size;
+}
+
+QUrl AudioCache::proxyUrl(const QUrl &url, const QString &service, const QString &id, const QString &format) {
+    if ((m_maximumSize <= 0) || (!m_server.isListening()) || (id.isEmpty())
+        || ((url.scheme() != "http") && (url.scheme() != "https"))) {
+        return url;
+    }
+
+    const QString k = key(url, service, id, format);
+    Entry &entry = m_entries[k];
+    // Resolved stream URLs are often signed and expire, so the latest one always replaces the previous one
+    entry.url = url;
+    entry.lastAccessed = QDateTime::currentMSecsSinceEpoch();
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioCache::proxyUrl" << service << id << format << entry.size << "bytes cached";
+#endif
+    return QUrl(QString("http://127.0.0.1:%1/%2").arg(m_server.serverPort()).arg(k));
+}
+
+QUrl AudioCache::transferUrl(const QString &service, const QString &id) const {
+    if ((!m_server.isListening()) || (!Transfers::instance())) {
+        return QUrl();
+    }
+
+    const Transfer *transfer = Transfers::instance()->get(service, id);
+
+    // Only downloads that have written some data and have not been converted can be played
+    if ((!transfer) || (transfer->transferType() != Transfer::Download) || (transfer->bytesTransferred() <= 0)
+        || (transfer->status() == Transfer::Converting) || (transfer->status() == Transfer::Canceled)
+        || (!QFile::exists(transfer->downloadPath() + transfer->fileName()))) {
+        return QUrl();
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioCache::transferUrl" << service << id << transfer->bytesTransferred() << "bytes downloaded";
+#endif
+    return QUrl(QString("http://127.0.0.1:%1/transfers/%2").arg(m_server.serverPort()).arg(transfer->id()));
+}
+
+void AudioCache::clear() {
+    QMutableHashIterator<QString, Entry> iterator(m_entries);
+
+    while (iterator.hasNext()) {
+        iterator.next();
+
+        // Streams that are being played are kept until they are released
+        if (iterator.value().connections == 0) {
+            m_size -= iterator.value().size;
+            QFile::remove(fileName(iterator.key()));
+            iterator.remove();
+        }
+    }
+
+    scheduleSave();
+}
+
+QString AudioCache::key(const QUrl &url, const QString &service, const QString &id, const QString &format) {
+    // A resolved stream is identified by its format, since its URL changes each time it is resolved. Otherwise the
+    // URL identifies the stream, as tracks such as the episodes of a podcast feed can share an id.
+    const QString stream = format.isEmpty() ? url.toString() : format;
+    return QString::fromLatin1(QCryptographicHash::hash(QString(service + '/' + id + '/' + stream).toUtf8(),
+                                                        QCryptographicHash::Md5).toHex());
+}
+
+QString AudioCache::fileName(const QString &key) const {
+    return m_directory + key;
+}
+
+bool AudioCache::contains(const QString &key) const {
+    return m_entries.contains(key);
+}
+
+Transfer* AudioCache::transfer(const QString &transferId) const {
+    return Transfers::instance() ? Transfers::instance()->get(transferId) : 0;
+}
+
+QUrl AudioCache::url(const QString &key) const {
+    return m_entries.value(key).url;
+}
+
+qint64 AudioCache::length(const QString &key) const {
+    return m_entries.contains(key) ? m_entries[key].length : -1;
+}
+
+QString AudioCache::contentType(const QString &key) const {
+    return m_entries.value(key).contentType;
+}
+
+void AudioCache::setLength(const QString &key, qint64 length, const QString &contentType) {
+    if (!m_entries.contains(key)) {
+        return;
+    }
+
+    Entry &entry = m_entries[key];
+
+    if ((entry.length >= 0) && (entry.length != length)) {
+        // The remote resource has changed, so the cached ranges are no longer valid
+        m_size -= entry.size;
+        entry.size = 0;
+        entry.ranges.clear();
+    }
+
+    entry.length = length;
+
+    if (!contentType.isEmpty()) {
+        entry.contentType = contentType;
+    }
+
+    scheduleSave();
+}
+
+qint64 AudioCache::cachedBytes(const QString &key, qint64 position) const {
+    if (!m_entries.contains(key)) {
+        return 0;
+    }
+
+    foreach (const Range &range, m_entries[key].ranges) {
+        if (range.first > position) {
+            break;
+        }
+
+        if (range.second > position) {
+            return range.second - position;
+        }
+    }
+
+    return 0;
+}
+
+qint64 AudioCache::nextCachedPosition(const QString &key, qint64 position) const {
+    if (!m_entries.contains(key)) {
+        return -1;
+    }
+
+    foreach (const Range &range, m_entries[key].ranges) {
+        if (range.first > position) {
+            return range.first;
+        }
+    }
+
+    return -1;
+}
+
+bool AudioCache::canCache(const QString &key, qint64 bytes) const {
+    return (m_entries.contains(key)) && (m_entries[key].size + bytes <= m_maximumSize);
+}
+
+void AudioCache::addRange(const QString &key, qint64 start, qint64 end) {
+    if ((end <= start) || (!m_entries.contains(key))) {
+        return;
+    }
+
+    Entry &entry = m_entries[key];
+    QList<Range> ranges;
+    Range added(start, end);
+    int i = 0;
+
+    // The ranges are kept sorted and merged, so that lookups only need a single pass
+    while ((i < entry.ranges.size()) && (entry.ranges.at(i).second < added.first)) {
+        ranges << entry.ranges.at(i++);
+    }
+
+    while ((i < entry.ranges.size()) && (entry.ranges.at(i).first <= added.second)) {
+        added.first = qMin(added.first, entry.ranges.at(i).first);
+        added.second = qMax(added.second, entry.ranges.at(i).second);
+        i++;
+    }
+
+    ranges << added;
+
+    while (i < entry.ranges.size()) {
+        ranges << entry.ranges.at(i++);
+    }
+
+    qint64 size = 0;
+
+    foreach (const Range &range, ranges) {
+        size += range.second - range.first;
+    }
+
+    entry.ranges = ranges;
+    m_size += size - entry.size;
+    entry.size = size;
+    expire();
+    scheduleSave();
+}
+
+void AudioCache::acquire(const QString &key) {
+    if (m_entries.contains(key)) {
+        Entry &entry = m_entries[key];
+        entry.connections++;
+        entry.lastAccessed = QDateTime::currentMSecsSinceEpoch();
+    }
+}
+
+void AudioCache::release(const QString &key) {
+    if (m_entries.contains(key)) {
+        Entry &entry = m_entries[key];
+        entry.connections = qMax(0, entry.connections - 1);
+        entry.lastAccessed = QDateTime::currentMSecsSinceEpoch();
+    }
+}
+
+void AudioCache::load() {
+    QDir().mkpath(m_directory);
+    QFile file(m_directory + "index");
+
+    if (!file.open(QFile::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_7);
+    quint32 magic;
+    quint32 version;
+    qint32 count;
+    stream >> magic >> version >> count;
+
+    if ((magic != INDEX_MAGIC) || (version != INDEX_VERSION)) {
+        return;
+    }
+
+    for (int i = 0; (i < count) && (stream.status() == QDataStream::Ok); i++) {
+        QString k;
+        Entry entry;
+        stream >> k >> entry.length >> entry.contentType >> entry.ranges >> entry.lastAccessed;
+
+        if ((stream.status() != QDataStream::Ok) || (entry.ranges.isEmpty())) {
+            continue;
+        }
+
+        // Discard entries whose file is missing or shorter than the recorded ranges
+        if (QFileInfo(fileName(k)).size() < entry.ranges.last().second) {
+            QFile::remove(fileName(k));
+            continue;
+        }
+
+        foreach (const Range &range, entry.ranges) {
+            entry.size += range.second - range.first;
+        }
+
+        m_entries[k] = entry;
+        m_size += entry.size;
+    }
+
+    // Remove any files that are not in the index
+    foreach (const QString &fileName, QDir(m_directory).entryList(QDir::Files)) {
+        if ((fileName != "index") && (!m_entries.contains(fileName))) {
+            QFile::remove(m_directory + fileName);
+        }
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioCache::load" << m_entries.size() << "streams" << m_size << "bytes";
+#endif
+    expire();
+}
+
+void AudioCache::save() {
+    m_saveTimer.stop();
+
+    if (!QDir().mkpath(m_directory)) {
+        return;
+    }
+
+    // Write to a temporary file first, so that an interrupted write never leaves a truncated index
+    const QString name = m_directory + "index";
+    QFile file(name + ".tmp");
+
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        return;
+    }
+
+    QList<QString> keys;
+    QHashIterator<QString, Entry> iterator(m_entries);
+
+    while (iterator.hasNext()) {
+        iterator.next();
+
+        if (!iterator.value().ranges.isEmpty()) {
+            keys << iterator.key();
+        }
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_7);
+    stream << INDEX_MAGIC << INDEX_VERSION << qint32(keys.size());
+
+    foreach (const QString &k, keys) {
+        const Entry &entry = m_entries[k];
+        stream << k << entry.length << entry.contentType << entry.ranges << entry.lastAccessed;
+    }
+
+    file.close();
+
+    if (stream.status() != QDataStream::Ok) {
+        file.remove();
+        return;
+    }
+
+    QFile::remove(name);
+    file.rename(name);
+}
+
+void AudioCache::expire() {
+    if (m_size <= m_maximumSize) {
+        return;
+    }
+
+    // Remove the least recently used streams until the cache is 10% below its maximum size,
+    // so that eviction does not run on every write once the cache is full
+    const qint64 target = m_maximumSize - m_maximumSize / 10;
+    QMultiMap<qint64, QString> lru;
+    QHashIterator<QString, Entry> iterator(m_entries);
+
+    while (iterator.hasNext()) {
+        iterator.next();
+
+        if ((iterator.value().connections == 0) && (iterator.value().size > 0)) {
+            lru.insert(iterator.value().lastAccessed, iterator.key());
+        }
+    }
+
+    QMapIterator<qint64, QString> lruIterator(lru);
+
+    while ((m_size > target) && (lruIterator.hasNext())) {
+        lruIterator.next();
+        Entry &entry = m_entries[lruIterator.value()];
+        m_size -= entry.size;
+        entry.size = 0;
+        entry.length = -1;
+        entry.ranges.clear();
+        QFile::remove(fileName(lruIterator.value()));
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioCache::expire" << m_size << "bytes";
+#endif
+    scheduleSave();
+}
+
+void AudioCache::scheduleSave() {
+    if (!m_saveTimer.isActive()) {
+        m_saveTimer.start();
+    }
+}
+
+void AudioCache::onNewConnection() {
+    while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+        new AudioCacheConnection(socket, m_manager, this);
+    }
+}
+
+void AudioCache::onAudioCacheSizeChanged() {
+    if (Settings *settings = Settings::instance()) {
+        setMaximumSize(qint64(settings->audioCacheSize()) * 1024 * 1024);
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AUDIOCACHE_H
+#define AUDIOCACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QPair>
+#include <QTcpServer>
+#include <QTimer>
+#include <QUrl>
+
+class Transfer;
+class QNetworkAccessManager;
+
+/*
+ * Loopback HTTP proxy for streamed audio. proxyUrl() maps a remote stream to a local URL that can be passed
+ * to QMediaPlayer. Bytes fetched from the remote server are written to a sparse file per stream, keyed by
+ * service, resource id and either the format of a resolved stream or the URL of any other stream, so that
+ * replaying or seeking within a stream is served from disk.
+ * transferUrl() maps an active download to a local URL that plays its partially downloaded file.
+ * When the total size exceeds maximumSize(), the least recently used streams that are not being played are
+ * removed. All methods must be called from the thread in which the cache was created.
+ */
+class AudioCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AudioCache(QObject *parent = 0);
+    ~AudioCache();
+
+    static AudioCache* instance();
+
+    QString directory() const;
+
+    qint64 maximumSize() const;
+    void setMaximumSize(qint64 size);
+
+    qint64 size() const;
+
+    QUrl proxyUrl(const QUrl &url, const QString &service, const QString &id, const QString &format);
+    QUrl transferUrl(const QString &service, const QString &id) const;
+
+public Q_SLOTS:
+    void clear();
+
+private Q_SLOTS:
+    void onNewConnection();
+    void onAudioCacheSizeChanged();
+
+    void save();
+
+private:
+    friend class AudioCacheConnection;
+
+    typedef QPair<qint64, qint64> Range;
+
+    struct Entry {
+        Entry() : length(-1), size(0), lastAccessed(0), connections(0) {}
+
+        QUrl url;
+        qint64 length;
+        QString contentType;
+        QList<Range> ranges;
+        qint64 size;
+        qint64 lastAccessed;
+        int connections;
+    };
+
+    static QString key(const QUrl &url, const QString &service, const QString &id, const QString &format);
+
+    QString fileName(const QString &key) const;
+
+    bool contains(const QString &key) const;
+
+    Transfer* transfer(const QString &transferId) const;
+
+    QUrl url(const QString &key) const;
+
+    qint64 length(const QString &key) const;
+    QString contentType(const QString &key) const;
+    void setLength(const QString &key, qint64 length, const QString &contentType);
+
+    qint64 cachedBytes(const QString &key, qint64 position) const;
+    qint64 nextCachedPosition(const QString &key, qint64 position) const;
+    bool canCache(const QString &key, qint64 bytes) const;
+    void addRange(const QString &key, qint64 start, qint64 end);
+
+    void acquire(const QString &key);
+    void release(const QString &key);
+
+    void load();
+    void expire();
+    void scheduleSave();
+
+    static AudioCache *self;
+
+    QTcpServer m_server;
+    QNetworkAccessManager *m_manager;
+
+    QString m_directory;
+
+    QHash<QString, Entry> m_entries;
+    qint64 m_size;
+
+    qint64 m_maximumSize;
+
+    QTimer m_saveTimer;
+};
+
+#endif // AUDIOCACHE_H
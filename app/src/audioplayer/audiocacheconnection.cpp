@@ -0,0 +1,588 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "audiocacheconnection.h"
+#include "audiocache.h"
+#include "definitions.h"
+#include "transfer.h"
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QRegExp>
+#include <QTcpSocket>
+#ifdef MUSIKLOUD_DEBUG
+#include <QDebug>
+#endif
+
+static const int CHUNK_SIZE = 64 * 1024;
+
+// No more data is read from the cache file or the remote server while this much is waiting to be written
+static const int MAX_BUFFERED_BYTES = 256 * 1024;
+
+static const int MAX_REQUEST_SIZE = 16 * 1024;
+
+// A request this far ahead of the bytes written by a transfer is fetched from the remote server
+// instead of waiting for the transfer to reach it
+static const qint64 MAX_TRANSFER_WAIT_DISTANCE = 512 * 1024;
+
+static const int TRANSFER_WAIT_INTERVAL = 250;
+
+AudioCacheConnection::AudioCacheConnection(QTcpSocket *socket, QNetworkAccessManager *manager, AudioCache *cache) :
+    QObject(cache),
+    m_cache(cache),
+    m_manager(manager),
+    m_socket(socket),
+    m_reply(0),
+    m_position(0),
+    m_end(-1),
+    m_gapEnd(-1),
+    m_skip(0),
+    m_received(0),
+    m_transferLength(-1),
+    m_redirects(0),
+    m_acquired(false),
+    m_head(false),
+    m_range(false),
+    m_headerWritten(false),
+    m_finished(false)
+{
+    m_socket->setParent(this);
+    connect(m_socket, SIGNAL(readyRead()), this, SLOT(onSocketReadyRead()));
+    connect(m_socket, SIGNAL(bytesWritten(qint64)), this, SLOT(onSocketBytesWritten()));
+    connect(m_socket, SIGNAL(disconnected()), this, SLOT(onSocketDisconnected()));
+
+    m_waitTimer.setSingleShot(true);
+    m_waitTimer.setInterval(TRANSFER_WAIT_INTERVAL);
+    connect(&m_waitTimer, SIGNAL(timeout()), this, SLOT(onWaitTimeout()));
+}
+
+AudioCacheConnection::~AudioCacheConnection() {
+    deleteReply();
+    m_file.close();
+
+    if (m_acquired) {
+        m_cache->release(m_key);
+    }
+}
+
+bool AudioCacheConnection::parseRequest() {
+    const QList<QByteArray> lines = m_request.left(m_request.indexOf("\r\n\r\n")).split('\n');
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+
+    if (requestLine.size() < 2) {
+        writeError(400, "Bad Request");
+        return false;
+    }
+
+    if (requestLine.first() == "HEAD") {
+        m_head = true;
+    }
+    else if (requestLine.first() != "GET") {
+        writeError(405, "Method Not Allowed");
+        return false;
+    }
+
+    const QString key = QString::fromLatin1(requestLine.at(1).mid(1));
+
+    if (key.startsWith("transfers/")) {
+        m_transfer = m_cache->transfer(key.mid(10));
+
+        if (!m_transfer) {
+            writeError(404, "Not Found");
+            return false;
+        }
+
+        m_transferLength = (m_transfer->size() > 0 ? m_transfer->size() : -1);
+    }
+    else if ((!m_cache->contains(key)) || (m_cache->url(key).isEmpty())) {
+        writeError(404, "Not Found");
+        return false;
+    }
+
+    m_key = key;
+    QRegExp re("^range:\\s*bytes=(\\d+)-(\\d*)", Qt::CaseInsensitive);
+
+    for (int i = 1; i < lines.size(); i++) {
+        if (re.indexIn(QString::fromLatin1(lines.at(i).trimmed())) == 0) {
+            m_range = true;
+            m_position = re.cap(1).toLongLong();
+
+            if (!re.cap(2).isEmpty()) {
+                m_end = re.cap(2).toLongLong();
+            }
+
+            break;
+        }
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioCacheConnection::parseRequest" << requestLine.first() << m_key << m_position << m_end;
+#endif
+    return true;
+}
+
+qint64 AudioCacheConnection::length() const {
+    return m_transferLength >= 0 ? m_transferLength : m_cache->length(m_key);
+}
+
+qint64 AudioCacheConnection::availableBytes() const {
+    if (!m_file.isOpen()) {
+        return 0;
+    }
+
+    // The size of a transfer's file is read each time, since the transfer is still writing to it
+    return m_key.startsWith("transfers/") ? m_file.size() - m_position : m_cache->cachedBytes(m_key, m_position);
+}
+
+void AudioCacheConnection::writeHeader() {
+    const qint64 length = this->length();
+    QByteArray header;
+
+    if (length >= 0) {
+        m_end = (m_end >= 0 ? qMin(m_end, length - 1) : length - 1);
+
+        if (m_range) {
+            header = "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " + QByteArray::number(m_position) + "-"
+                     + QByteArray::number(m_end) + "/" + QByteArray::number(length) + "\r\n";
+        }
+        else {
+            header = "HTTP/1.1 200 OK\r\n";
+        }
+
+        header += "Content-Length: " + QByteArray::number(m_end - m_position + 1) + "\r\n";
+    }
+    else if ((m_range) && (m_end >= m_position)) {
+        // The length is unknown, so no total size is sent
+        header = "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " + QByteArray::number(m_position) + "-"
+                 + QByteArray::number(m_end) + "/*\r\nContent-Length: " + QByteArray::number(m_end - m_position + 1)
+                 + "\r\n";
+    }
+    else {
+        // An open-ended range cannot be described without the total size, so it is ignored and the whole
+        // stream is sent, and the end of the response is indicated by closing the connection
+        m_position = 0;
+        m_end = -1;
+        header = "HTTP/1.1 200 OK\r\n";
+    }
+
+    const QString contentType = m_cache->contentType(m_key);
+
+    if (!contentType.isEmpty()) {
+        header += "Content-Type: " + contentType.toLatin1() + "\r\n";
+    }
+
+    header += "Accept-Ranges: bytes\r\nConnection: close\r\n\r\n";
+    m_socket->write(header);
+    m_headerWritten = true;
+
+    if (m_head) {
+        finish();
+    }
+}
+
+void AudioCacheConnection::writeError(int code, const QString &reason) {
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioCacheConnection::writeError" << code << reason;
+#endif
+    if (!m_headerWritten) {
+        m_socket->write(QString("HTTP/1.1 %1 %2\r\nContent-Length: 0\r\nConnection: close\r\n\r\n").arg(code)
+                        .arg(reason).toLatin1());
+        m_headerWritten = true;
+    }
+
+    finish();
+}
+
+void AudioCacheConnection::serve() {
+    if ((m_finished) || (m_reply)) {
+        return;
+    }
+
+    while (m_socket->bytesToWrite() < MAX_BUFFERED_BYTES) {
+        if ((m_end >= 0) && (m_position > m_end)) {
+            finish();
+            return;
+        }
+
+        const qint64 available = availableBytes();
+
+        if (available <= 0) {
+            break;
+        }
+
+        qint64 bytes = qMin(available, qint64(CHUNK_SIZE));
+
+        if (m_end >= 0) {
+            bytes = qMin(bytes, m_end - m_position + 1);
+        }
+
+        QByteArray data;
+
+        if (m_file.seek(m_position)) {
+            data = m_file.read(bytes);
+        }
+
+        if (data.isEmpty()) {
+            break;
+        }
+
+        m_socket->write(data);
+        m_position += data.size();
+    }
+
+    if (m_socket->bytesToWrite() >= MAX_BUFFERED_BYTES) {
+        // Continue when the media backend has read some of the data
+        return;
+    }
+
+    if (m_key.startsWith("transfers/")) {
+        waitForTransfer();
+        return;
+    }
+
+    // Fetch the bytes up to the next cached range, or the end of the response, from the remote server
+    const qint64 next = m_cache->nextCachedPosition(m_key, m_position);
+    m_gapEnd = (next >= 0 ? next - 1 : -1);
+
+    if ((m_end >= 0) && ((m_gapEnd < 0) || (m_gapEnd > m_end))) {
+        m_gapEnd = m_end;
+    }
+
+    m_redirects = 0;
+    getRemoteData(m_cache->url(m_key));
+}
+
+void AudioCacheConnection::waitForTransfer() {
+    const qint64 written = m_file.size();
+    const bool downloading = (m_transfer) && ((m_transfer->status() == Transfer::Downloading)
+                                              || (m_transfer->status() == Transfer::Connecting));
+
+    if ((downloading) && (m_position - written < MAX_TRANSFER_WAIT_DISTANCE)) {
+        m_waitTimer.start();
+        return;
+    }
+
+    if ((!m_transfer) && (m_position >= written)) {
+        // The transfer has completed, so there is nothing more to read
+        finish();
+        return;
+    }
+
+    if ((m_transfer) && (!m_transfer->url().isEmpty())) {
+#ifdef MUSIKLOUD_DEBUG
+        qDebug() << "AudioCacheConnection::waitForTransfer: Requested position" << m_position
+                 << "is not available in transfer" << m_transfer->id();
+#endif
+        // Transfers download sequentially, so the requested range is fetched separately while the transfer
+        // is moved ahead of any queued transfers
+        m_transfer->setPriority(Transfer::HighPriority);
+        m_gapEnd = m_end;
+        m_redirects = 0;
+        getRemoteData(m_transfer->url());
+        return;
+    }
+
+    finish();
+}
+
+void AudioCacheConnection::getRemoteData(const QUrl &url) {
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioCacheConnection::getRemoteData" << url << m_position << m_gapEnd;
+#endif
+    QByteArray range = "bytes=" + QByteArray::number(m_position) + "-";
+
+    if (m_gapEnd >= 0) {
+        range += QByteArray::number(m_gapEnd);
+    }
+
+    QNetworkRequest request(url);
+    request.setRawHeader("Range", range);
+    m_skip = 0;
+    m_received = 0;
+    m_reply = m_manager->get(request);
+    m_reply->setReadBufferSize(MAX_BUFFERED_BYTES);
+    connect(m_reply, SIGNAL(metaDataChanged()), this, SLOT(onReplyMetaDataChanged()));
+    connect(m_reply, SIGNAL(readyRead()), this, SLOT(onReplyReadyRead()));
+    connect(m_reply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
+}
+
+void AudioCacheConnection::deleteReply() {
+    if (m_reply) {
+        m_reply->disconnect(this);
+
+        if (!m_reply->isFinished()) {
+            m_reply->abort();
+        }
+
+        m_reply->deleteLater();
+        m_reply = 0;
+    }
+}
+
+void AudioCacheConnection::finish() {
+    if (m_finished) {
+        return;
+    }
+
+    m_finished = true;
+    deleteReply();
+
+    if (m_socket->state() == QAbstractSocket::UnconnectedState) {
+        deleteLater();
+    }
+    else {
+        // Pending data is written before the connection is closed
+        m_socket->disconnectFromHost();
+    }
+}
+
+void AudioCacheConnection::onSocketReadyRead() {
+    if ((m_finished) || (!m_key.isEmpty())) {
+        m_socket->readAll();
+        return;
+    }
+
+    m_request += m_socket->readAll();
+
+    if (!m_request.contains("\r\n\r\n")) {
+        if (m_request.size() > MAX_REQUEST_SIZE) {
+            writeError(400, "Bad Request");
+        }
+
+        return;
+    }
+
+    if (!parseRequest()) {
+        return;
+    }
+
+    if (m_transfer) {
+        m_file.setFileName(m_transfer->downloadPath() + m_transfer->fileName());
+
+        if (!m_file.open(QFile::ReadOnly)) {
+            writeError(404, "Not Found");
+            return;
+        }
+    }
+    else {
+        m_cache->acquire(m_key);
+        m_acquired = true;
+        m_file.setFileName(m_cache->fileName(m_key));
+
+        if (!m_file.open(QFile::ReadWrite)) {
+#ifdef MUSIKLOUD_DEBUG
+            qDebug() << "AudioCacheConnection: Cannot open cache file:" << m_file.errorString();
+#endif
+        }
+    }
+
+    const qint64 length = this->length();
+
+    if ((length >= 0) || (m_transfer)) {
+        if ((m_range) && (length >= 0) && (m_position >= length)) {
+            writeError(416, "Requested Range Not Satisfiable");
+            return;
+        }
+
+        writeHeader();
+        serve();
+    }
+    else {
+        // The header is written when the length of the stream is known
+        m_gapEnd = m_end;
+        getRemoteData(m_cache->url(m_key));
+    }
+}
+
+void AudioCacheConnection::onSocketBytesWritten() {
+    if (m_reply) {
+        onReplyReadyRead();
+    }
+    else if ((m_headerWritten) && (!m_finished)) {
+        serve();
+    }
+}
+
+void AudioCacheConnection::onSocketDisconnected() {
+    m_finished = true;
+    m_waitTimer.stop();
+    deleteReply();
+    deleteLater();
+}
+
+void AudioCacheConnection::onReplyMetaDataChanged() {
+    const int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    qint64 length = -1;
+
+    if (status == 206) {
+        QRegExp re("bytes\\s+(\\d+)-\\d+/(\\d+|\\*)");
+
+        if (re.indexIn(QString::fromLatin1(m_reply->rawHeader("Content-Range"))) == -1) {
+            return;
+        }
+
+        const qint64 start = re.cap(1).toLongLong();
+
+        if (start > m_position) {
+            deleteReply();
+            writeError(502, "Bad Gateway");
+            return;
+        }
+
+        m_skip = m_position - start;
+
+        if (re.cap(2) != "*") {
+            length = re.cap(2).toLongLong();
+        }
+    }
+    else if (status == 200) {
+        // The server does not support ranges, so the data before the requested position is skipped
+        m_skip = m_position;
+        const QVariant contentLength = m_reply->header(QNetworkRequest::ContentLengthHeader);
+
+        if (contentLength.isValid()) {
+            length = contentLength.toLongLong();
+        }
+    }
+    else {
+        // Redirects and errors are handled when the reply is finished
+        return;
+    }
+
+    if (length >= 0) {
+        m_cache->setLength(m_key, length, m_reply->header(QNetworkRequest::ContentTypeHeader).toString());
+    }
+
+    if (!m_headerWritten) {
+        if ((m_range) && (length >= 0) && (m_position >= length)) {
+            deleteReply();
+            writeError(416, "Requested Range Not Satisfiable");
+            return;
+        }
+
+        const qint64 position = m_position;
+        writeHeader();
+
+        if ((m_position != position) && (!m_finished)) {
+            // The requested range has been ignored, so the stream is fetched again from the start
+            const QUrl url = m_reply->url();
+            deleteReply();
+            m_gapEnd = m_end;
+            getRemoteData(url);
+        }
+    }
+}
+
+void AudioCacheConnection::onReplyReadyRead() {
+    if ((!m_reply) || (!m_headerWritten) || (m_finished)) {
+        return;
+    }
+
+    const int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if ((status != 200) && (status != 206)) {
+        return;
+    }
+
+    while ((m_socket->bytesToWrite() < MAX_BUFFERED_BYTES) && (m_reply->bytesAvailable() > 0)) {
+        QByteArray data = m_reply->read(CHUNK_SIZE);
+        m_received += data.size();
+
+        if (m_skip > 0) {
+            const int skip = int(qMin(m_skip, qint64(data.size())));
+            data.remove(0, skip);
+            m_skip -= skip;
+        }
+
+        if (m_gapEnd >= 0) {
+            data.truncate(int(qMin(qint64(data.size()), m_gapEnd - m_position + 1)));
+        }
+
+        if (!data.isEmpty()) {
+            if ((m_file.isOpen()) && (m_cache->canCache(m_key, data.size())) && (m_file.seek(m_position))
+                && (m_file.write(data) == data.size()) && (m_file.flush())) {
+                m_cache->addRange(m_key, m_position, m_position + data.size());
+            }
+
+            m_socket->write(data);
+            m_position += data.size();
+        }
+
+        if ((m_gapEnd >= 0) && (m_position > m_gapEnd)) {
+            // The remaining bytes are either cached or were not requested
+            deleteReply();
+            serve();
+            return;
+        }
+    }
+
+    if ((m_reply->isFinished()) && (m_reply->bytesAvailable() == 0)) {
+        const bool received = (m_received > 0);
+        deleteReply();
+
+        if ((received) && (length() >= 0)) {
+            serve();
+        }
+        else {
+            finish();
+        }
+    }
+}
+
+void AudioCacheConnection::onReplyFinished() {
+    if (!m_reply) {
+        return;
+    }
+
+    const QVariant redirect = m_reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
+
+    if (!redirect.isNull()) {
+        const QUrl url = m_reply->url().resolved(redirect.toUrl());
+        deleteReply();
+
+        if (m_redirects < MAX_REDIRECTS) {
+            m_redirects++;
+            getRemoteData(url);
+        }
+        else {
+            writeError(502, "Bad Gateway");
+        }
+
+        return;
+    }
+
+    if (m_reply->error() != QNetworkReply::NoError) {
+#ifdef MUSIKLOUD_DEBUG
+        qDebug() << "AudioCacheConnection::onReplyFinished" << m_reply->errorString();
+#endif
+        deleteReply();
+        writeError(502, "Bad Gateway");
+        return;
+    }
+
+    if (!m_headerWritten) {
+        deleteReply();
+        writeError(502, "Bad Gateway");
+        return;
+    }
+
+    onReplyReadyRead();
+}
+
+void AudioCacheConnection::onWaitTimeout() {
+    if (!m_finished) {
+        serve();
+    }
+}
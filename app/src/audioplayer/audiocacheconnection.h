@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AUDIOCACHECONNECTION_H
+#define AUDIOCACHECONNECTION_H
+
+#include <QObject>
+#include <QFile>
+#include <QPointer>
+#include <QTimer>
+
+class AudioCache;
+class Transfer;
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTcpSocket;
+
+/*
+ * Serves a single HTTP request from the media backend. Cached ranges are read from the stream's cache file,
+ * and the gaps between them are fetched from the remote server, written to the cache file and forwarded.
+ * Requests for a transfer are served from its partially downloaded file, waiting for bytes that have not
+ * yet been written. The connection deletes itself when the socket is disconnected.
+ */
+class AudioCacheConnection : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AudioCacheConnection(QTcpSocket *socket, QNetworkAccessManager *manager, AudioCache *cache);
+    ~AudioCacheConnection();
+
+private Q_SLOTS:
+    void onSocketReadyRead();
+    void onSocketBytesWritten();
+    void onSocketDisconnected();
+
+    void onReplyMetaDataChanged();
+    void onReplyReadyRead();
+    void onReplyFinished();
+
+    void onWaitTimeout();
+
+private:
+    bool parseRequest();
+
+    qint64 length() const;
+    qint64 availableBytes() const;
+
+    void writeHeader();
+    void writeError(int code, const QString &reason);
+
+    void serve();
+    void waitForTransfer();
+
+    void getRemoteData(const QUrl &url);
+    void deleteReply();
+
+    void finish();
+
+    AudioCache *m_cache;
+    QNetworkAccessManager *m_manager;
+    QTcpSocket *m_socket;
+    QNetworkReply *m_reply;
+
+    QPointer<Transfer> m_transfer;
+
+    QFile m_file;
+
+    QTimer m_waitTimer;
+
+    QByteArray m_request;
+    QString m_key;
+
+    qint64 m_position;
+    qint64 m_end;
+    qint64 m_gapEnd;
+    qint64 m_skip;
+    qint64 m_received;
+    qint64 m_transferLength;
+
+    int m_redirects;
+
+    bool m_acquired;
+    bool m_head;
+    bool m_range;
+    bool m_headerWritten;
+    bool m_finished;
+};
+
+#endif // AUDIOCACHECONNECTION_H
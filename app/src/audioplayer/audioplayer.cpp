@@ -15,36 +15,60 @@
  */
 
 #include "audioplayer.h"
+#include "audiocache.h"
 #include "definitions.h"
+#include "downloadindex.h"
+#include "folderscanner.h"
 #include "localtrack.h"
+#include "queuestore.h"
 #include "resources.h"
 #include "settings.h"
 #include "utils.h"
-#include <QDir>
-#include <algorithm>
+#include <QDataStream>
 #ifdef MUSIKLOUD_DEBUG
 #include <QDebug>
 #endif
 
 AudioPlayer* AudioPlayer::self = 0;
 
+// The number of upcoming queue entries whose stream URLs are resolved in advance
+static const int PREFETCH_COUNT = 2;
+
+// Resolved stream URLs are usually signed and expire, so they are only reused for a limited time
+static const int RESOLVED_STREAM_EXPIRY = 10 * 60; // Seconds
+
+// Changes to the queue state are saved together once they have stopped for this long
+static const int SAVE_STATE_INTERVAL = 2000;
+
+static const quint32 QUEUE_STATE_VERSION = 1;
+
 AudioPlayer::AudioPlayer(QObject *parent) :
     QObject(parent),
     m_player(new QMediaPlayer(this)),
     m_queue(new TrackModel(this)),
     m_soundcloudModel(0),
     m_pluginModel(0),
+    m_soundcloudPrefetchModel(0),
+    m_pluginPrefetchModel(0),
+    m_playingResolvedStream(false),
     m_index(0),
     m_shuffleIndex(0),
     m_repeat(false),
     m_shuffle(false),
     m_stopAfterCurrentTrack(false),
-    m_status(Stopped)
+    m_status(Stopped),
+    m_restorePosition(-1),
+    m_folderScanner(0),
+    m_scannedTrackCount(0),
+    m_playScannedTracks(false)
 {
     if (!self) {
         self = this;
     }
     
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(SAVE_STATE_INTERVAL);
+    
     connect(m_player, SIGNAL(bufferStatusChanged(int)), this, SLOT(onBufferStatusChanged(int)));
     connect(m_player, SIGNAL(durationChanged(qint64)), this, SLOT(onDurationChanged(qint64)));
     connect(m_player, SIGNAL(error(QMediaPlayer::Error)), this, SLOT(onError(QMediaPlayer::Error)));
@@ -54,9 +78,22 @@ AudioPlayer::AudioPlayer(QObject *parent) :
     connect(m_player, SIGNAL(seekableChanged(bool)), this, SLOT(onSeekableChanged()));
     connect(m_player, SIGNAL(stateChanged(QMediaPlayer::State)), this, SLOT(onStateChanged(QMediaPlayer::State)));
     connect(m_queue, SIGNAL(countChanged(int)), this, SIGNAL(queueCountChanged(int)));
+    connect(this, SIGNAL(currentIndexChanged(int)), this, SLOT(scheduleSaveState()));
+    connect(this, SIGNAL(repeatEnabledChanged(bool)), this, SLOT(scheduleSaveState()));
+    connect(this, SIGNAL(shuffleEnabledChanged(bool)), this, SLOT(scheduleSaveState()));
+    connect(&m_saveTimer, SIGNAL(timeout()), this, SLOT(saveState()));
 }
 
 AudioPlayer::~AudioPlayer() {
+    // Scanners that were cancelled may still be running
+    foreach (FolderScanner *scanner, findChildren<FolderScanner*>()) {
+        scanner->cancel();
+        scanner->wait();
+    }
+    
+    // Save the state on exit so that the position in the current track is restored
+    saveState();
+    
     if (self == this) {
         self = 0;
     }
@@ -79,14 +116,37 @@ void AudioPlayer::setCurrentIndex(int i) {
     qDebug() << "AudioPlayer::setCurrentIndex" << i;
 #endif
     if ((i >= 0) && (i < queueCount())) {
+        if (i != m_index) {
+            m_restorePosition = -1;
+        }
+        
         m_index = i;
         emit currentIndexChanged(i);
         
         if (MKTrack *track = currentTrack()) {
             stop();
+            const QString fileName = DownloadIndex::fileName(track->service(), track->id());
+            const QUrl transferUrl = AudioCache::instance() ? AudioCache::instance()->transferUrl(track->service(),
+                                                                                                track->id())
+                                                            : QUrl();
+            const ResolvedStream stream = resolvedStream(track->service(), track->id());
             
-            if (!track->streamUrl().isEmpty()) {
-                m_player->setMedia(track->streamUrl());
+            // Downloaded and downloading tracks are played from disk, even when they have a stream URL
+            if (!fileName.isEmpty()) {
+                m_player->setMedia(QUrl::fromLocalFile(fileName));
+                m_player->play();
+            }
+            else if (!transferUrl.isEmpty()) {
+                m_player->setMedia(transferUrl);
+                m_player->play();
+            }
+            else if (!track->streamUrl().isEmpty()) {
+                m_player->setMedia(mediaUrl(track->streamUrl(), QString()));
+                m_player->play();
+            }
+            else if (!stream.url.isEmpty()) {
+                m_playingResolvedStream = true;
+                m_player->setMedia(mediaUrl(stream.url, stream.format));
                 m_player->play();
             }
             else if (track->service() == Resources::SOUNDCLOUD) {
@@ -180,6 +240,14 @@ int AudioPlayer::queueCount() const {
     return m_queue->rowCount();
 }
 
+bool AudioPlayer::isScanningFolder() const {
+    return m_folderScanner != 0;
+}
+
+int AudioPlayer::scannedTrackCount() const {
+    return m_scannedTrackCount;
+}
+
 bool AudioPlayer::isSeekable() const {
     return (m_player->isSeekable()) && (m_player->duration() > 0);
 }
@@ -244,65 +312,83 @@ void AudioPlayer::setStatus(AudioPlayer::Status s) {
     }
 }
 
-bool AudioPlayer::addFolder(const QString &folder) {
-    QList<QUrl> urls;
-    QDir dir(folder);
-    
-    foreach (QString fileName, dir.entryList(SUPPORTED_AUDIO_FORMATS, QDir::Files)) {
-        urls << QUrl::fromLocalFile(dir.absoluteFilePath(fileName));
+void AudioPlayer::addFolder(const QString &folder, bool recursive) {
+    scanFolder(folder, recursive, false);
+}
+
+void AudioPlayer::cancelFolderScan() {
+    if (!m_folderScanner) {
+        return;
     }
-    
-    addUrls(urls);
-    return !urls.isEmpty();
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioPlayer::cancelFolderScan" << m_folderScanner->folder();
+#endif
+    // The scanner deletes itself when it has finished
+    m_folderScanner->cancel();
+    m_folderScanner = 0;
+    m_playScannedTracks = false;
+    emit scanningFolderChanged(false);
 }
 
 void AudioPlayer::addTrack(MKTrack *track) {
-    m_queue->append(new MKTrack(track, m_queue));
-    
-    if (shuffleEnabled()) {
-        shuffleTracks();
-    }
+    addTracks(QList<TrackRecord>() << track->record());
 }
 
 void AudioPlayer::addTracks(const QList<MKTrack*> &tracks) {
+    QList<TrackRecord> records;
+    
     foreach (MKTrack *track, tracks) {
-        m_queue->append(new MKTrack(track, m_queue));
+        records << track->record();
     }
     
+    addTracks(records);
+}
+
+void AudioPlayer::addTracks(const QList<TrackRecord> &tracks) {
+    storeTracks(tracks);
+    m_queue->append(tracks);
+    
     if (shuffleEnabled()) {
         shuffleTracks();
     }
 }
 
 void AudioPlayer::addTracks(const QVariantList &tracks) {
+    QList<TrackRecord> records;
+    
     foreach (QVariant v, tracks) {
         if (MKTrack *track = qobject_cast<MKTrack*>(v.value<QObject*>())) {
-            m_queue->append(new MKTrack(track, m_queue));
+            records << track->record();
         }
     }
     
-    if (shuffleEnabled()) {
-        shuffleTracks();
-    }
+    addTracks(records);
 }
 
 void AudioPlayer::removeTrack(int i) {
 #ifdef MUSIKLOUD_DEBUG
     qDebug() << "AudioPlayer::removeTrack" << i;
 #endif
+    if ((i < 0) || (i >= queueCount())) {
+        return;
+    }
+    
     const int current = currentIndex();
     m_queue->remove(i);
     
-    if (!m_shuffleOrder.isEmpty()) {
-        m_shuffleOrder.removeOne(i);
+    // The stored records are removed with the next save of the state, so that removing many tracks costs a
+    // single transaction
+    if (i < m_queueIds.size()) {
+        m_removedQueueIds << m_queueIds.takeAt(i);
+    }
     
-        if (m_shuffleOrder.indexOf(i) <= m_shuffleIndex) {
+    // Tracks added while shuffle was disabled are not yet in the shuffle order
+    if (i < m_shuffleOrder.count()) {
+        if (m_shuffleOrder.position(i) <= m_shuffleIndex) {
             m_shuffleIndex--;
         }
-    
-        for (int j = i; j < m_shuffleOrder.size(); j++) {
-            m_shuffleOrder[j]--;
-        }
+        
+        m_shuffleOrder.remove(i);
     }
     
     if (i <= current) {
@@ -310,7 +396,7 @@ void AudioPlayer::removeTrack(int i) {
         
         if (i == current) {
             if (shuffleEnabled()) {
-                if (m_shuffleIndex < (m_shuffleOrder.size() - 1)) {
+                if (m_shuffleIndex < (m_shuffleOrder.count() - 1)) {
                     next();
                 }
                 else {
@@ -328,39 +414,45 @@ void AudioPlayer::removeTrack(int i) {
             emit currentIndexChanged(m_index);
         }
     }
+    
+    scheduleSaveState();
 }
 
 void AudioPlayer::addUrl(const QUrl &url) {
-    m_queue->append(new LocalTrack(url, m_queue));
-    
-    if (shuffleEnabled()) {
-        shuffleTracks();
-    }
+    addTracks(QList<TrackRecord>() << LocalTrack::toRecord(url));
 }
 
 void AudioPlayer::addUrls(const QList<QUrl> &urls) {
+    QList<TrackRecord> records;
+    
     foreach (QUrl url, urls) {
-        m_queue->append(new LocalTrack(url, m_queue));
+        records << LocalTrack::toRecord(url);
     }
     
-    if (shuffleEnabled()) {
-        shuffleTracks();
-    }
+    addTracks(records);
 }
 
 void AudioPlayer::clearQueue() {
+    cancelFolderScan();
     stop();
     m_queue->clear();
     m_shuffleOrder.clear();
+    m_prefetchQueue.clear();
+    m_resolvedStreams.clear();
     m_index = 0;
     m_shuffleIndex = 0;
+    m_restorePosition = -1;
+    m_queueIds.clear();
+    m_removedQueueIds.clear();
+    QueueStore::clear();
+    scheduleSaveState();
 }
 
 void AudioPlayer::next() {
     if (shuffleEnabled()) {
-        if (m_shuffleIndex < (m_shuffleOrder.size() - 1)) {
+        if (m_shuffleIndex < (m_shuffleOrder.count() - 1)) {
             m_shuffleIndex++;
-            setCurrentIndex(m_shuffleOrder.at(m_shuffleIndex));
+            setCurrentIndex(m_shuffleOrder.indexAt(m_shuffleIndex));
         }
     }
     else {
@@ -384,20 +476,9 @@ void AudioPlayer::play() {
     }
 }
 
-bool AudioPlayer::playFolder(const QString &folder) {
-    QList<QUrl> urls;
-    QDir dir(folder);
-    
-    foreach (QString fileName, dir.entryList(SUPPORTED_AUDIO_FORMATS, QDir::Files)) {
-        urls << QUrl::fromLocalFile(dir.absoluteFilePath(fileName));
-    }
-    
-    if (urls.isEmpty()) {
-        return false;
-    }
-    
-    playUrls(urls);
-    return true;
+void AudioPlayer::playFolder(const QString &folder, bool recursive) {
+    clearQueue();
+    scanFolder(folder, recursive, true);
 }
 
 void AudioPlayer::playTrack(MKTrack *track) {
@@ -412,6 +493,12 @@ void AudioPlayer::playTracks(const QList<MKTrack*> &tracks) {
     play();
 }
 
+void AudioPlayer::playTracks(const QList<TrackRecord> &tracks) {
+    clearQueue();
+    addTracks(tracks);
+    play();
+}
+
 void AudioPlayer::playTracks(const QVariantList &tracks) {
     clearQueue();
     addTracks(tracks);
@@ -434,7 +521,7 @@ void AudioPlayer::previous() {
     if (shuffleEnabled()) {
         if (m_shuffleIndex > 0) {
             m_shuffleIndex--;
-            setCurrentIndex(m_shuffleOrder.at(m_shuffleIndex));
+            setCurrentIndex(m_shuffleOrder.indexAt(m_shuffleIndex));
         }
     }
     else {
@@ -445,6 +532,7 @@ void AudioPlayer::previous() {
 void AudioPlayer::stop() {
     m_player->stop();
     m_player->setMedia(QMediaContent());
+    m_playingResolvedStream = false;
     
     if (m_soundcloudModel) {
         m_soundcloudModel->cancel();
@@ -455,6 +543,91 @@ void AudioPlayer::stop() {
     }
 }
 
+void AudioPlayer::restoreQueue() {
+    if (queueCount() > 0) {
+        return;
+    }
+    
+    QList<QByteArray> records;
+    
+    if ((!QueueStore::load(m_queueIds, records)) || (records.isEmpty())) {
+        m_queueIds.clear();
+        return;
+    }
+    
+    // Tracks are only created from their records when they are first used
+    m_queue->appendRecords(records);
+    
+    QDataStream stream(QueueStore::state());
+    stream.setVersion(QDataStream::Qt_4_7);
+    quint32 version = 0;
+    qint32 index = 0;
+    qint32 shuffleIndex = 0;
+    bool repeat = false;
+    bool shuffle = false;
+    qint64 position = -1;
+    QVector<int> order;
+    stream >> version >> index >> shuffleIndex >> repeat >> shuffle >> position >> order;
+    
+    if ((version == QUEUE_STATE_VERSION) && (stream.status() == QDataStream::Ok)) {
+        m_index = qBound(0, int(index), queueCount() - 1);
+        m_restorePosition = position;
+        setRepeatEnabled(repeat);
+        
+        if (shuffle) {
+            m_shuffle = true;
+            
+            // If the saved order does not match the queue, the queue is shuffled again
+            const bool restored = (!order.isEmpty()) && (order.size() <= queueCount())
+                                  && (m_shuffleOrder.setOrder(order));
+            shuffleTracks();
+            m_shuffleIndex = restored ? qBound(0, int(shuffleIndex), m_shuffleOrder.count() - 1)
+                                      : qMax(0, m_shuffleOrder.position(m_index));
+            
+            emit shuffleEnabledChanged(true);
+        }
+        
+        emit currentIndexChanged(m_index);
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioPlayer::restoreQueue" << queueCount() << "tracks, current index" << m_index;
+#endif
+}
+
+void AudioPlayer::storeTracks(const QList<TrackRecord> &tracks) {
+    if (tracks.isEmpty()) {
+        return;
+    }
+    
+    const QList<qint64> ids = QueueStore::append(tracks);
+    
+    // If the tracks could not be stored, the stored queue no longer matches, so it is not restored
+    if ((ids.size() != tracks.size()) || (m_queueIds.size() != queueCount())) {
+        m_queueIds.clear();
+        m_removedQueueIds.clear();
+        QueueStore::clear();
+        return;
+    }
+    
+    m_queueIds << ids;
+}
+
+void AudioPlayer::scanFolder(const QString &folder, bool recursive, bool play) {
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioPlayer::scanFolder" << folder << recursive << play;
+#endif
+    cancelFolderScan();
+    m_folderScanner = new FolderScanner(folder, recursive, this);
+    m_playScannedTracks = play;
+    m_scannedTrackCount = 0;
+    connect(m_folderScanner, SIGNAL(filesFound(QStringList)), this, SLOT(onFolderScannerFilesFound(QStringList)));
+    connect(m_folderScanner, SIGNAL(finished()), this, SLOT(onFolderScannerFinished()));
+    connect(m_folderScanner, SIGNAL(finished()), m_folderScanner, SLOT(deleteLater()));
+    m_folderScanner->start(QThread::LowPriority);
+    emit scannedTrackCountChanged(0);
+    emit scanningFolderChanged(true);
+}
+
 void AudioPlayer::initPluginModel() {
     if (!m_pluginModel) {
         m_pluginModel = new PluginStreamModel(this);
@@ -471,22 +644,144 @@ void AudioPlayer::initSoundCloudModel() {
     }
 }
 
-void AudioPlayer::shuffleTracks() {
+void AudioPlayer::initPluginPrefetchModel() {
+    if (!m_pluginPrefetchModel) {
+        m_pluginPrefetchModel = new PluginStreamModel(this);
+        connect(m_pluginPrefetchModel, SIGNAL(statusChanged(ResourcesRequest::Status)),
+                this, SLOT(onPluginPrefetchModelStatusChanged(ResourcesRequest::Status)));
+    }
+}
+
+void AudioPlayer::initSoundCloudPrefetchModel() {
+    if (!m_soundcloudPrefetchModel) {
+        m_soundcloudPrefetchModel = new SoundCloudStreamModel(this);
+        connect(m_soundcloudPrefetchModel, SIGNAL(statusChanged(QSoundCloud::StreamsRequest::Status)),
+                this, SLOT(onSoundCloudPrefetchModelStatusChanged(QSoundCloud::StreamsRequest::Status)));
+    }
+}
+
+QString AudioPlayer::streamKey(const QString &service, const QString &id) {
+    return service + "/" + id;
+}
+
+AudioPlayer::ResolvedStream AudioPlayer::selectStream(const SelectionModel *model, const QString &service) {
+    ResolvedStream stream;
+    
+    if (model->rowCount() > 0) {
+        const int i = qMax(0, model->match("name", Settings::instance()->defaultPlaybackFormat(service)));
+        const QVariantMap value = model->data(i, "value").toMap();
+        stream.url = value.value("url").toString();
+        stream.format = value.contains("id") ? value.value("id").toString() : model->data(i, "name").toString();
+        stream.resolved = QDateTime::currentDateTime();
+    }
+    
+    return stream;
+}
+
+AudioPlayer::ResolvedStream AudioPlayer::resolvedStream(const QString &service, const QString &id) const {
+    const QString key = streamKey(service, id);
+    
+    if (m_resolvedStreams.contains(key)) {
+        const ResolvedStream stream = m_resolvedStreams.value(key);
+        
+        if (stream.resolved.secsTo(QDateTime::currentDateTime()) < RESOLVED_STREAM_EXPIRY) {
+            return stream;
+        }
+    }
+    
+    return ResolvedStream();
+}
+
+QUrl AudioPlayer::mediaUrl(const QUrl &url, const QString &format) const {
+    MKTrack *track = currentTrack();
+    
+    // Remote streams are played through the audio cache, so that they are only downloaded once
+    if ((track) && (AudioCache::instance())) {
+        return AudioCache::instance()->proxyUrl(url, track->service(), track->id(), format);
+    }
+    
+    return url;
+}
+
+void AudioPlayer::prefetchStreams() {
+    QList<int> indexes;
+    
+    if (shuffleEnabled()) {
+        for (int i = m_shuffleIndex + 1; (i < m_shuffleOrder.count()) && (indexes.size() < PREFETCH_COUNT); i++) {
+            indexes << m_shuffleOrder.indexAt(i);
+        }
+    }
+    else {
+        for (int i = currentIndex() + 1; (i < queueCount()) && (indexes.size() < PREFETCH_COUNT); i++) {
+            indexes << i;
+        }
+    }
+    
+    foreach (int i, indexes) {
+        // The record is used, so that no track objects are created for the tracks that will be played next
+        const TrackRecord track = m_queue->record(i);
+        
+        if ((!track.streamUrl().isEmpty()) || (!resolvedStream(track.service(), track.id()).url.isEmpty())
+            || (!DownloadIndex::fileName(track.service(), track.id()).isEmpty())) {
+            continue;
+        }
+        
+        const QPair<QString, QString> entry(track.service(), track.id());
+        
+        if ((streamKey(entry.first, entry.second) != m_prefetchKey) && (!m_prefetchQueue.contains(entry))) {
 #ifdef MUSIKLOUD_DEBUG
-    qDebug() << "AudioPlayer::shuffleTracks before:" << m_shuffleOrder;
+            qDebug() << "AudioPlayer::prefetchStreams" << entry.first << entry.second;
 #endif
-    const int oldSize = m_shuffleOrder.size();
+            m_prefetchQueue.enqueue(entry);
+        }
+    }
     
-    for (int i = oldSize; i < queueCount(); i++) {
-        m_shuffleOrder << i;
+    resolveNextStream();
+}
+
+void AudioPlayer::resolveNextStream() {
+    if ((!m_prefetchKey.isEmpty()) || (m_prefetchQueue.isEmpty())) {
+        return;
     }
     
-    if (m_shuffleOrder.size() > oldSize) {
-        std::random_shuffle(m_shuffleOrder.begin() + oldSize, m_shuffleOrder.end());
+    const QPair<QString, QString> entry = m_prefetchQueue.dequeue();
+    m_prefetchKey = streamKey(entry.first, entry.second);
+    
+    if (entry.first == Resources::SOUNDCLOUD) {
+        initSoundCloudPrefetchModel();
+        m_soundcloudPrefetchModel->get(entry.second);
+    }
+    else {
+        initPluginPrefetchModel();
+        m_pluginPrefetchModel->setService(entry.first);
+        m_pluginPrefetchModel->list(entry.second);
     }
+}
+
+void AudioPlayer::shuffleTracks() {
 #ifdef MUSIKLOUD_DEBUG
-    qDebug() << "AudioPlayer::shuffleTracks after:" << m_shuffleOrder;
+    qDebug() << "AudioPlayer::shuffleTracks" << queueCount() - m_shuffleOrder.count() << "new tracks";
 #endif
+    // New tracks are shuffled and played after the tracks already in the shuffle order
+    m_shuffleOrder.append(queueCount() - m_shuffleOrder.count());
+    scheduleSaveState();
+}
+
+void AudioPlayer::scheduleSaveState() {
+    m_saveTimer.start();
+}
+
+void AudioPlayer::saveState() {
+    m_saveTimer.stop();
+    QueueStore::remove(m_removedQueueIds);
+    m_removedQueueIds.clear();
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_4_7);
+    stream << QUEUE_STATE_VERSION << qint32(m_index) << qint32(m_shuffleIndex) << m_repeat << m_shuffle
+           << (m_restorePosition >= 0 ? m_restorePosition : position())
+           << (m_shuffle ? m_shuffleOrder.order() : QVector<int>());
+    QueueStore::setState(state);
 }
 
 void AudioPlayer::onBufferStatusChanged(int b) {
@@ -504,12 +799,57 @@ void AudioPlayer::onDurationChanged(qint64 d) {
 }
 
 void AudioPlayer::onError(QMediaPlayer::Error e) {
+    if ((e != QMediaPlayer::NoError) && (m_playingResolvedStream)) {
+        // The prefetched stream URL may have expired early, so resolve it again
+        if (MKTrack *track = currentTrack()) {
+            m_resolvedStreams.remove(streamKey(track->service(), track->id()));
+            setCurrentIndex(currentIndex());
+            return;
+        }
+    }
+    
     if (e != QMediaPlayer::NoError) {
         setErrorString(m_player->errorString());
         setStatus(Failed);
     }
 }
 
+void AudioPlayer::onFolderScannerFilesFound(const QStringList &fileNames) {
+    // Files may still be queued from a scanner that has been cancelled
+    if (sender() != m_folderScanner) {
+        return;
+    }
+    
+    QList<QUrl> urls;
+    
+    foreach (const QString &fileName, fileNames) {
+        urls << QUrl::fromLocalFile(fileName);
+    }
+    
+    addUrls(urls);
+    m_scannedTrackCount += urls.size();
+    emit scannedTrackCountChanged(m_scannedTrackCount);
+    
+    if (m_playScannedTracks) {
+        // Start playback with the first file, while the rest of the folder is scanned
+        m_playScannedTracks = false;
+        play();
+    }
+}
+
+void AudioPlayer::onFolderScannerFinished() {
+    if (sender() != m_folderScanner) {
+        return;
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "AudioPlayer::onFolderScannerFinished" << m_scannedTrackCount << "tracks";
+#endif
+    m_folderScanner = 0;
+    m_playScannedTracks = false;
+    emit scanningFolderChanged(false);
+    emit folderScanFinished(m_scannedTrackCount);
+}
+
 void AudioPlayer::onMediaStatusChanged(QMediaPlayer::MediaStatus m) {
     switch (m) {
     case QMediaPlayer::UnknownMediaStatus:
@@ -525,6 +865,8 @@ void AudioPlayer::onMediaStatusChanged(QMediaPlayer::MediaStatus m) {
         break;
     case QMediaPlayer::BufferedMedia:
         setStatus(Playing);
+        // Resolve the following tracks while this one plays, so that changing track does not wait for it
+        prefetchStreams();
         break;
     case QMediaPlayer::EndOfMedia:
         if (!stopAfterCurrentTrack()) {
@@ -551,9 +893,8 @@ void AudioPlayer::onPluginModelStatusChanged(ResourcesRequest::Status s) {
         setStatus(Loaded);
         
         if (m_pluginModel->rowCount() > 0) {
-            m_player->setMedia(QUrl(m_pluginModel->data(qMax(0, m_pluginModel->match("name",
-                               Settings::instance()->defaultPlaybackFormat(m_pluginModel->service()))), "value")
-                               .toMap().value("url").toString()));
+            const ResolvedStream stream = selectStream(m_pluginModel, m_pluginModel->service());
+            m_player->setMedia(mediaUrl(stream.url, stream.format));
            
            if (!isPaused()) {
                 m_player->play();
@@ -575,7 +916,34 @@ void AudioPlayer::onPluginModelStatusChanged(ResourcesRequest::Status s) {
     }
 }
 
+void AudioPlayer::onPluginPrefetchModelStatusChanged(ResourcesRequest::Status s) {
+    switch (s) {
+    case ResourcesRequest::Ready:
+    case ResourcesRequest::Failed: {
+        const ResolvedStream stream = s == ResourcesRequest::Ready
+                                      ? selectStream(m_pluginPrefetchModel, m_pluginPrefetchModel->service())
+                                      : ResolvedStream();
+        
+        if (!stream.url.isEmpty()) {
+            m_resolvedStreams[m_prefetchKey] = stream;
+        }
+        
+        m_prefetchKey.clear();
+        resolveNextStream();
+        break;
+    }
+    default:
+        break;
+    }
+}
+
 void AudioPlayer::onSeekableChanged() {
+    if ((m_restorePosition > 0) && (isSeekable())) {
+        // Resume the restored track from where it was when the queue was saved
+        m_player->setPosition(m_restorePosition);
+        m_restorePosition = -1;
+    }
+    
     emit seekableChanged(isSeekable());
 }
 
@@ -588,9 +956,8 @@ void AudioPlayer::onSoundCloudModelStatusChanged(QSoundCloud::StreamsRequest::St
         setStatus(Loaded);
         
         if (m_soundcloudModel->rowCount() > 0) {
-            m_player->setMedia(QUrl(m_soundcloudModel->data(qMax(0, m_soundcloudModel->match("name",
-                               Settings::instance()->defaultPlaybackFormat(Resources::SOUNDCLOUD))), "value")
-                               .toMap().value("url").toString()));
+            const ResolvedStream stream = selectStream(m_soundcloudModel, Resources::SOUNDCLOUD);
+            m_player->setMedia(mediaUrl(stream.url, stream.format));
             
             if (!isPaused()) {
                 m_player->play();
@@ -612,6 +979,27 @@ void AudioPlayer::onSoundCloudModelStatusChanged(QSoundCloud::StreamsRequest::St
     }
 }
 
+void AudioPlayer::onSoundCloudPrefetchModelStatusChanged(QSoundCloud::StreamsRequest::Status s) {
+    switch (s) {
+    case QSoundCloud::StreamsRequest::Ready:
+    case QSoundCloud::StreamsRequest::Failed: {
+        const ResolvedStream stream = s == QSoundCloud::StreamsRequest::Ready
+                                      ? selectStream(m_soundcloudPrefetchModel, Resources::SOUNDCLOUD)
+                                      : ResolvedStream();
+        
+        if (!stream.url.isEmpty()) {
+            m_resolvedStreams[m_prefetchKey] = stream;
+        }
+        
+        m_prefetchKey.clear();
+        resolveNextStream();
+        break;
+    }
+    default:
+        break;
+    }
+}
+
 void AudioPlayer::onStateChanged(QMediaPlayer::State s) {
     switch (s) {
     case QMediaPlayer::StoppedState:
@@ -622,6 +1010,7 @@ void AudioPlayer::onStateChanged(QMediaPlayer::State s) {
         break;
     case QMediaPlayer::PausedState:
         setStatus(Paused);
+        scheduleSaveState();
         break;
     default:
         break;
@@ -18,9 +18,15 @@
 #define AUDIOPLAYER_H
 
 #include "pluginstreammodel.h"
+#include "shuffleorder.h"
 #include "soundcloudstreammodel.h"
 #include "trackmodel.h"
+#include <QDateTime>
 #include <QMediaPlayer>
+#include <QQueue>
+#include <QTimer>
+
+class FolderScanner;
 
 class AudioPlayer : public QObject
 {
@@ -40,6 +46,8 @@ class AudioPlayer : public QObject
     Q_PROPERTY(TrackModel* queue READ queue CONSTANT)
     Q_PROPERTY(int queueCount READ queueCount NOTIFY queueCountChanged)
     Q_PROPERTY(bool repeat READ repeatEnabled WRITE setRepeatEnabled NOTIFY repeatEnabledChanged)
+    Q_PROPERTY(bool scanningFolder READ isScanningFolder NOTIFY scanningFolderChanged)
+    Q_PROPERTY(int scannedTrackCount READ scannedTrackCount NOTIFY scannedTrackCountChanged)
     Q_PROPERTY(bool seekable READ isSeekable NOTIFY seekableChanged)
     Q_PROPERTY(bool shuffle READ shuffleEnabled WRITE setShuffleEnabled NOTIFY shuffleEnabledChanged)
     Q_PROPERTY(bool stopAfterCurrentTrack READ stopAfterCurrentTrack WRITE setStopAfterCurrentTrack
@@ -89,6 +97,9 @@ public:
     
     bool repeatEnabled() const;
     
+    bool isScanningFolder() const;
+    int scannedTrackCount() const;
+    
     bool isSeekable() const;
     
     bool shuffleEnabled() const;
@@ -111,10 +122,12 @@ public Q_SLOTS:
     
     void setStopAfterCurrentTrack(bool s);
     
-    bool addFolder(const QString &folder);
+    void addFolder(const QString &folder, bool recursive = false);
+    void cancelFolderScan();
         
     void addTrack(MKTrack *track);
     void addTracks(const QList<MKTrack*> &tracks);
+    void addTracks(const QList<TrackRecord> &tracks);
     void addTracks(const QVariantList &tracks); // For QML
     void removeTrack(int i);    
     
@@ -126,15 +139,18 @@ public Q_SLOTS:
     void next();
     void pause();
     void play();
-    bool playFolder(const QString &folder);
+    void playFolder(const QString &folder, bool recursive = false);
     void playTrack(MKTrack *track);
     void playTracks(const QList<MKTrack*> &tracks);
+    void playTracks(const QList<TrackRecord> &tracks);
     void playTracks(const QVariantList &tracks); // For QML
     void playUrl(const QUrl &url);
     void playUrls(const QList<QUrl> &urls);
     void previous();
     void stop();
     
+    void restoreQueue();
+    
 private:
     void setErrorString(const QString &e);
     
@@ -142,17 +158,47 @@ private:
     
     void initPluginModel();
     void initSoundCloudModel();
+    
+    void initPluginPrefetchModel();
+    void initSoundCloudPrefetchModel();
+    
+    struct ResolvedStream {
+        QUrl url;
+        QString format;
+        QDateTime resolved;
+    };
+    
+    static QString streamKey(const QString &service, const QString &id);
+    static ResolvedStream selectStream(const SelectionModel *model, const QString &service);
+    
+    ResolvedStream resolvedStream(const QString &service, const QString &id) const;
+    
+    QUrl mediaUrl(const QUrl &url, const QString &format) const;
+    
+    void prefetchStreams();
+    void resolveNextStream();
+    
+    void storeTracks(const QList<TrackRecord> &tracks);
+    
+    void scanFolder(const QString &folder, bool recursive, bool play);
 
 private Q_SLOTS:
     void shuffleTracks();
     
+    void scheduleSaveState();
+    void saveState();
+    
     void onBufferStatusChanged(int b);
     void onDurationChanged(qint64 d);
     void onError(QMediaPlayer::Error e);
+    void onFolderScannerFilesFound(const QStringList &fileNames);
+    void onFolderScannerFinished();
     void onMediaStatusChanged(QMediaPlayer::MediaStatus m);
     void onPluginModelStatusChanged(ResourcesRequest::Status s);
+    void onPluginPrefetchModelStatusChanged(ResourcesRequest::Status s);
     void onSeekableChanged();
     void onSoundCloudModelStatusChanged(QSoundCloud::StreamsRequest::Status s);
+    void onSoundCloudPrefetchModelStatusChanged(QSoundCloud::StreamsRequest::Status s);
     void onStateChanged(QMediaPlayer::State s);
 
 Q_SIGNALS:
@@ -168,6 +214,10 @@ Q_SIGNALS:
     
     void repeatEnabledChanged(bool r);
     
+    void scanningFolderChanged(bool s);
+    void scannedTrackCountChanged(int c);
+    void folderScanFinished(int count);
+    
     void seekableChanged(bool s);
     
     void shuffleEnabledChanged(bool s);
@@ -185,6 +235,14 @@ private:
     SoundCloudStreamModel *m_soundcloudModel;
     PluginStreamModel *m_pluginModel;
     
+    SoundCloudStreamModel *m_soundcloudPrefetchModel;
+    PluginStreamModel *m_pluginPrefetchModel;
+    
+    QHash<QString, ResolvedStream> m_resolvedStreams;
+    QQueue<QPair<QString, QString> > m_prefetchQueue;
+    QString m_prefetchKey;
+    bool m_playingResolvedStream;
+    
     int m_index;
     int m_shuffleIndex;
         
@@ -193,11 +251,20 @@ private:
     bool m_repeat;
     
     bool m_shuffle;
-    QList<int> m_shuffleOrder;
+    ShuffleOrder m_shuffleOrder;
     
     bool m_stopAfterCurrentTrack;
     
     Status m_status;
+    
+    QList<qint64> m_queueIds;
+    QList<qint64> m_removedQueueIds;
+    qint64 m_restorePosition;
+    QTimer m_saveTimer;
+    
+    FolderScanner *m_folderScanner;
+    int m_scannedTrackCount;
+    bool m_playScannedTracks;
 };
     
 #endif // AUDIOPLAYER_H
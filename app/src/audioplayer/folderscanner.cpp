@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "folderscanner.h"
+#include "definitions.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QStack>
+#ifdef MUSIKLOUD_DEBUG
+#include <QDebug>
+#endif
+
+// Found files are reported when this many have accumulated, or when the interval has elapsed,
+// whichever is sooner
+static const int BATCH_SIZE = 500;
+static const int BATCH_INTERVAL = 250;
+
+FolderScanner::FolderScanner(const QString &folder, bool recursive, QObject *parent) :
+    QThread(parent),
+    m_folder(folder),
+    m_recursive(recursive),
+    m_cancelled(0)
+{
+}
+
+QString FolderScanner::folder() const {
+    return m_folder;
+}
+
+bool FolderScanner::isRecursive() const {
+    return m_recursive;
+}
+
+void FolderScanner::cancel() {
+    m_cancelled.fetchAndStoreRelaxed(1);
+}
+
+bool FolderScanner::isCancelled() const {
+#if QT_VERSION >= 0x050000
+    return m_cancelled.load() != 0;
+#else
+    return m_cancelled != 0;
+#endif
+}
+
+void FolderScanner::run() {
+    QStack<QString> folders;
+    folders.push(m_folder);
+    QStringList batch;
+    QElapsedTimer timer;
+    timer.start();
+    bool found = false;
+    
+    while ((!folders.isEmpty()) && (!isCancelled())) {
+        QDir dir(folders.pop());
+        
+        foreach (const QString &fileName, dir.entryList(SUPPORTED_AUDIO_FORMATS, QDir::Files, QDir::Name)) {
+            batch << dir.absoluteFilePath(fileName);
+            
+            if ((!found) || (batch.size() >= BATCH_SIZE) || (timer.elapsed() >= BATCH_INTERVAL)) {
+                found = true;
+                emit filesFound(batch);
+                batch.clear();
+                timer.restart();
+                
+                if (isCancelled()) {
+                    return;
+                }
+            }
+        }
+        
+        if ((!batch.isEmpty()) && (timer.elapsed() >= BATCH_INTERVAL)) {
+            emit filesFound(batch);
+            batch.clear();
+            timer.restart();
+        }
+        
+        if (m_recursive) {
+            // Subdirectories are pushed in reverse, so that they are scanned in name order.
+            // Symbolic links are not followed, so that a link to a parent directory can not cause a loop.
+            const QStringList subfolders = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks,
+                                                         QDir::Name);
+            
+            for (int i = subfolders.size() - 1; i >= 0; i--) {
+                folders.push(dir.absoluteFilePath(subfolders.at(i)));
+            }
+        }
+    }
+    
+    if ((!batch.isEmpty()) && (!isCancelled())) {
+        emit filesFound(batch);
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "FolderScanner::run: Finished scanning" << m_folder << "cancelled:" << isCancelled();
+#endif
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FOLDERSCANNER_H
+#define FOLDERSCANNER_H
+
+#include <QThread>
+#include <QStringList>
+
+/*
+ * Walks a directory tree on a worker thread and reports the supported audio files that it finds in batches.
+ * Files in each directory are reported in name order, before the files in its subdirectories. The first file
+ * is reported on its own, so that playback can begin while the rest of the tree is scanned.
+ */
+class FolderScanner : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit FolderScanner(const QString &folder, bool recursive, QObject *parent = 0);
+    
+    QString folder() const;
+    
+    bool isRecursive() const;
+    
+    void cancel();
+    bool isCancelled() const;
+
+Q_SIGNALS:
+    void filesFound(const QStringList &fileNames);
+    
+protected:
+    void run();
+    
+private:
+    QString m_folder;
+    
+    bool m_recursive;
+    
+    QAtomicInt m_cancelled;
+};
+
+#endif // FOLDERSCANNER_H
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "queuestore.h"
+#include "database.h"
+#include "localtrack.h"
+#include <QDataStream>
+
+static const quint32 RECORD_VERSION = 1;
+
+// Local tracks only store their URL, and their metadata is read again when the track is restored
+enum RecordType {
+    TrackType = 0,
+    LocalTrackType
+};
+
+QList<qint64> QueueStore::append(const QList<TrackRecord> &tracks) {
+    QList<qint64> ids;
+    QSqlDatabase db = getDatabase();
+    db.transaction();
+    QSqlQuery query(db);
+    query.prepare("INSERT INTO queue (data) VALUES (?)");
+    
+    foreach (const TrackRecord &track, tracks) {
+        query.addBindValue(encode(track));
+        
+        if (!query.exec()) {
+            qDebug() << "QueueStore::append: database error:" << query.lastError().text();
+            db.rollback();
+            return QList<qint64>();
+        }
+        
+        ids << query.lastInsertId().toLongLong();
+    }
+    
+    db.commit();
+    return ids;
+}
+
+void QueueStore::remove(const QList<qint64> &ids) {
+    if (ids.isEmpty()) {
+        return;
+    }
+    
+    QSqlDatabase db = getDatabase();
+    db.transaction();
+    QSqlQuery query(db);
+    query.prepare("DELETE FROM queue WHERE id = ?");
+    
+    foreach (qint64 id, ids) {
+        query.addBindValue(id);
+        
+        if (!query.exec()) {
+            qDebug() << "QueueStore::remove: database error:" << query.lastError().text();
+            db.rollback();
+            return;
+        }
+    }
+    
+    db.commit();
+}
+
+void QueueStore::clear() {
+    QSqlQuery query(getDatabase());
+    
+    if (!query.exec("DELETE FROM queue")) {
+        qDebug() << "QueueStore::clear: database error:" << query.lastError().text();
+    }
+}
+
+bool QueueStore::load(QList<qint64> &ids, QList<QByteArray> &records) {
+    QSqlQuery query(getDatabase());
+    query.setForwardOnly(true);
+    
+    if (!query.exec("SELECT id, data FROM queue ORDER BY id")) {
+        qDebug() << "QueueStore::load: database error:" << query.lastError().text();
+        return false;
+    }
+    
+    while (query.next()) {
+        ids << query.value(0).toLongLong();
+        records << query.value(1).toByteArray();
+    }
+    
+    return true;
+}
+
+QByteArray QueueStore::state() {
+    QSqlQuery query(getDatabase());
+    
+    if ((query.exec("SELECT data FROM queueState WHERE id = 0")) && (query.next())) {
+        return query.value(0).toByteArray();
+    }
+    
+    return QByteArray();
+}
+
+void QueueStore::setState(const QByteArray &state) {
+    QSqlQuery query(getDatabase());
+    query.prepare("INSERT OR REPLACE INTO queueState VALUES (0, ?)");
+    query.addBindValue(state);
+    
+    if (!query.exec()) {
+        qDebug() << "QueueStore::setState: database error:" << query.lastError().text();
+    }
+}
+
+QByteArray QueueStore::encode(const TrackRecord &track) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_4_7);
+    stream << RECORD_VERSION;
+    
+    if (track.isLocal()) {
+        stream << quint8(LocalTrackType) << track.url();
+    }
+    else {
+        stream << quint8(TrackType) << track;
+    }
+    
+    return data;
+}
+
+// Returns a default record if the data cannot be decoded
+TrackRecord QueueStore::decode(const QByteArray &data) {
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_4_7);
+    quint32 version;
+    quint8 type;
+    stream >> version >> type;
+    
+    if ((version != RECORD_VERSION) || (stream.status() != QDataStream::Ok)) {
+        return TrackRecord();
+    }
+    
+    if (type == LocalTrackType) {
+        QUrl url;
+        stream >> url;
+        return LocalTrack::toRecord(url);
+    }
+    
+    TrackRecord track;
+    stream >> track;
+    return track;
+}
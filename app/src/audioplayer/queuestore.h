@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUEUESTORE_H
+#define QUEUESTORE_H
+
+#include "trackrecord.h"
+#include <QByteArray>
+#include <QList>
+
+/*
+ * Persists the playback queue in the database, one compact record per track, so that it can be restored
+ * without repeating the requests that built it. Records are written as tracks are added, and removed in batches.
+ * Must only be used from the GUI thread.
+ */
+class QueueStore
+{
+
+public:
+    static QList<qint64> append(const QList<TrackRecord> &tracks);
+    static void remove(const QList<qint64> &ids);
+    static void clear();
+    
+    static bool load(QList<qint64> &ids, QList<QByteArray> &records);
+    
+    static QByteArray state();
+    static void setState(const QByteArray &state);
+    
+    static QByteArray encode(const TrackRecord &track);
+    static TrackRecord decode(const QByteArray &data);
+};
+
+#endif // QUEUESTORE_H
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shuffleorder.h"
+#include <algorithm>
+
+// Removed slots are discarded once there are at least this many and they outnumber the remaining entries
+static const int MIN_COMPACT_COUNT = 1024;
+
+int ShuffleOrder::FenwickTree::size() const {
+    return m_tree.size();
+}
+
+void ShuffleOrder::FenwickTree::append(int value) {
+    // Node i (1-based) holds the sum of the values in (i - lowbit(i), i]
+    const int i = m_tree.size() + 1;
+    m_tree.append(value + prefix(i - 1) - prefix(i - (i & -i)));
+}
+
+void ShuffleOrder::FenwickTree::add(int slot, int delta) {
+    for (int i = slot + 1; i <= m_tree.size(); i += i & -i) {
+        m_tree[i - 1] += delta;
+    }
+}
+
+int ShuffleOrder::FenwickTree::prefix(int slot) const {
+    int sum = 0;
+    
+    for (int i = slot; i > 0; i -= i & -i) {
+        sum += m_tree.at(i - 1);
+    }
+    
+    return sum;
+}
+
+int ShuffleOrder::FenwickTree::find(int rank) const {
+    int slot = 0;
+    int step = 1;
+    
+    while (step * 2 <= m_tree.size()) {
+        step *= 2;
+    }
+    
+    for (; step > 0; step /= 2) {
+        if ((slot + step <= m_tree.size()) && (m_tree.at(slot + step - 1) <= rank)) {
+            slot += step;
+            rank -= m_tree.at(slot - 1);
+        }
+    }
+    
+    return slot;
+}
+
+void ShuffleOrder::FenwickTree::clear() {
+    m_tree.clear();
+}
+
+ShuffleOrder::ShuffleOrder() :
+    m_removed(0)
+{
+}
+
+int ShuffleOrder::count() const {
+    return m_queue.size() - m_removed;
+}
+
+bool ShuffleOrder::isEmpty() const {
+    return count() == 0;
+}
+
+void ShuffleOrder::append(int n) {
+    if (n <= 0) {
+        return;
+    }
+    
+    QVector<int> slots(n);
+    
+    for (int i = 0; i < n; i++) {
+        slots[i] = m_queue.size();
+        m_queue.append(1);
+    }
+    
+    // New entries are shuffled among themselves and played after the existing ones
+    std::random_shuffle(slots.begin(), slots.end());
+    m_shuffleSlots.resize(m_queue.size());
+    
+    foreach (int slot, slots) {
+        m_shuffleSlots[slot] = m_shuffle.size();
+        m_queueSlots.append(slot);
+        m_shuffle.append(1);
+    }
+}
+
+void ShuffleOrder::remove(int index) {
+    if ((index < 0) || (index >= count())) {
+        return;
+    }
+    
+    const int slot = m_queue.find(index);
+    m_queue.add(slot, -1);
+    m_shuffle.add(m_shuffleSlots.at(slot), -1);
+    m_removed++;
+    
+    if ((m_removed >= MIN_COMPACT_COUNT) && (m_removed > count())) {
+        compact();
+    }
+}
+
+int ShuffleOrder::indexAt(int position) const {
+    if ((position < 0) || (position >= count())) {
+        return -1;
+    }
+    
+    return m_queue.prefix(m_queueSlots.at(m_shuffle.find(position)));
+}
+
+int ShuffleOrder::position(int index) const {
+    if ((index < 0) || (index >= count())) {
+        return -1;
+    }
+    
+    return m_shuffle.prefix(m_shuffleSlots.at(m_queue.find(index)));
+}
+
+QVector<int> ShuffleOrder::order() const {
+    QVector<int> indexes(count());
+    
+    for (int i = 0; i < indexes.size(); i++) {
+        indexes[i] = indexAt(i);
+    }
+    
+    return indexes;
+}
+
+bool ShuffleOrder::setOrder(const QVector<int> &order) {
+    clear();
+    m_shuffleSlots.fill(-1, order.size());
+    
+    for (int i = 0; i < order.size(); i++) {
+        const int index = order.at(i);
+        
+        // The order must contain each queue index exactly once
+        if ((index < 0) || (index >= order.size()) || (m_shuffleSlots.at(index) >= 0)) {
+            clear();
+            return false;
+        }
+        
+        m_shuffleSlots[index] = i;
+        m_queueSlots.append(index);
+        m_queue.append(1);
+        m_shuffle.append(1);
+    }
+    
+    return true;
+}
+
+void ShuffleOrder::clear() {
+    m_queue.clear();
+    m_shuffle.clear();
+    m_shuffleSlots.clear();
+    m_queueSlots.clear();
+    m_removed = 0;
+}
+
+void ShuffleOrder::compact() {
+    // Renumber the remaining entries in both sequences, keeping their order
+    QVector<int> indexes(m_queue.size(), -1);
+    int index = 0;
+    
+    for (int slot = 0; slot < m_queue.size(); slot++) {
+        if (m_queue.prefix(slot + 1) > index) {
+            indexes[slot] = index++;
+        }
+    }
+    
+    QVector<int> queueSlots;
+    queueSlots.reserve(index);
+    
+    foreach (int slot, m_queueSlots) {
+        if (indexes.at(slot) >= 0) {
+            queueSlots.append(indexes.at(slot));
+        }
+    }
+    
+    clear();
+    m_shuffleSlots.resize(queueSlots.size());
+    
+    for (int i = 0; i < queueSlots.size(); i++) {
+        m_queue.append(1);
+        m_shuffle.append(1);
+        m_shuffleSlots[queueSlots.at(i)] = i;
+    }
+    
+    m_queueSlots = queueSlots;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHUFFLEORDER_H
+#define SHUFFLEORDER_H
+
+#include <QVector>
+
+/*
+ * The order in which queue entries are played when shuffle is enabled.
+ *
+ * Entries are only ever appended to the queue and to the shuffle order, so each entry keeps the slot it was
+ * given, and removed entries are marked rather than erased. A Fenwick tree over each sequence of slots counts
+ * the remaining entries, so that mapping between queue indexes and shuffle positions, and removing an entry,
+ * are O(log n) and never renumber the entries that follow.
+ */
+class ShuffleOrder
+{
+
+public:
+    ShuffleOrder();
+    
+    int count() const;
+    bool isEmpty() const;
+    
+    void append(int n);
+    void remove(int index);
+    
+    int indexAt(int position) const;
+    int position(int index) const;
+    
+    QVector<int> order() const;
+    bool setOrder(const QVector<int> &order);
+    
+    void clear();
+    
+private:
+    class FenwickTree
+    {
+    
+    public:
+        int size() const;
+        
+        void append(int value);
+        void add(int slot, int delta);
+        
+        int prefix(int slot) const;
+        int find(int rank) const;
+        
+        void clear();
+        
+    private:
+        QVector<int> m_tree;
+    };
+    
+    void compact();
+    
+    FenwickTree m_queue;
+    FenwickTree m_shuffle;
+    
+    QVector<int> m_shuffleSlots;
+    QVector<int> m_queueSlots;
+    
+    int m_removed;
+};
+
+#endif // SHUFFLEORDER_H
@@ -15,63 +15,122 @@
  */
 
 #include "trackmodel.h"
+#include "localtrack.h"
+#include "queuestore.h"
+#include "roletable.h"
 #ifdef MUSIKLOUD_DEBUG
 #include <QDebug>
 #endif
 
+static const char* const ROLE_NAMES[] = {
+    "artist",
+    "artistId",
+    "date",
+    "description",
+    "duration",
+    "durationString",
+    "format",
+    "genre",
+    "id",
+    "largeThumbnailUrl",
+    "playCount",
+    "service",
+    "size",
+    "sizeString",
+    "streamUrl",
+    "thumbnailUrl",
+    "title",
+    "url",
+    0
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(RoleTable, roleTable, (TrackModel::ArtistRole, ROLE_NAMES))
+
+// Used for both the track objects and the records of the queue, which have the same getters
+template<class T>
+static QVariant trackData(const T &track, int role) {
+    switch (role) {
+    case TrackModel::ArtistRole:
+        return track.artist();
+    case TrackModel::ArtistIdRole:
+        return track.artistId();
+    case TrackModel::DateRole:
+        return track.date();
+    case TrackModel::DescriptionRole:
+        return track.description();
+    case TrackModel::DurationRole:
+        return track.duration();
+    case TrackModel::DurationStringRole:
+        return track.durationString();
+    case TrackModel::FormatRole:
+        return track.format();
+    case TrackModel::GenreRole:
+        return track.genre();
+    case TrackModel::IdRole:
+        return track.id();
+    case TrackModel::LargeThumbnailUrlRole:
+        return track.largeThumbnailUrl();
+    case TrackModel::PlayCountRole:
+        return track.playCount();
+    case TrackModel::ServiceRole:
+        return track.service();
+    case TrackModel::SizeRole:
+        return track.size();
+    case TrackModel::SizeStringRole:
+        return track.sizeString();
+    case TrackModel::StreamUrlRole:
+        return track.streamUrl();
+    case TrackModel::ThumbnailUrlRole:
+        return track.thumbnailUrl();
+    case TrackModel::TitleRole:
+        return track.title();
+    case TrackModel::UrlRole:
+        return track.url();
+    default:
+        return QVariant();
+    }
+}
+
 TrackModel::TrackModel(QObject *parent) :
     QAbstractListModel(parent)
 {
-    m_roles[ArtistRole] = "artist";
-    m_roles[ArtistIdRole] = "artistId";
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[DurationRole] = "duration";
-    m_roles[DurationStringRole] = "durationString";
-    m_roles[FormatRole] = "format";
-    m_roles[GenreRole] = "genre";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[PlayCountRole] = "playCount";
-    m_roles[ServiceRole] = "service";
-    m_roles[SizeRole] = "size";
-    m_roles[SizeStringRole] = "sizeString";
-    m_roles[StreamUrlRole] = "streamUrl";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UrlRole] = "url";
 #if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
+    setRoleNames(roleTable()->roleNames());
 #endif
 }
 
 #if QT_VERSION >=0x050000
 QHash<int, QByteArray> TrackModel::roleNames() const {
-    return m_roles;
+    return roleTable()->roleNames();
 }
 #endif
 
 int TrackModel::rowCount(const QModelIndex &) const {
-    return m_items.size();
+    return m_records.size();
 }
 
 QVariant TrackModel::data(const QModelIndex &index, int role) const {
-    if (MKTrack *track = get(index.row())) {
-        return track->property(m_roles[role]);
+    const int row = index.row();
+    
+    if ((row < 0) || (row >= rowCount())) {
+        return QVariant();
     }
     
-    return QVariant();
+    // Painting a row does not create a track object, so the tags of a local track are only read once its object
+    // is requested with get(), as it is for the current track
+    if (const MKTrack *track = m_items.at(row)) {
+        return trackData(*track, role);
+    }
+    
+    return trackData(record(row), role);
 }
 
 QMap<int, QVariant> TrackModel::itemData(const QModelIndex &index) const {
     QMap<int, QVariant> map;
     
-    if (MKTrack *track = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = track->property(iterator.value());
+    if ((index.row() >= 0) && (index.row() < rowCount())) {
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[role] = data(index, role);
         }
     }
     
@@ -79,19 +138,17 @@ QMap<int, QVariant> TrackModel::itemData(const QModelIndex &index) const {
 }
 
 QVariant TrackModel::data(int row, const QByteArray &role) const {
-    if (MKTrack *track = get(row)) {
-        return track->property(role);
-    }
-    
-    return QVariant();
+    return data(index(row), roleTable()->role(role));
 }
 
 QVariantMap TrackModel::itemData(int row) const {
     QVariantMap map;
     
-    if (MKTrack *track = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = track->property(role);
+    if ((row >= 0) && (row < rowCount())) {
+        const QModelIndex idx = index(row);
+        
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[roleTable()->name(role)] = data(idx, role);
         }
     }
     
@@ -99,36 +156,111 @@ QVariantMap TrackModel::itemData(int row) const {
 }
 
 MKTrack* TrackModel::get(int row) const {
-    if ((row >= 0) && (row < m_items.size())) {
-        return m_items.at(row);
+    if ((row < 0) || (row >= rowCount())) {
+        return 0;
+    }
+    
+    if (!m_items.at(row)) {
+        const TrackRecord track = record(row);
+        TrackModel *model = const_cast<TrackModel*>(this);
+        
+        if (track.isLocal()) {
+            MKTrack *item = new LocalTrack(track, model);
+            m_items[row] = item;
+            // Update the row when the tags have been read
+            connect(item, SIGNAL(artistChanged()), model, SLOT(onTrackChanged()));
+            connect(item, SIGNAL(dateChanged()), model, SLOT(onTrackChanged()));
+            connect(item, SIGNAL(durationChanged()), model, SLOT(onTrackChanged()));
+            connect(item, SIGNAL(genreChanged()), model, SLOT(onTrackChanged()));
+            connect(item, SIGNAL(sizeChanged()), model, SLOT(onTrackChanged()));
+            connect(item, SIGNAL(titleChanged()), model, SLOT(onTrackChanged()));
+        }
+        else {
+            m_items[row] = new MKTrack(track, model);
+        }
+    }
+    
+    return m_items.at(row);
+}
+
+TrackRecord TrackModel::record(int row) const {
+    if ((row < 0) || (row >= rowCount())) {
+        return TrackRecord();
+    }
+    
+    if (!m_encodedRecords.at(row).isEmpty()) {
+        m_records[row] = QueueStore::decode(m_encodedRecords.at(row));
+        m_encodedRecords[row].clear();
     }
     
-    return 0;
+    return m_records.at(row);
 }
 
 void TrackModel::clear() {
-    if (!m_items.isEmpty()) {
+    if (!m_records.isEmpty()) {
         beginResetModel();
         qDeleteAll(m_items);
         m_items.clear();
+        m_records.clear();
+        m_encodedRecords.clear();
         endResetModel();
         emit countChanged(rowCount());
     }
 }
 
-void TrackModel::append(MKTrack *track) {
-    beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
-    track->setParent(this);
-    m_items << track;
+void TrackModel::onTrackChanged() {
+    const int row = m_items.indexOf(qobject_cast<MKTrack*>(sender()));
+    
+    if (row >= 0) {
+        const QModelIndex idx = index(row);
+        emit dataChanged(idx, idx);
+    }
+}
+
+void TrackModel::append(const TrackRecord &track) {
+    append(QList<TrackRecord>() << track);
+}
+
+void TrackModel::append(const QList<TrackRecord> &tracks) {
+    if (tracks.isEmpty()) {
+        return;
+    }
+    
+    beginInsertRows(QModelIndex(), rowCount(), rowCount() + tracks.size() - 1);
+    m_records << tracks;
+    
+    for (int i = 0; i < tracks.size(); i++) {
+        m_encodedRecords << QByteArray();
+        m_items << 0;
+    }
+    
     endInsertRows();
     emit countChanged(rowCount());
 }
 
-void TrackModel::insert(int row, MKTrack *track) {
-    if ((row >= 0) && (row < m_items.size())) {
+void TrackModel::appendRecords(const QList<QByteArray> &records) {
+    if (records.isEmpty()) {
+        return;
+    }
+    
+    beginInsertRows(QModelIndex(), rowCount(), rowCount() + records.size() - 1);
+    m_encodedRecords << records;
+    
+    for (int i = 0; i < records.size(); i++) {
+        m_records << TrackRecord();
+        m_items << 0;
+    }
+    
+    endInsertRows();
+    emit countChanged(rowCount());
+}
+
+void TrackModel::insert(int row, const TrackRecord &track) {
+    if ((row >= 0) && (row < rowCount())) {
         beginInsertRows(QModelIndex(), row, row);
-        track->setParent(this);
-        m_items.insert(row, track);
+        m_records.insert(row, track);
+        m_encodedRecords.insert(row, QByteArray());
+        m_items.insert(row, 0);
         endInsertRows();
         emit countChanged(rowCount());
     }
@@ -138,9 +270,15 @@ void TrackModel::insert(int row, MKTrack *track) {
 }
 
 void TrackModel::remove(int row) {
-    if ((row >= 0) && (row < m_items.size())) {
+    if ((row >= 0) && (row < rowCount())) {
         beginRemoveRows(QModelIndex(), row, row);
-        m_items.takeAt(row)->deleteLater();
+        m_records.removeAt(row);
+        m_encodedRecords.removeAt(row);
+        
+        if (MKTrack *track = m_items.takeAt(row)) {
+            track->deleteLater();
+        }
+        
         endRemoveRows();
         emit countChanged(rowCount());
     }
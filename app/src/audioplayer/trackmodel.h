@@ -64,22 +64,32 @@ public:
     Q_INVOKABLE MKTrack* get(int row) const;
 
 private:
-    Q_INVOKABLE void append(MKTrack *track);
-    Q_INVOKABLE void insert(int row, MKTrack *track);
-    Q_INVOKABLE void remove(int row);
+    TrackRecord record(int row) const;
+    
+    void append(const TrackRecord &track);
+    void append(const QList<TrackRecord> &tracks);
+    void appendRecords(const QList<QByteArray> &records);
+    void insert(int row, const TrackRecord &track);
+    void remove(int row);
 
 private Q_SLOTS:
     void clear();
     
+    void onTrackChanged();
+    
 Q_SIGNALS:
     void countChanged(int c);
     
 private:
-    QList<MKTrack*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
+    // Each row is held as a record. Restored rows keep their encoded record until it is first used,
+    // and a track object is only created for a row when it is requested with get(). data() reads the
+    // record of a row that has no track object.
+    mutable QList<TrackRecord> m_records;
+    mutable QList<QByteArray> m_encodedRecords;
+    mutable QList<MKTrack*> m_items;
     
     friend class AudioPlayer;
+    friend class tst_Bench_ModelData;
 };
     
 #endif // TRACKMODEL_H
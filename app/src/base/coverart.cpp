@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "coverart.h"
+#include "imagediskcache.h"
+#include "tagreader.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QStringList>
+#ifdef MUSIKLOUD_DEBUG
+#include <QDebug>
+#endif
+
+// The number of directories whose artwork is cached
+static const int MAX_CACHED_FOLDERS = 500;
+
+QCache<QString, CoverArt::Folder> CoverArt::cache(MAX_CACHED_FOLDERS);
+QSet<QString> CoverArt::extracting;
+QMutex CoverArt::mutex;
+
+Q_GLOBAL_STATIC(CoverArt, coverArt)
+
+class CoverArtTask : public QRunnable
+{
+
+public:
+    CoverArtTask(const QString &path, qint64 lastModified, const QString &fileName) :
+        QRunnable(),
+        m_path(path),
+        m_lastModified(lastModified),
+        m_fileName(fileName)
+    {
+    }
+    
+    void run() {
+        CoverArt::setPictureUrl(m_path, m_lastModified, m_fileName, CoverArt::extractPicture(m_fileName));
+    }
+
+private:
+    QString m_path;
+    qint64 m_lastModified;
+    QString m_fileName;
+};
+
+CoverArt* CoverArt::instance() {
+    return coverArt();
+}
+
+QUrl CoverArt::thumbnailUrl(const QString &fileName) {
+    const int slash = fileName.lastIndexOf('/');
+    
+    if (slash < 0) {
+        return QUrl();
+    }
+    
+    const QString path = slash > 0 ? fileName.left(slash) : QString("/");
+    const QFileInfo info(path);
+    
+    if (!info.isDir()) {
+        return QUrl();
+    }
+    
+    const qint64 lastModified = info.lastModified().toMSecsSinceEpoch();
+    QMutexLocker locker(&mutex);
+    Folder *folder = cache.object(path);
+    
+    if ((!folder) || (folder->lastModified != lastModified)) {
+        folder = new Folder;
+        folder->lastModified = lastModified;
+        folder->coverUrl = findCoverFile(path);
+        cache.insert(path, folder);
+    }
+    
+    if (!folder->coverUrl.isEmpty()) {
+        return folder->coverUrl;
+    }
+    
+    if (folder->pictureUrls.contains(fileName)) {
+        const QUrl url = folder->pictureUrls.value(fileName);
+        
+        if (url.isEmpty()) {
+            return url;
+        }
+        
+        // The extracted picture may since have been removed from the disk cache
+        if (ImageDiskCache *diskCache = ImageDiskCache::instance()) {
+            if (diskCache->contains(url)) {
+                return url;
+            }
+        }
+    }
+    
+    if (!extracting.contains(fileName)) {
+        extracting.insert(fileName);
+        instance()->m_pool.start(new CoverArtTask(path, lastModified, fileName));
+    }
+    
+    return QUrl();
+}
+
+void CoverArt::setPictureUrl(const QString &path, qint64 lastModified, const QString &fileName,
+                                  const QUrl &url) {
+    QMutexLocker locker(&mutex);
+    extracting.remove(fileName);
+    Folder *folder = cache.object(path);
+    
+    if ((folder) && (folder->lastModified == lastModified)) {
+        folder->pictureUrls[fileName] = url;
+    }
+    
+    locker.unlock();
+    
+    if (!url.isEmpty()) {
+        // Delivered through a queued connection to receivers in other threads
+        emit instance()->thumbnailReady(fileName, url);
+    }
+}
+
+void CoverArt::clear() {
+    QMutexLocker locker(&mutex);
+    cache.clear();
+}
+
+void CoverArt::waitForDone() {
+    instance()->m_pool.waitForDone();
+}
+
+QUrl CoverArt::findCoverFile(const QString &path) {
+    // A single listing of the directory, rather than a stat() for each name
+    static const QStringList names = QStringList() << "cover.jpg" << "folder.jpg" << "front.jpg";
+    const QDir dir(path);
+    const QStringList fileNames = dir.entryList(names, QDir::Files);
+    
+    foreach (const QString &name, names) {
+        foreach (const QString &fileName, fileNames) {
+            if (fileName.compare(name, Qt::CaseInsensitive) == 0) {
+                return QUrl::fromLocalFile(dir.absoluteFilePath(fileName));
+            }
+        }
+    }
+    
+    return QUrl();
+}
+
+QUrl CoverArt::extractPicture(const QString &fileName) {
+    ImageDiskCache *diskCache = ImageDiskCache::instance();
+    
+    if (!diskCache) {
+        return QUrl();
+    }
+    
+    const QVariantMap tags = TagReader::read(fileName, true);
+    const QByteArray picture = tags.value("picture").toByteArray();
+    
+    if (picture.isEmpty()) {
+        return QUrl();
+    }
+    
+    // The modification time of the file is part of the URL, so that a picture that has changed is extracted again
+    QUrl url = QUrl::fromLocalFile(fileName);
+    url.setScheme("artwork");
+    url.setFragment(QString::number(tags.value("lastModified").toDateTime().toMSecsSinceEpoch()));
+    
+    if ((!diskCache->contains(url)) && (!diskCache->insert(url, picture))) {
+        return QUrl();
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "CoverArt::extractPicture" << fileName << picture.size() << "bytes";
+#endif
+    return url;
+}
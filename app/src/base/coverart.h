@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERART_H
+#define COVERART_H
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+#include <QUrl>
+
+/*
+ * Finds the artwork of local audio files. A cover image in the directory of the file (cover.jpg, folder.jpg or
+ * front.jpg) is preferred. Otherwise, the picture embedded in the tags of the file is extracted into the
+ * ImageDiskCache, and a URL that ImageCache resolves from there is returned.
+ *
+ * The answer for each directory, and for each file in it, is cached until the modification time of the
+ * directory changes, so repeated lookups cost a single stat() of the directory. Embedded pictures are extracted
+ * on a thread pool of its own: thumbnailUrl() returns an empty URL meanwhile, and thumbnailReady() is emitted
+ * when the picture is available. waitForDone() blocks until the pending extractions have finished. thumbnailUrl()
+ * is thread-safe.
+ */
+class CoverArt : public QObject
+{
+    Q_OBJECT
+
+public:
+    static CoverArt* instance();
+    
+    static QUrl thumbnailUrl(const QString &fileName);
+    
+    static void clear();
+    
+    static void waitForDone();
+
+Q_SIGNALS:
+    void thumbnailReady(const QString &fileName, const QUrl &url);
+
+private:
+    struct Folder {
+        qint64 lastModified;
+        QUrl coverUrl;
+        QHash<QString, QUrl> pictureUrls;
+    };
+    
+    static QUrl findCoverFile(const QString &path);
+    static QUrl extractPicture(const QString &fileName);
+    static void setPictureUrl(const QString &path, qint64 lastModified, const QString &fileName,
+                                   const QUrl &url);
+    
+    static QCache<QString, Folder> cache;
+    static QSet<QString> extracting;
+    static QMutex mutex;
+    
+    QThreadPool m_pool;
+    
+    friend class CoverArtTask;
+};
+
+#endif // COVERART_H
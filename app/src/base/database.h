@@ -21,6 +21,7 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QStringList>
 #include <QDir>
 #include <QDebug>
 
@@ -42,6 +43,68 @@ inline void initDatabase() {
     if (query.lastError().isValid()) {
         qDebug() << "initDatabase: database error:" << query.lastError().text();
     }
+    
+    query = db.exec("CREATE TABLE IF NOT EXISTS soundcloudFollowings (userId TEXT, artistId TEXT, \
+    UNIQUE(userId, artistId))");
+    
+    if (query.lastError().isValid()) {
+        qDebug() << "initDatabase: database error:" << query.lastError().text();
+    }
+    
+    query = db.exec("CREATE TABLE IF NOT EXISTS soundcloudFavourites (userId TEXT, trackId TEXT, \
+    UNIQUE(userId, trackId))");
+    
+    if (query.lastError().isValid()) {
+        qDebug() << "initDatabase: database error:" << query.lastError().text();
+    }
+    
+    query = db.exec("CREATE TABLE IF NOT EXISTS downloads (service TEXT, resourceId TEXT, fileName TEXT UNIQUE)");
+    
+    if (query.lastError().isValid()) {
+        qDebug() << "initDatabase: database error:" << query.lastError().text();
+    }
+    
+    query = db.exec("CREATE TABLE IF NOT EXISTS queue (id INTEGER PRIMARY KEY, data BLOB)");
+    
+    if (query.lastError().isValid()) {
+        qDebug() << "initDatabase: database error:" << query.lastError().text();
+    }
+    
+    query = db.exec("CREATE TABLE IF NOT EXISTS queueState (id INTEGER PRIMARY KEY, data BLOB)");
+    
+    if (query.lastError().isValid()) {
+        qDebug() << "initDatabase: database error:" << query.lastError().text();
+    }
+    
+    const QStringList libraryStatements = QStringList()
+        << "CREATE TABLE IF NOT EXISTS localLibraryFolders (path TEXT UNIQUE)"
+        << "CREATE TABLE IF NOT EXISTS localFolders (path TEXT PRIMARY KEY, parent TEXT)"
+        << "CREATE INDEX IF NOT EXISTS localFoldersParent ON localFolders (parent)"
+        << "CREATE TABLE IF NOT EXISTS localArtists (id INTEGER PRIMARY KEY, name TEXT UNIQUE)"
+        << "CREATE TABLE IF NOT EXISTS localAlbums (id INTEGER PRIMARY KEY, title TEXT, artistId INTEGER, \
+        UNIQUE(title, artistId))"
+        << "CREATE TABLE IF NOT EXISTS localTracks (id INTEGER PRIMARY KEY, fileName TEXT UNIQUE, folder TEXT, \
+        title TEXT COLLATE NOCASE, artistId INTEGER, albumId INTEGER, genre TEXT, year TEXT, duration INTEGER, \
+        size INTEGER, lastModified INTEGER)"
+        << "CREATE INDEX IF NOT EXISTS localTracksFolder ON localTracks (folder)"
+        << "CREATE INDEX IF NOT EXISTS localTracksTitle ON localTracks (title, id)"
+        << "CREATE INDEX IF NOT EXISTS localTracksArtist ON localTracks (artistId, title, id)"
+        << "CREATE INDEX IF NOT EXISTS localTracksAlbum ON localTracks (albumId, title, id)";
+    
+    foreach (const QString &statement, libraryStatements) {
+        query = db.exec(statement);
+        
+        if (query.lastError().isValid()) {
+            qDebug() << "initDatabase: database error:" << query.lastError().text();
+        }
+    }
+    
+    // Full text search is optional, since the SQLite library may be built without it
+    query = db.exec("CREATE VIRTUAL TABLE IF NOT EXISTS localTracksSearch USING fts3(title, artist)");
+    
+    if (query.lastError().isValid()) {
+        qDebug() << "initDatabase: database error:" << query.lastError().text();
+    }
 }
 
 inline QSqlDatabase getDatabase() {
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "downloadindex.h"
+#include "database.h"
+#include <QFile>
+
+QHash<QString, QStringList> DownloadIndex::files;
+bool DownloadIndex::loaded = false;
+
+QString DownloadIndex::fileName(const QString &service, const QString &resourceId) {
+    if (resourceId.isEmpty()) {
+        return QString();
+    }
+    
+    load();
+    const QString k = key(service, resourceId);
+    
+    if (!files.contains(k)) {
+        return QString();
+    }
+    
+    foreach (const QString &name, files.value(k)) {
+        if (QFile::exists(name)) {
+            return name;
+        }
+    }
+    
+    // The files have been moved or deleted since they were downloaded
+    remove(service, resourceId);
+    return QString();
+}
+
+void DownloadIndex::insert(const QString &service, const QString &resourceId, const QStringList &fileNames) {
+    if ((resourceId.isEmpty()) || (fileNames.isEmpty())) {
+        return;
+    }
+    
+    load();
+    files[key(service, resourceId)] = fileNames;
+    QSqlDatabase db = getDatabase();
+    db.transaction();
+    QSqlQuery query(db);
+    query.prepare("DELETE FROM downloads WHERE service = ? AND resourceId = ?");
+    query.addBindValue(service);
+    query.addBindValue(resourceId);
+    
+    if (!query.exec()) {
+        qDebug() << "DownloadIndex::insert: database error:" << query.lastError().text();
+    }
+    
+    query.prepare("INSERT OR REPLACE INTO downloads VALUES (?, ?, ?)");
+    
+    foreach (const QString &fileName, fileNames) {
+        query.addBindValue(service);
+        query.addBindValue(resourceId);
+        query.addBindValue(fileName);
+        
+        if (!query.exec()) {
+            qDebug() << "DownloadIndex::insert: database error:" << query.lastError().text();
+        }
+    }
+    
+    db.commit();
+}
+
+void DownloadIndex::remove(const QString &service, const QString &resourceId) {
+    load();
+    files.remove(key(service, resourceId));
+    QSqlQuery query(getDatabase());
+    query.prepare("DELETE FROM downloads WHERE service = ? AND resourceId = ?");
+    query.addBindValue(service);
+    query.addBindValue(resourceId);
+    
+    if (!query.exec()) {
+        qDebug() << "DownloadIndex::remove: database error:" << query.lastError().text();
+    }
+}
+
+QString DownloadIndex::key(const QString &service, const QString &resourceId) {
+    return service + "/" + resourceId;
+}
+
+void DownloadIndex::load() {
+    if (loaded) {
+        return;
+    }
+    
+    loaded = true;
+    QSqlQuery query(getDatabase());
+    
+    // The files of each download are read in the order in which they were inserted
+    if (!query.exec("SELECT service, resourceId, fileName FROM downloads ORDER BY rowid")) {
+        qDebug() << "DownloadIndex::load: database error:" << query.lastError().text();
+        return;
+    }
+    
+    while (query.next()) {
+        files[key(query.value(0).toString(), query.value(1).toString())] << query.value(2).toString();
+    }
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DOWNLOADINDEX_H
+#define DOWNLOADINDEX_H
+
+#include <QHash>
+#include <QStringList>
+
+/*
+ * Maps the service and resource id of each completed download to its local files, so that downloaded
+ * tracks can be played without streaming them. fileName() returns the first of the files that still exists,
+ * which is the downloaded track itself. Entries are stored in the database and are removed when none of their
+ * files exist. Must only be used from the GUI thread.
+ */
+class DownloadIndex
+{
+
+public:
+    static QString fileName(const QString &service, const QString &resourceId);
+    
+    static void insert(const QString &service, const QString &resourceId, const QStringList &fileNames);
+    static void remove(const QString &service, const QString &resourceId);
+    
+private:
+    static QString key(const QString &service, const QString &resourceId);
+    
+    static void load();
+    
+    static QHash<QString, QStringList> files;
+    static bool loaded;
+};
+
+#endif // DOWNLOADINDEX_H
@@ -0,0 +1,449 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "imagecache.h"
+#include "definitions.h"
+#include "imagediskcache.h"
+#include "imagememorycache.h"
+#include <QCoreApplication>
+#include <QBuffer>
+#include <QFile>
+#include <QImageReader>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QThread>
+
+QThread* ImageCache::thread = 0;
+ImageLoader* ImageCache::loader = 0;
+
+QCache<QString, QPixmap> ImageCache::cache;
+QSet<QString> ImageCache::pending;
+
+int ImageCache::refCount = 0;
+int ImageCache::sequence = 0;
+
+static const int MAX_REQUESTS = 6;
+
+// Requests are ordered by priority. Ordinary requests use an increasing sequence number, so that the most
+// recently requested image is loaded first. Visible images are raised above, and prefetched images are kept
+// below, all ordinary requests.
+static const int VISIBLE_PRIORITY = 0x40000000;
+static const int PREFETCH_PRIORITY = -0x40000000;
+
+// The pixmap cache is bounded by the size of the decoded pixmaps in bytes, not by the number of images
+static const int MAX_CACHE_COST = 8 * 1024 * 1024;
+
+ImageCache::ImageCache(QObject *parent) :
+    QObject(parent)
+{
+    refCount++;
+    
+    if (cache.maxCost() != MAX_CACHE_COST) {
+        cache.setMaxCost(MAX_CACHE_COST);
+    }
+    
+    if (!thread) {
+        thread = new QThread;
+        loader = new ImageLoader;
+        loader->moveToThread(thread);
+        thread->start();
+    }
+    
+    connect(loader, SIGNAL(imageLoaded(QString, QImage)), this, SLOT(onImageLoaded(QString, QImage)));
+    connect(loader, SIGNAL(imageCancelled(QString)), this, SLOT(onImageCancelled(QString)));
+}
+
+ImageCache::~ImageCache() {
+    refCount--;
+    
+    if (refCount == 0) {
+        // Wait for the loader to return, since it may be using the ImageDiskCache, which is destroyed at shutdown.
+        // The loader is then deleted here, as there is no event loop left to delete it later.
+        thread->quit();
+        thread->wait();
+        delete loader;
+        delete thread;
+        thread = 0;
+        loader = 0;
+        pending.clear();
+    }
+}
+
+QString ImageCache::cacheKey(const QUrl &url, const QSize &size, Qt::AspectRatioMode aspectRatioMode,
+                             Qt::TransformationMode transformationMode) {
+    // Concatenated, since arg() would also replace escapes such as %2F in the url
+    return url.toString() + '|' + QString::number(size.width()) + 'x' + QString::number(size.height()) + '|'
+           + QString::number(aspectRatioMode) + '|' + QString::number(transformationMode);
+}
+
+QPixmap ImageCache::pixmap(const QUrl &url, const QSize &size, Qt::AspectRatioMode aspectRatioMode,
+                           Qt::TransformationMode transformationMode) {
+    Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+    
+    if (url.isEmpty()) {
+        return QPixmap();
+    }
+    
+    const QString key = cacheKey(url, size, aspectRatioMode, transformationMode);
+    
+    if (QPixmap *pixmap = cache.object(key)) {
+        return *pixmap;
+    }
+    
+    if (!m_requests.contains(key)) {
+        // Also sent when the image is already pending, so that the loader raises its priority
+        m_requests.insert(key, url.toString());
+        pending.insert(key);
+        QMetaObject::invokeMethod(loader, "load", Qt::QueuedConnection, Q_ARG(QString, key), Q_ARG(QUrl, url),
+                                  Q_ARG(QSize, size), Q_ARG(int, aspectRatioMode), Q_ARG(int, transformationMode),
+                                  Q_ARG(int, ++sequence));
+    }
+    
+    return QPixmap();
+}
+
+void ImageCache::prefetch(const QUrl &url, const QSize &size, Qt::AspectRatioMode aspectRatioMode,
+                          Qt::TransformationMode transformationMode) {
+    if (url.isEmpty()) {
+        return;
+    }
+    
+    const QString key = cacheKey(url, size, aspectRatioMode, transformationMode);
+    
+    if ((cache.contains(key)) || (pending.contains(key))) {
+        return;
+    }
+    
+    pending.insert(key);
+    QMetaObject::invokeMethod(loader, "load", Qt::QueuedConnection, Q_ARG(QString, key), Q_ARG(QUrl, url),
+                              Q_ARG(QSize, size), Q_ARG(int, aspectRatioMode), Q_ARG(int, transformationMode),
+                              Q_ARG(int, PREFETCH_PRIORITY + (++sequence)));
+}
+
+void ImageCache::setVisibleUrls(const QList<QUrl> &urls) {
+    QStringList visible;
+    
+    foreach (const QUrl &url, urls) {
+        if (!url.isEmpty()) {
+            visible << url.toString();
+        }
+    }
+    
+    const QSet<QString> visibleSet = visible.toSet();
+    QStringList cancelled;
+    QMutableHashIterator<QString, QString> iterator(m_requests);
+    
+    while (iterator.hasNext()) {
+        iterator.next();
+        
+        if (!visibleSet.contains(iterator.value())) {
+            cancelled << iterator.key();
+            iterator.remove();
+        }
+    }
+    
+    if (!cancelled.isEmpty()) {
+        QMetaObject::invokeMethod(loader, "cancel", Qt::QueuedConnection, Q_ARG(QStringList, cancelled));
+    }
+    
+    if (!visible.isEmpty()) {
+        QMetaObject::invokeMethod(loader, "prioritize", Qt::QueuedConnection, Q_ARG(QStringList, visible));
+    }
+}
+
+void ImageCache::onImageLoaded(const QString &key, const QImage &image) {
+    if (pending.remove(key)) {
+        // Pixmaps can only be created in the GUI thread, so the conversion is done once here.
+        // A null pixmap is cached for images that cannot be loaded, so that painting does not trigger
+        // repeated requests.
+        QPixmap *pixmap = new QPixmap(QPixmap::fromImage(image));
+        cache.insert(key, pixmap, qMax(1, pixmap->width() * pixmap->height() * pixmap->depth() / 8));
+    }
+    
+    if (m_requests.remove(key)) {
+        emit imageReady();
+    }
+}
+
+void ImageCache::onImageCancelled(const QString &key) {
+    pending.remove(key);
+    
+    if (m_requests.remove(key)) {
+        // The request was cancelled on behalf of another view. Repainting requests the image again if needed.
+        emit imageReady();
+    }
+}
+
+ImageLoader::ImageLoader() :
+    QObject(),
+    m_manager(new QNetworkAccessManager(this))
+{
+}
+
+QImage ImageLoader::decodeImage(const QByteArray &data, const QSize &size, Qt::AspectRatioMode aspectRatioMode,
+                                Qt::TransformationMode transformationMode) {
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QBuffer::ReadOnly);
+    QImageReader reader(&buffer);
+    
+    if (transformationMode == Qt::FastTransformation) {
+        reader.setQuality(0);
+    }
+    
+    if (size.isEmpty()) {
+        return reader.read();
+    }
+    
+    const QSize original = reader.size();
+    
+    if (original.isValid()) {
+        const QSize target = original.scaled(size, aspectRatioMode);
+        
+        if ((target.width() <= original.width()) && (target.height() <= original.height())) {
+            // Decode directly at the target size. For JPEG images, this avoids decoding the full image at all.
+            reader.setScaledSize(target);
+            QImage image = reader.read();
+            
+            if ((image.isNull()) || (image.size() == target)) {
+                return image;
+            }
+            
+            return image.scaled(target, Qt::IgnoreAspectRatio, transformationMode);
+        }
+    }
+    
+    const QImage image = reader.read();
+    return image.isNull() ? image : image.scaled(size, aspectRatioMode, transformationMode);
+}
+
+void ImageLoader::load(const QString &key, const QUrl &url, const QSize &size, int aspectRatioMode,
+                       int transformationMode, int priority) {
+    if (m_keys.contains(key)) {
+        // Already waiting for this image, so only raise the priority of the request
+        if ((m_queue.contains(url)) && (m_queue.value(url) < priority)) {
+            m_queue[url] = priority;
+        }
+        
+        return;
+    }
+    
+    ImageVariant variant;
+    variant.key = key;
+    variant.size = size;
+    variant.aspectRatioMode = Qt::AspectRatioMode(aspectRatioMode);
+    variant.transformationMode = Qt::TransformationMode(transformationMode);
+    
+    const QImage image = ImageMemoryCache::image(key);
+    
+    if (!image.isNull()) {
+        emit imageLoaded(key, image);
+        return;
+    }
+    
+    QByteArray data = ImageMemoryCache::data(url);
+    
+    if (!data.isEmpty()) {
+        decodeVariant(data, variant);
+        return;
+    }
+    
+    if (m_waiting.contains(url)) {
+        m_waiting[url] << variant;
+        m_keys[key] = url;
+        
+        if ((m_queue.contains(url)) && (m_queue.value(url) < priority)) {
+            m_queue[url] = priority;
+        }
+        
+        return;
+    }
+    
+    if (url.scheme() == "file") {
+        QFile file(url.toLocalFile());
+        
+        if (file.open(QFile::ReadOnly)) {
+            data = file.readAll();
+        }
+        
+        decodeVariant(data, variant);
+        return;
+    }
+    
+    if (ImageDiskCache *diskCache = ImageDiskCache::instance()) {
+        data = diskCache->data(url);
+        
+        if (!data.isEmpty()) {
+            ImageMemoryCache::insertData(url, data);
+            decodeVariant(data, variant);
+            return;
+        }
+    }
+    
+    m_waiting[url] << variant;
+    m_keys[key] = url;
+    m_queue[url] = priority;
+    getNextImages();
+}
+
+void ImageLoader::prioritize(const QStringList &urls) {
+    // Visible images are loaded from the top of the view downwards
+    for (int i = 0; i < urls.size(); i++) {
+        const QUrl url(urls.at(i));
+        
+        if (m_queue.contains(url)) {
+            m_queue[url] = VISIBLE_PRIORITY - i;
+        }
+    }
+    
+    getNextImages();
+}
+
+void ImageLoader::cancel(const QStringList &keys) {
+    foreach (const QString &key, keys) {
+        if (!m_keys.contains(key)) {
+            continue;
+        }
+        
+        const QUrl url = m_keys.take(key);
+        QList<ImageVariant> &variants = m_waiting[url];
+        
+        for (int i = variants.size() - 1; i >= 0; i--) {
+            if (variants.at(i).key == key) {
+                variants.removeAt(i);
+            }
+        }
+        
+        emit imageCancelled(key);
+        
+        if (variants.isEmpty()) {
+            m_waiting.remove(url);
+            m_queue.remove(url);
+            
+            if (ImageRequest *request = m_active.take(url)) {
+                request->disconnect(this);
+                request->reply->abort();
+                request->deleteLater();
+            }
+        }
+    }
+    
+    getNextImages();
+}
+
+void ImageLoader::getImage(const QUrl &url) {
+    ImageRequest *request = new ImageRequest(m_manager, url);
+    request->setParent(this);
+    m_active[url] = request;
+    connect(request, SIGNAL(finished(ImageRequest*)), this, SLOT(onRequestFinished(ImageRequest*)));
+}
+
+void ImageLoader::getNextImages() {
+    while ((m_active.size() < MAX_REQUESTS) && (!m_queue.isEmpty())) {
+        QHash<QUrl, int>::const_iterator next = m_queue.constBegin();
+        
+        for (QHash<QUrl, int>::const_iterator iterator = next + 1; iterator != m_queue.constEnd(); ++iterator) {
+            if (iterator.value() > next.value()) {
+                next = iterator;
+            }
+        }
+        
+        const QUrl url = next.key();
+        m_queue.remove(url);
+        getImage(url);
+    }
+}
+
+void ImageLoader::decodeVariant(const QByteArray &data, const ImageVariant &variant) {
+    const QImage image = data.isEmpty() ? QImage() : decodeImage(data, variant.size, variant.aspectRatioMode,
+                                                                  variant.transformationMode);
+    ImageMemoryCache::insertImage(variant.key, image);
+    // Published to the GUI thread through a queued connection
+    emit imageLoaded(variant.key, image);
+}
+
+void ImageLoader::onRequestFinished(ImageRequest *request) {
+    m_active.remove(request->url);
+    QByteArray data;
+    
+    if (request->reply->error() == QNetworkReply::NoError) {
+        data = request->reply->readAll();
+    }
+    
+    QBuffer buffer(&data);
+    
+    if ((!data.isEmpty()) && (!QImageReader::imageFormat(&buffer).isEmpty())) {
+        ImageMemoryCache::insertData(request->url, data);
+        
+        if (ImageDiskCache *diskCache = ImageDiskCache::instance()) {
+            diskCache->insert(request->url, data);
+        }
+    }
+    else {
+        data.clear();
+    }
+    
+    foreach (const ImageVariant &variant, m_waiting.take(request->url)) {
+        m_keys.remove(variant.key);
+        decodeVariant(data, variant);
+    }
+    
+    request->deleteLater();
+    getNextImages();
+}
+
+ImageRequest::ImageRequest(QNetworkAccessManager *m, const QUrl &u) :
+    QObject()
+{
+    manager = m;
+    url = u;
+    redirects = 0;
+    
+    QUrl imageUrl(url);
+    
+    if (imageUrl.host().endsWith(".sndcdn.com")) {
+        // Hotfix for SoundCloud
+        imageUrl.setScheme("http");
+    }
+    
+    reply = manager->get(QNetworkRequest(imageUrl));
+    connect(reply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
+}
+
+ImageRequest::~ImageRequest() {
+    reply->deleteLater();
+    reply = 0;
+}
+
+void ImageRequest::onReplyFinished() {
+    if (redirects < MAX_REDIRECTS) {
+        QVariant redirect = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
+    
+        if (redirect.isNull()) {
+            redirect = reply->header(QNetworkRequest::LocationHeader);
+        }
+    
+        if (!redirect.isNull()) {
+            redirects++;
+            reply->deleteLater();
+            reply = manager->get(QNetworkRequest(redirect.toString()));
+            connect(reply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
+            return;
+        }
+    }
+        
+    emit finished(this);
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QSet>
+#include <QStringList>
+#include <QUrl>
+
+class ImageLoader;
+class ImageRequest;
+class QThread;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+/*
+ * Provides ready-to-paint pixmaps of remote images. Each (url, size, mode) variant is decoded once,
+ * at the requested size, by the shared ImageLoader thread and then cached as a QPixmap.
+ * imageReady() is emitted when an image requested through this instance becomes available.
+ *
+ * Requests are served most recent first. Views can raise the priority of their visible images with
+ * setVisibleUrls(), which also cancels this instance's requests for images that are no longer visible,
+ * and can queue images that are likely to be needed soon with prefetch(). Each view should therefore use its own
+ * instance. The decoded pixmaps are shared by all instances.
+ *
+ * ImageCache must only be used from the GUI thread. The pixmap cache is never touched by any other thread,
+ * so lookups need no locking, and a miss returns a null pixmap immediately while the image is loaded.
+ */
+class ImageCache : public QObject
+{
+    Q_OBJECT
+    
+public:
+    explicit ImageCache(QObject *parent = 0);
+    ~ImageCache();
+    
+    QPixmap pixmap(const QUrl &url, const QSize &size = QSize(), Qt::AspectRatioMode aspectRatioMode = Qt::KeepAspectRatio,
+                   Qt::TransformationMode transformationMode = Qt::SmoothTransformation);
+    
+    void prefetch(const QUrl &url, const QSize &size = QSize(), Qt::AspectRatioMode aspectRatioMode = Qt::KeepAspectRatio,
+                  Qt::TransformationMode transformationMode = Qt::SmoothTransformation);
+    
+    void setVisibleUrls(const QList<QUrl> &urls);
+    
+    static QString cacheKey(const QUrl &url, const QSize &size, Qt::AspectRatioMode aspectRatioMode,
+                            Qt::TransformationMode transformationMode);
+    
+private Q_SLOTS:
+    void onImageLoaded(const QString &key, const QImage &image);
+    void onImageCancelled(const QString &key);
+    
+Q_SIGNALS:
+    void imageReady();
+    
+private:
+    static QThread *thread;
+    static ImageLoader *loader;
+    
+    static QCache<QString, QPixmap> cache;
+    static QSet<QString> pending;
+    
+    static int refCount;
+    static int sequence;
+    
+    QHash<QString, QString> m_requests;
+};
+
+struct ImageVariant {
+    QString key;
+    QSize size;
+    Qt::AspectRatioMode aspectRatioMode;
+    Qt::TransformationMode transformationMode;
+};
+
+class ImageLoader : public QObject
+{
+    Q_OBJECT
+    
+public:
+    explicit ImageLoader();
+    
+    static QImage decodeImage(const QByteArray &data, const QSize &size, Qt::AspectRatioMode aspectRatioMode,
+                              Qt::TransformationMode transformationMode);
+    
+public Q_SLOTS:
+    void load(const QString &key, const QUrl &url, const QSize &size, int aspectRatioMode, int transformationMode,
+              int priority);
+    void prioritize(const QStringList &urls);
+    void cancel(const QStringList &keys);
+    
+private Q_SLOTS:
+    void onRequestFinished(ImageRequest *request);
+    
+Q_SIGNALS:
+    void imageLoaded(const QString &key, const QImage &image);
+    void imageCancelled(const QString &key);
+    
+private:
+    void getImage(const QUrl &url);
+    void getNextImages();
+    void decodeVariant(const QByteArray &data, const ImageVariant &variant);
+    
+    QNetworkAccessManager *m_manager;
+    
+    QHash<QUrl, QList<ImageVariant> > m_waiting;
+    QHash<QString, QUrl> m_keys;
+    QHash<QUrl, int> m_queue;
+    QHash<QUrl, ImageRequest*> m_active;
+};
+
+class ImageRequest : public QObject
+{
+    Q_OBJECT
+    
+private:
+    ImageRequest(QNetworkAccessManager *m, const QUrl &u);
+    ~ImageRequest();
+    
+    QNetworkAccessManager *manager;
+    QNetworkReply *reply;
+    QUrl url;
+    int redirects;
+    
+    friend class ImageLoader;
+    
+private Q_SLOTS:
+    void onReplyFinished();
+    
+Q_SIGNALS:
+    void finished(ImageRequest *request);
+};
+    
+#endif // IMAGECACHE_H
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "imagediskcache.h"
+#include "coverart.h"
+#include "definitions.h"
+#include "settings.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QMutexLocker>
+#include <QTemporaryFile>
+#ifdef Q_OS_UNIX
+#include <stdio.h>
+#include <utime.h>
+#endif
+#ifdef MUSIKLOUD_DEBUG
+#include <QDebug>
+#endif
+
+ImageDiskCache* ImageDiskCache::self = 0;
+
+// Replaces the file at target, if any, with the file at source
+static bool replaceFile(const QString &source, const QString &target) {
+#ifdef Q_OS_UNIX
+    return ::rename(QFile::encodeName(source).constData(), QFile::encodeName(target).constData()) == 0;
+#else
+    QFile::remove(target);
+    return QFile::rename(source, target);
+#endif
+}
+
+static void removeFiles(const QString &directory, const QStringList &fileNames) {
+    foreach (const QString &fileName, fileNames) {
+        QFile::remove(directory + fileName);
+    }
+}
+
+ImageDiskCache::ImageDiskCache(QObject *parent) :
+    QObject(parent),
+    m_directory(CACHE_PATH + "images/"),
+    m_size(0),
+    m_loaded(false),
+    m_maximumSize(qint64(DEFAULT_IMAGE_CACHE_SIZE) * 1024 * 1024)
+{
+    if (!self) {
+        self = this;
+    }
+
+    if (Settings *settings = Settings::instance()) {
+        m_maximumSize = qint64(settings->imageCacheSize()) * 1024 * 1024;
+        connect(settings, SIGNAL(imageCacheSizeChanged()), this, SLOT(onImageCacheSizeChanged()));
+    }
+}
+
+ImageDiskCache::~ImageDiskCache() {
+    // Artwork is extracted into the cache by CoverArt tasks
+    CoverArt::waitForDone();
+    
+    if (self == this) {
+        self = 0;
+    }
+}
+
+ImageDiskCache* ImageDiskCache::instance() {
+    return self;
+}
+
+QString ImageDiskCache::directory() const {
+    return m_directory;
+}
+
+qint64 ImageDiskCache::maximumSize() const {
+    QMutexLocker locker(&m_mutex);
+    return m_maximumSize;
+}
+
+void ImageDiskCache::setMaximumSize(qint64 size) {
+    QMutexLocker locker(&m_mutex);
+    m_maximumSize = qMax(qint64(0), size);
+    load();
+    const QStringList expired = expire();
+    locker.unlock();
+    removeFiles(m_directory, expired);
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "ImageDiskCache::setMaximumSize" << size;
+#endif
+}
+
+qint64 ImageDiskCache::size() const {
+    QMutexLocker locker(&m_mutex);
+    load();
+    return m_size;
+}
+
+QString ImageDiskCache::key(const QUrl &url) {
+    return QString::fromLatin1(QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Md5).toHex());
+}
+
+bool ImageDiskCache::contains(const QUrl &url) const {
+    QMutexLocker locker(&m_mutex);
+    load();
+    return m_entries.contains(key(url));
+}
+
+QByteArray ImageDiskCache::data(const QUrl &url) {
+    QMutexLocker locker(&m_mutex);
+    load();
+    const QString k = key(url);
+
+    if (!m_entries.contains(k)) {
+        return QByteArray();
+    }
+
+    m_entries[k].lastAccessed = QDateTime::currentMSecsSinceEpoch();
+    locker.unlock();
+    QFile file(m_directory + k);
+
+    if (!file.open(QFile::ReadOnly)) {
+        locker.relock();
+
+        if (m_entries.contains(k)) {
+            m_size -= m_entries.take(k).size;
+        }
+
+        return QByteArray();
+    }
+#ifdef Q_OS_UNIX
+    // Update the modification time so that the access order survives a restart
+    utime(QFile::encodeName(file.fileName()).constData(), 0);
+#endif
+    return file.readAll();
+}
+
+bool ImageDiskCache::insert(const QUrl &url, const QByteArray &data) {
+    if (data.isEmpty()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    if (data.size() > m_maximumSize) {
+        return false;
+    }
+
+    load();
+    locker.unlock();
+
+    if (!QDir().mkpath(m_directory)) {
+        return false;
+    }
+
+    // The data is written to a temporary file that then replaces the cached file, so that readers never see a
+    // partially written file. The temporary file is removed if it is not renamed.
+    const QString k = key(url);
+    QTemporaryFile file(m_directory + k + ".XXXXXX");
+
+    if ((!file.open()) || (file.write(data) != data.size()) || (!file.flush())) {
+        return false;
+    }
+
+    file.close();
+
+    if (!replaceFile(file.fileName(), m_directory + k)) {
+        return false;
+    }
+
+    locker.relock();
+
+    if (m_entries.contains(k)) {
+        m_size -= m_entries.value(k).size;
+    }
+
+    Entry entry;
+    entry.size = data.size();
+    entry.lastAccessed = QDateTime::currentMSecsSinceEpoch();
+    m_entries[k] = entry;
+    m_size += entry.size;
+    const QStringList expired = expire();
+    locker.unlock();
+    removeFiles(m_directory, expired);
+    return true;
+}
+
+void ImageDiskCache::remove(const QUrl &url) {
+    QMutexLocker locker(&m_mutex);
+    load();
+    const QString k = key(url);
+
+    if (m_entries.contains(k)) {
+        m_size -= m_entries.take(k).size;
+        locker.unlock();
+        QFile::remove(m_directory + k);
+    }
+}
+
+void ImageDiskCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_size = 0;
+    m_loaded = true;
+    locker.unlock();
+    QDir dir(m_directory);
+
+    foreach (const QString &fileName, dir.entryList(QDir::Files)) {
+        dir.remove(fileName);
+    }
+}
+
+void ImageDiskCache::load() const {
+    if (m_loaded) {
+        return;
+    }
+
+    m_loaded = true;
+    QDir dir(m_directory);
+
+    foreach (const QFileInfo &info, dir.entryInfoList(QDir::Files)) {
+        // Keys are hexadecimal, so a name with a suffix is a temporary file left by an interrupted insertion
+        if (info.fileName().contains('.')) {
+            QFile::remove(info.absoluteFilePath());
+            continue;
+        }
+
+        Entry entry;
+        entry.size = info.size();
+        entry.lastAccessed = info.lastModified().toMSecsSinceEpoch();
+        m_entries[info.fileName()] = entry;
+        m_size += entry.size;
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "ImageDiskCache::load" << m_entries.size() << "files" << m_size << "bytes";
+#endif
+}
+
+QStringList ImageDiskCache::expire() {
+    QStringList expired;
+
+    if (m_size <= m_maximumSize) {
+        return expired;
+    }
+
+    // Remove the least recently used files until the cache is 10% below its maximum size,
+    // so that eviction does not run on every insertion once the cache is full
+    const qint64 target = m_maximumSize - m_maximumSize / 10;
+    QMultiMap<qint64, QString> lru;
+    QHashIterator<QString, Entry> iterator(m_entries);
+
+    while (iterator.hasNext()) {
+        iterator.next();
+        lru.insert(iterator.value().lastAccessed, iterator.key());
+    }
+
+    QMapIterator<qint64, QString> lruIterator(lru);
+
+    while ((m_size > target) && (lruIterator.hasNext())) {
+        lruIterator.next();
+        m_size -= m_entries.take(lruIterator.value()).size;
+        expired << lruIterator.value();
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "ImageDiskCache::expire" << m_entries.size() << "files" << m_size << "bytes";
+#endif
+    return expired;
+}
+
+void ImageDiskCache::onImageCacheSizeChanged() {
+    if (Settings *settings = Settings::instance()) {
+        setMaximumSize(qint64(settings->imageCacheSize()) * 1024 * 1024);
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGEDISKCACHE_H
+#define IMAGEDISKCACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QUrl>
+
+/*
+ * Persistent store of encoded image data, keyed by a hash of the image URL.
+ * All public methods are thread-safe, and files are read and written without holding
+ * the lock. When the total size exceeds maximumSize(), the least recently used files
+ * are removed.
+ */
+class ImageDiskCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ImageDiskCache(QObject *parent = 0);
+    ~ImageDiskCache();
+
+    static ImageDiskCache* instance();
+
+    QString directory() const;
+
+    qint64 maximumSize() const;
+    void setMaximumSize(qint64 size);
+
+    qint64 size() const;
+
+    bool contains(const QUrl &url) const;
+
+    QByteArray data(const QUrl &url);
+    bool insert(const QUrl &url, const QByteArray &data);
+
+    void remove(const QUrl &url);
+
+public Q_SLOTS:
+    void clear();
+
+private Q_SLOTS:
+    void onImageCacheSizeChanged();
+
+private:
+    struct Entry {
+        qint64 size;
+        qint64 lastAccessed;
+    };
+
+    static QString key(const QUrl &url);
+
+    void load() const;
+    QStringList expire();
+
+    static ImageDiskCache *self;
+
+    QString m_directory;
+
+    mutable QMutex m_mutex;
+    mutable QHash<QString, Entry> m_entries;
+    mutable qint64 m_size;
+    mutable bool m_loaded;
+
+    qint64 m_maximumSize;
+};
+
+#endif // IMAGEDISKCACHE_H
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "imagememorycache.h"
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+static const int SHARD_COUNT = 8;
+
+// Total costs in bytes, divided evenly between the shards
+static const int MAX_DATA_COST = 2 * 1024 * 1024;
+static const int MAX_IMAGE_COST = 4 * 1024 * 1024;
+
+struct ImageShard {
+    ImageShard() {
+        data.setMaxCost(MAX_DATA_COST / SHARD_COUNT);
+        images.setMaxCost(MAX_IMAGE_COST / SHARD_COUNT);
+    }
+    
+    QMutex mutex;
+    QCache<QString, QByteArray> data;
+    QCache<QString, QImage> images;
+};
+
+static ImageShard shards[SHARD_COUNT];
+
+static ImageShard& shard(const QString &key) {
+    return shards[qHash(key) % SHARD_COUNT];
+}
+
+QByteArray ImageMemoryCache::data(const QUrl &url) {
+    const QString key = url.toString();
+    ImageShard &s = shard(key);
+    QMutexLocker locker(&s.mutex);
+    
+    if (QByteArray *data = s.data.object(key)) {
+        return *data;
+    }
+    
+    return QByteArray();
+}
+
+void ImageMemoryCache::insertData(const QUrl &url, const QByteArray &data) {
+    if (data.isEmpty()) {
+        return;
+    }
+    
+    const QString key = url.toString();
+    ImageShard &s = shard(key);
+    QMutexLocker locker(&s.mutex);
+    s.data.insert(key, new QByteArray(data), data.size());
+}
+
+QImage ImageMemoryCache::image(const QString &key) {
+    ImageShard &s = shard(key);
+    QMutexLocker locker(&s.mutex);
+    
+    if (QImage *image = s.images.object(key)) {
+        return *image;
+    }
+    
+    return QImage();
+}
+
+void ImageMemoryCache::insertImage(const QString &key, const QImage &image) {
+    if (image.isNull()) {
+        return;
+    }
+    
+    ImageShard &s = shard(key);
+    QMutexLocker locker(&s.mutex);
+    s.images.insert(key, new QImage(image), image.byteCount());
+}
+
+void ImageMemoryCache::clear() {
+    for (int i = 0; i < SHARD_COUNT; i++) {
+        QMutexLocker locker(&shards[i].mutex);
+        shards[i].data.clear();
+        shards[i].images.clear();
+    }
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGEMEMORYCACHE_H
+#define IMAGEMEMORYCACHE_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <QUrl>
+
+/*
+ * In-memory cache of encoded image data and decoded image variants, shared by the image loader thread
+ * and the QML image provider threads. Entries are spread across independently locked shards by key,
+ * so concurrent lookups of different images do not contend for the same lock.
+ */
+class ImageMemoryCache
+{
+
+public:
+    static QByteArray data(const QUrl &url);
+    static void insertData(const QUrl &url, const QByteArray &data);
+    
+    static QImage image(const QString &key);
+    static void insertImage(const QString &key, const QImage &image);
+    
+    static void clear();
+};
+
+#endif // IMAGEMEMORYCACHE_H
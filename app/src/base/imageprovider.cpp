@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "imageprovider.h"
+#include "definitions.h"
+#include "imagecache.h"
+#include "imagediskcache.h"
+#include "imagememorycache.h"
+#include <QEventLoop>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QSemaphore>
+#include <QUrl>
+
+// Limits the number of simultaneous downloads across all QML image loader threads
+static const int MAX_CONCURRENT_REQUESTS = 4;
+
+static QSemaphore requestSemaphore(MAX_CONCURRENT_REQUESTS);
+
+#if QT_VERSION >= 0x050600
+ImageProvider::ImageProvider() :
+    QQuickAsyncImageProvider()
+{
+    m_pool.setMaxThreadCount(MAX_CONCURRENT_REQUESTS);
+}
+
+QQuickImageResponse* ImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize) {
+    ImageResponse *response = new ImageResponse(id, requestedSize);
+    m_pool.start(response);
+    return response;
+}
+
+ImageResponse::ImageResponse(const QString &id, const QSize &requestedSize) :
+    QQuickImageResponse(),
+    QRunnable(),
+    m_id(id),
+    m_requestedSize(requestedSize)
+{
+    // The response is deleted by the QML engine, not by the thread pool
+    setAutoDelete(false);
+}
+
+QQuickTextureFactory* ImageResponse::textureFactory() const {
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+}
+
+void ImageResponse::run() {
+    m_image = ImageProvider::loadImage(m_id, m_requestedSize);
+    emit finished();
+}
+#else
+ImageProvider::ImageProvider() :
+#if QT_VERSION >= 0x050000
+    QQuickImageProvider(QQuickImageProvider::Image, QQuickImageProvider::ForceAsynchronousImageLoading)
+#else
+    QDeclarativeImageProvider(QDeclarativeImageProvider::Image)
+#endif
+{
+}
+
+// Called from the QML image loader thread. Images are only loaded asynchronously by Qt 4 when
+// Image.asynchronous is set.
+QImage ImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize) {
+    const QImage image = loadImage(id, requestedSize);
+
+    if (size) {
+        *size = image.size();
+    }
+
+    return image;
+}
+#endif
+
+QImage ImageProvider::loadImage(const QString &id, const QSize &requestedSize) {
+    const QUrl url(QUrl::fromPercentEncoding(id.toUtf8()));
+    const QString key = ImageCache::cacheKey(url, requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    QImage image = ImageMemoryCache::image(key);
+
+    if (!image.isNull()) {
+        return image;
+    }
+
+    ImageDiskCache *diskCache = ImageDiskCache::instance();
+    QByteArray data = ImageMemoryCache::data(url);
+    bool downloaded = false;
+
+    if ((data.isEmpty()) && (diskCache)) {
+        data = diskCache->data(url);
+    }
+
+    if (data.isEmpty()) {
+        requestSemaphore.acquire();
+        data = download(url);
+        requestSemaphore.release();
+        downloaded = true;
+    }
+
+    // Decode directly at the requested size, rather than decoding the full image and scaling it
+    image = data.isEmpty() ? QImage() : ImageLoader::decodeImage(data, requestedSize, Qt::KeepAspectRatio,
+                                                                 Qt::SmoothTransformation);
+
+    if (!image.isNull()) {
+        ImageMemoryCache::insertData(url, data);
+        ImageMemoryCache::insertImage(key, image);
+
+        if ((downloaded) && (diskCache)) {
+            diskCache->insert(url, data);
+        }
+    }
+
+    return image;
+}
+
+// Called from a QML image loader thread, so the request is made synchronously in that thread
+QByteArray ImageProvider::download(const QUrl &url) {
+    QNetworkAccessManager manager;
+    QEventLoop loop;
+    QUrl imageUrl(url);
+
+    if (imageUrl.host().endsWith(".sndcdn.com")) {
+        // Hotfix for SoundCloud
+        imageUrl.setScheme("http");
+    }
+
+    for (int redirects = 0; redirects <= MAX_REDIRECTS; redirects++) {
+        QNetworkReply *reply = manager.get(QNetworkRequest(imageUrl));
+        QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+        loop.exec();
+
+        QVariant redirect = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
+
+        if (redirect.isNull()) {
+            redirect = reply->header(QNetworkRequest::LocationHeader);
+        }
+
+        if (redirect.isNull()) {
+            const QByteArray data = reply->error() == QNetworkReply::NoError ? reply->readAll() : QByteArray();
+            reply->deleteLater();
+            return data;
+        }
+
+        imageUrl = imageUrl.resolved(redirect.toUrl());
+        reply->deleteLater();
+    }
+
+    return QByteArray();
+}
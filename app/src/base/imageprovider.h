@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGEPROVIDER_H
+#define IMAGEPROVIDER_H
+
+#include <QtGlobal>
+#if QT_VERSION >= 0x050600
+#include <QQuickAsyncImageProvider>
+#include <QRunnable>
+#include <QThreadPool>
+#elif QT_VERSION >= 0x050000
+#include <QQuickImageProvider>
+#else
+#include <QDeclarativeImageProvider>
+#endif
+
+class QUrl;
+
+/*
+ * Serves remote images to QML as image://images/<percent-encoded URL>. Images are decoded at the
+ * requested source size and shared with the widget image cache through ImageMemoryCache and ImageDiskCache.
+ * At most MAX_CONCURRENT_REQUESTS images are downloaded at a time.
+ */
+#if QT_VERSION >= 0x050600
+class ImageProvider : public QQuickAsyncImageProvider
+{
+
+public:
+    explicit ImageProvider();
+
+    QQuickImageResponse* requestImageResponse(const QString &id, const QSize &requestedSize);
+
+    static QImage loadImage(const QString &id, const QSize &requestedSize);
+
+private:
+    static QByteArray download(const QUrl &url);
+
+    QThreadPool m_pool;
+};
+
+class ImageResponse : public QQuickImageResponse, public QRunnable
+{
+
+public:
+    explicit ImageResponse(const QString &id, const QSize &requestedSize);
+
+    QQuickTextureFactory* textureFactory() const;
+
+    void run();
+
+private:
+    QString m_id;
+    QSize m_requestedSize;
+    QImage m_image;
+};
+#else
+#if QT_VERSION >= 0x050000
+class ImageProvider : public QQuickImageProvider
+#else
+class ImageProvider : public QDeclarativeImageProvider
+#endif
+{
+
+public:
+    explicit ImageProvider();
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize);
+
+    static QImage loadImage(const QString &id, const QSize &requestedSize);
+
+private:
+    static QByteArray download(const QUrl &url);
+};
+#endif
+
+#endif // IMAGEPROVIDER_H
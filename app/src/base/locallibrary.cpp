@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "locallibrary.h"
+#include "database.h"
+#include "settings.h"
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+
+LocalLibrary* LocalLibrary::self = 0;
+
+// A changed directory is only indexed again once it has stopped changing for this long,
+// so that files that are being copied or downloaded are not read before they are complete
+static const int CHANGED_FOLDER_DELAY = 2000;
+
+// changed() is emitted at most this often while the library is being indexed
+static const int UPDATE_INTERVAL = 2000;
+
+LocalLibrary::LocalLibrary(QObject *parent) :
+    QObject(parent),
+    m_watcher(new QFileSystemWatcher(this)),
+    m_scanner(0)
+{
+    if (!self) {
+        self = this;
+    }
+    
+    m_changedTimer.setSingleShot(true);
+    m_changedTimer.setInterval(CHANGED_FOLDER_DELAY);
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(UPDATE_INTERVAL);
+    
+    connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(onDirectoryChanged(QString)));
+    connect(&m_changedTimer, SIGNAL(timeout()), this, SLOT(updateChangedFolders()));
+    connect(&m_updateTimer, SIGNAL(timeout()), this, SIGNAL(changed()));
+    
+    if (Settings *settings = Settings::instance()) {
+        connect(settings, SIGNAL(categoriesChanged()), this, SLOT(onCategoriesChanged()));
+    }
+}
+
+LocalLibrary::~LocalLibrary() {
+    if (m_scanner) {
+        m_scanner->cancel();
+        m_scanner->wait();
+    }
+    
+    if (self == this) {
+        self = 0;
+    }
+}
+
+LocalLibrary* LocalLibrary::instance() {
+    return self;
+}
+
+QStringList LocalLibrary::folders() const {
+    return m_folders;
+}
+
+QStringList LocalLibrary::userFolders() const {
+    return m_userFolders;
+}
+
+bool LocalLibrary::isScanning() const {
+    return m_scanner != 0;
+}
+
+void LocalLibrary::addFolder(const QString &folder) {
+    const QString path = cleanPath(folder);
+    
+    if ((path.isEmpty()) || (m_userFolders.contains(path))) {
+        return;
+    }
+    
+    QSqlQuery query(getDatabase());
+    query.prepare("INSERT OR IGNORE INTO localLibraryFolders VALUES (?)");
+    query.addBindValue(path);
+    
+    if (!query.exec()) {
+        qDebug() << "LocalLibrary::addFolder: database error:" << query.lastError().text();
+    }
+    
+    m_userFolders << path;
+    setFolders(libraryFolders());
+}
+
+void LocalLibrary::removeFolder(const QString &folder) {
+    const QString path = cleanPath(folder);
+    
+    if (!m_userFolders.removeOne(path)) {
+        return;
+    }
+    
+    QSqlQuery query(getDatabase());
+    query.prepare("DELETE FROM localLibraryFolders WHERE path = ?");
+    query.addBindValue(path);
+    
+    if (!query.exec()) {
+        qDebug() << "LocalLibrary::removeFolder: database error:" << query.lastError().text();
+    }
+    
+    setFolders(libraryFolders());
+}
+
+void LocalLibrary::rescan() {
+    QSqlDatabase db = getDatabase();
+    QSqlQuery query(db);
+    m_userFolders.clear();
+    
+    if (query.exec("SELECT path FROM localLibraryFolders")) {
+        while (query.next()) {
+            m_userFolders << query.value(0).toString();
+        }
+    }
+    else {
+        qDebug() << "LocalLibrary::rescan: database error:" << query.lastError().text();
+    }
+    
+    m_folders = libraryFolders();
+    emit foldersChanged();
+    
+    // Remove the directories of folders that have left the library since the index was last updated
+    QSet<QString> removed;
+    
+    if (query.exec("SELECT path FROM localFolders")) {
+        while (query.next()) {
+            const QString path = query.value(0).toString();
+            
+            if (!contains(m_folders, path)) {
+                removed << path;
+            }
+        }
+    }
+    
+    foreach (const QString &path, removed) {
+        if (!removed.contains(QFileInfo(path).absolutePath())) {
+            addJob(LocalLibraryJob::Remove, path);
+        }
+    }
+    
+    foreach (const QString &folder, m_folders) {
+        addJob(LocalLibraryJob::Scan, folder);
+    }
+}
+
+void LocalLibrary::onCategoriesChanged() {
+    setFolders(libraryFolders());
+}
+
+void LocalLibrary::onDirectoryChanged(const QString &path) {
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "LocalLibrary::onDirectoryChanged" << path;
+#endif
+    m_changedFolders << path;
+    m_changedTimer.start();
+}
+
+void LocalLibrary::onScannerChanged() {
+    if (!m_updateTimer.isActive()) {
+        m_updateTimer.start();
+    }
+}
+
+void LocalLibrary::onScannerFinished() {
+    m_scanner->deleteLater();
+    m_scanner = 0;
+    
+    if (!m_jobs.isEmpty()) {
+        startScanner();
+    }
+    else {
+        emit scanningChanged(false);
+    }
+}
+
+void LocalLibrary::onScannerFoldersFound(const QStringList &folders) {
+    const QSet<QString> watched = m_watcher->directories().toSet();
+    QStringList paths;
+    
+    foreach (const QString &folder, folders) {
+        if (!watched.contains(folder)) {
+            paths << folder;
+        }
+    }
+    
+    if (!paths.isEmpty()) {
+        m_watcher->addPaths(paths);
+    }
+}
+
+void LocalLibrary::onScannerFoldersRemoved(const QStringList &folders) {
+    const QSet<QString> watched = m_watcher->directories().toSet();
+    QStringList paths;
+    
+    foreach (const QString &folder, folders) {
+        if (watched.contains(folder)) {
+            paths << folder;
+        }
+    }
+    
+    if (!paths.isEmpty()) {
+        m_watcher->removePaths(paths);
+    }
+}
+
+void LocalLibrary::updateChangedFolders() {
+    foreach (const QString &folder, m_changedFolders) {
+        if (contains(m_folders, folder)) {
+            addJob(LocalLibraryJob::Update, folder);
+        }
+    }
+    
+    m_changedFolders.clear();
+}
+
+QString LocalLibrary::cleanPath(const QString &path) {
+    return path.isEmpty() ? QString() : QDir::cleanPath(QDir(path).absolutePath());
+}
+
+bool LocalLibrary::contains(const QStringList &folders, const QString &path) {
+    foreach (const QString &folder, folders) {
+        if ((path == folder) || (path.startsWith(folder + "/"))) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+QStringList LocalLibrary::libraryFolders() const {
+    QStringList paths;
+    
+    if (Settings *settings = Settings::instance()) {
+        foreach (const Category &category, settings->categories()) {
+            paths << cleanPath(category.path);
+        }
+    }
+    
+    paths << m_userFolders;
+    paths.removeDuplicates();
+    paths.sort();
+    
+    // Folders inside another library folder are indexed as part of it. Sorting the paths places each folder
+    // before the folders inside it.
+    QStringList folders;
+    
+    foreach (const QString &path, paths) {
+        if ((!path.isEmpty()) && (!contains(folders, path))) {
+            folders << path;
+        }
+    }
+    
+    return folders;
+}
+
+void LocalLibrary::setFolders(const QStringList &folders) {
+    if (folders == m_folders) {
+        return;
+    }
+    
+    const QStringList previous = m_folders;
+    QStringList removed;
+    m_folders = folders;
+    
+    foreach (const QString &folder, previous) {
+        if (!contains(folders, folder)) {
+            removed << folder;
+            addJob(LocalLibraryJob::Remove, folder);
+        }
+    }
+    
+    foreach (const QString &folder, folders) {
+        // Folders that were already indexed as part of another library folder are not indexed again,
+        // unless that folder has been removed
+        if ((!contains(previous, folder)) || (contains(removed, folder))) {
+            addJob(LocalLibraryJob::Scan, folder);
+        }
+    }
+    
+    emit foldersChanged();
+}
+
+void LocalLibrary::addJob(LocalLibraryJob::Type type, const QString &folder) {
+    const LocalLibraryJob job(type, folder);
+    
+    if (!m_jobs.contains(job)) {
+        m_jobs << job;
+        
+        // Jobs that are added together are run by the same scanner
+        QMetaObject::invokeMethod(this, "startScanner", Qt::QueuedConnection);
+    }
+}
+
+void LocalLibrary::startScanner() {
+    if ((m_scanner) || (m_jobs.isEmpty())) {
+        return;
+    }
+    
+    m_scanner = new LocalLibraryScanner(getDatabase().databaseName(), m_jobs, this);
+    m_jobs.clear();
+    connect(m_scanner, SIGNAL(changed()), this, SLOT(onScannerChanged()));
+    connect(m_scanner, SIGNAL(finished()), this, SLOT(onScannerFinished()));
+    connect(m_scanner, SIGNAL(foldersFound(QStringList)), this, SLOT(onScannerFoldersFound(QStringList)));
+    connect(m_scanner, SIGNAL(foldersRemoved(QStringList)), this, SLOT(onScannerFoldersRemoved(QStringList)));
+    m_scanner->start(QThread::LowPriority);
+    emit scanningChanged(true);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOCALLIBRARY_H
+#define LOCALLIBRARY_H
+
+#include "locallibraryscanner.h"
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+class QFileSystemWatcher;
+
+/*
+ * Indexes the audio files in the category download paths and in folders added by the user. The index is
+ * stored in the localTracks, localArtists and localAlbums tables, and is read through LocalTrackModel.
+ *
+ * rescan() checks every folder in the background when the application starts. After that, the directories
+ * of the library are watched, and only directories whose entries change are indexed again.
+ */
+class LocalLibrary : public QObject
+{
+    Q_OBJECT
+    
+    Q_PROPERTY(QStringList folders READ folders NOTIFY foldersChanged)
+    Q_PROPERTY(QStringList userFolders READ userFolders NOTIFY foldersChanged)
+    Q_PROPERTY(bool scanning READ isScanning NOTIFY scanningChanged)
+
+public:
+    explicit LocalLibrary(QObject *parent = 0);
+    ~LocalLibrary();
+    
+    static LocalLibrary* instance();
+    
+    QStringList folders() const;
+    QStringList userFolders() const;
+    
+    bool isScanning() const;
+
+public Q_SLOTS:
+    void addFolder(const QString &folder);
+    void removeFolder(const QString &folder);
+    
+    void rescan();
+    
+private Q_SLOTS:
+    void onCategoriesChanged();
+    void onDirectoryChanged(const QString &path);
+    
+    void onScannerChanged();
+    void onScannerFinished();
+    void onScannerFoldersFound(const QStringList &folders);
+    void onScannerFoldersRemoved(const QStringList &folders);
+    
+    void updateChangedFolders();
+    
+    void startScanner();
+    
+Q_SIGNALS:
+    void changed();
+    void foldersChanged();
+    void scanningChanged(bool s);
+    
+private:
+    static QString cleanPath(const QString &path);
+    static bool contains(const QStringList &folders, const QString &path);
+    
+    QStringList libraryFolders() const;
+    void setFolders(const QStringList &folders);
+    
+    void addJob(LocalLibraryJob::Type type, const QString &folder);
+    
+    static LocalLibrary *self;
+    
+    QFileSystemWatcher *m_watcher;
+    LocalLibraryScanner *m_scanner;
+    
+    QList<LocalLibraryJob> m_jobs;
+    
+    QStringList m_folders;
+    QStringList m_userFolders;
+    
+    QSet<QString> m_changedFolders;
+    
+    QTimer m_changedTimer;
+    QTimer m_updateTimer;
+};
+
+#endif // LOCALLIBRARY_H
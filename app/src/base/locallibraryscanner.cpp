@@ -0,0 +1,544 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "locallibraryscanner.h"
+#include "definitions.h"
+#include "tagreader.h"
+#include <QDateTime>
+#include <QDir>
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStack>
+#include <QDebug>
+
+static const QString CONNECTION_NAME("localLibraryScanner");
+
+// Tags are read for this many files at a time, before the transaction that writes them is started
+static const int WRITE_BATCH = 50;
+
+// changed() is emitted after this many tracks have been written or removed, so that the index can be read while
+// it is built
+static const int CHANGED_INTERVAL = 500;
+
+LocalLibraryScanner::LocalLibraryScanner(const QString &databaseName, const QList<LocalLibraryJob> &jobs,
+                                         QObject *parent) :
+    QThread(parent),
+    m_databaseName(databaseName),
+    m_jobs(jobs),
+    m_search(false),
+    m_writes(0),
+    m_removed(false),
+    m_cancelled(0)
+{
+}
+
+void LocalLibraryScanner::cancel() {
+    m_cancelled.fetchAndStoreRelaxed(1);
+}
+
+bool LocalLibraryScanner::isCancelled() const {
+#if QT_VERSION >= 0x050000
+    return m_cancelled.load() != 0;
+#else
+    return m_cancelled != 0;
+#endif
+}
+
+void LocalLibraryScanner::run() {
+    m_db = QSqlDatabase::addDatabase("QSQLITE", CONNECTION_NAME);
+    m_db.setDatabaseName(m_databaseName);
+    
+    if (m_db.open()) {
+        m_search = m_db.tables().contains("localTracksSearch");
+        
+        foreach (const LocalLibraryJob &job, m_jobs) {
+            if (isCancelled()) {
+                break;
+            }
+#ifdef MUSIKLOUD_DEBUG
+            qDebug() << "LocalLibraryScanner::run" << job.type << job.folder;
+#endif
+            m_writes = 0;
+            m_removed = false;
+            
+            switch (job.type) {
+            case LocalLibraryJob::Scan:
+                scanTree(job.folder);
+                break;
+            case LocalLibraryJob::Update:
+                updateFolder(job.folder);
+                break;
+            default:
+                removeTree(job.folder);
+                break;
+            }
+            
+            removeOrphans();
+            emit changed();
+        }
+        
+        m_db.close();
+    }
+    else {
+        qDebug() << "LocalLibraryScanner::run: database error:" << m_db.lastError().text();
+    }
+    
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(CONNECTION_NAME);
+}
+
+void LocalLibraryScanner::scanTree(const QString &root) {
+    if (!QFileInfo(root).isDir()) {
+        removeTree(root);
+        return;
+    }
+    
+    QStack<QString> folders;
+    folders.push(root);
+    QStringList scanned;
+    
+    while ((!folders.isEmpty()) && (!isCancelled())) {
+        const QString folder = folders.pop();
+        const QStringList subfolders = scanFolder(folder);
+        scanned << folder;
+        
+        for (int i = subfolders.size() - 1; i >= 0; i--) {
+            folders.push(subfolders.at(i));
+        }
+    }
+    
+    if (isCancelled()) {
+        return;
+    }
+    
+    // Remove the directories that were indexed previously but no longer exist
+    const QSet<QString> existing = scanned.toSet();
+    QStringList removed;
+    m_db.transaction();
+    
+    foreach (const QString &folder, knownFolders(root)) {
+        if (!existing.contains(folder)) {
+            removeFolder(folder);
+            removed << folder;
+        }
+    }
+    
+    commit();
+    emit foldersFound(scanned);
+    
+    if (!removed.isEmpty()) {
+        emit foldersRemoved(removed);
+    }
+}
+
+void LocalLibraryScanner::updateFolder(const QString &folder) {
+    if (!QFileInfo(folder).isDir()) {
+        removeTree(folder);
+        return;
+    }
+    
+    // Only the entries of the directory itself are compared, unless subdirectories have been added or removed
+    const QStringList subfolders = scanFolder(folder);
+    const QStringList known = knownSubfolders(folder);
+    
+    foreach (const QString &subfolder, subfolders) {
+        if (!known.contains(subfolder)) {
+            scanTree(subfolder);
+        }
+    }
+    
+    foreach (const QString &subfolder, known) {
+        if (!subfolders.contains(subfolder)) {
+            removeTree(subfolder);
+        }
+    }
+}
+
+void LocalLibraryScanner::removeTree(const QString &root) {
+    const QStringList folders = knownFolders(root);
+    m_db.transaction();
+    
+    foreach (const QString &folder, folders) {
+        removeFolder(folder);
+    }
+    
+    commit();
+    
+    if (!folders.isEmpty()) {
+        emit foldersRemoved(folders);
+    }
+}
+
+QStringList LocalLibraryScanner::scanFolder(const QString &folder) {
+    struct Row {
+        qint64 id;
+        qint64 size;
+        qint64 lastModified;
+    };
+    
+    QHash<QString, Row> rows;
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT id, fileName, size, lastModified FROM localTracks WHERE folder = ?");
+    query.addBindValue(folder);
+    
+    if (query.exec()) {
+        while (query.next()) {
+            Row row;
+            row.id = query.value(0).toLongLong();
+            row.size = query.value(2).toLongLong();
+            row.lastModified = query.value(3).toLongLong();
+            rows[query.value(1).toString()] = row;
+        }
+    }
+    else {
+        qDebug() << "LocalLibraryScanner::scanFolder: database error:" << query.lastError().text();
+    }
+    
+    QDir dir(folder);
+    QList<PendingTrack> tracks;
+    
+    foreach (const QFileInfo &info, dir.entryInfoList(SUPPORTED_AUDIO_FORMATS, QDir::Files, QDir::Name)) {
+        if (isCancelled()) {
+            return QStringList();
+        }
+        
+        const QString fileName = info.absoluteFilePath();
+        const qint64 lastModified = info.lastModified().toMSecsSinceEpoch();
+        
+        if (rows.contains(fileName)) {
+            const Row row = rows.take(fileName);
+            
+            if ((row.size != info.size()) || (row.lastModified != lastModified)) {
+                tracks << PendingTrack(row.id, fileName, info.size(), lastModified);
+            }
+        }
+        else {
+            tracks << PendingTrack(-1, fileName, info.size(), lastModified);
+        }
+        
+        if (tracks.size() == WRITE_BATCH) {
+            writeTracks(tracks, folder);
+            tracks.clear();
+        }
+    }
+    
+    writeTracks(tracks, folder);
+    
+    if (isCancelled()) {
+        return QStringList();
+    }
+    
+    m_db.transaction();
+    
+    // Rows that are left are for files that have been deleted
+    foreach (const Row &row, rows) {
+        removeTrack(row.id);
+    }
+    
+    query.prepare("INSERT OR REPLACE INTO localFolders VALUES (?, ?)");
+    query.addBindValue(folder);
+    query.addBindValue(QFileInfo(folder).absolutePath());
+    
+    if (!query.exec()) {
+        qDebug() << "LocalLibraryScanner::scanFolder: database error:" << query.lastError().text();
+    }
+    
+    commit();
+    
+    // Symbolic links are not followed, so that a link to a parent directory can not cause a loop
+    QStringList subfolders;
+    
+    foreach (const QString &name, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDir::Name)) {
+        subfolders << dir.absoluteFilePath(name);
+    }
+    
+    return subfolders;
+}
+
+void LocalLibraryScanner::writeTracks(const QList<PendingTrack> &tracks, const QString &folder) {
+    if (tracks.isEmpty()) {
+        return;
+    }
+    
+    // The tags are read before the transaction is started, so that other connections are only locked out of the
+    // database while the rows are written
+    QList<QVariantMap> tags;
+    
+    foreach (const PendingTrack &track, tracks) {
+        if (isCancelled()) {
+            return;
+        }
+        
+        tags << TagReader::read(track.fileName);
+    }
+    
+    m_db.transaction();
+    
+    for (int i = 0; i < tracks.size(); i++) {
+        const PendingTrack &track = tracks.at(i);
+        writeTrack(track.id, track.fileName, folder, track.size, track.lastModified, tags.at(i));
+    }
+    
+    commit();
+}
+
+void LocalLibraryScanner::writeTrack(qint64 id, const QString &fileName, const QString &folder, qint64 size,
+                                     qint64 lastModified, const QVariantMap &tags) {
+    const QString title = tags.contains("title") ? tags.value("title").toString()
+                                                 : QFileInfo(fileName).completeBaseName();
+    const QString artistName = tags.value("artist").toString();
+    const QVariant artist = artistId(artistName);
+    QSqlQuery query(m_db);
+    
+    if (id < 0) {
+        query.prepare("INSERT INTO localTracks (fileName, folder, title, artistId, albumId, genre, year, duration, \
+size, lastModified) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        query.addBindValue(fileName);
+        query.addBindValue(folder);
+    }
+    else {
+        query.prepare("UPDATE localTracks SET title = ?, artistId = ?, albumId = ?, genre = ?, year = ?, duration = ?, \
+size = ?, lastModified = ? WHERE id = ?");
+    }
+    
+    query.addBindValue(title);
+    query.addBindValue(artist);
+    query.addBindValue(albumId(tags.value("album").toString(), artist));
+    query.addBindValue(tags.value("genre").toString());
+    query.addBindValue(tags.value("year").toString());
+    query.addBindValue(tags.value("duration").toLongLong());
+    query.addBindValue(size);
+    query.addBindValue(lastModified);
+    
+    if (id >= 0) {
+        query.addBindValue(id);
+        // The artist or album may no longer have any tracks
+        m_removed = true;
+    }
+    
+    if (!query.exec()) {
+        qDebug() << "LocalLibraryScanner::writeTrack: database error:" << query.lastError().text();
+        return;
+    }
+    
+    if (id < 0) {
+        id = query.lastInsertId().toLongLong();
+    }
+    
+    if (m_search) {
+        query.prepare("INSERT OR REPLACE INTO localTracksSearch (docid, title, artist) VALUES (?, ?, ?)");
+        query.addBindValue(id);
+        query.addBindValue(title);
+        query.addBindValue(artistName);
+        
+        if (!query.exec()) {
+            qDebug() << "LocalLibraryScanner::writeTrack: database error:" << query.lastError().text();
+        }
+    }
+    
+    m_writes++;
+}
+
+void LocalLibraryScanner::removeTrack(qint64 id) {
+    QSqlQuery query(m_db);
+    query.prepare("DELETE FROM localTracks WHERE id = ?");
+    query.addBindValue(id);
+    
+    if (!query.exec()) {
+        qDebug() << "LocalLibraryScanner::removeTrack: database error:" << query.lastError().text();
+    }
+    
+    if (m_search) {
+        query.prepare("DELETE FROM localTracksSearch WHERE docid = ?");
+        query.addBindValue(id);
+        
+        if (!query.exec()) {
+            qDebug() << "LocalLibraryScanner::removeTrack: database error:" << query.lastError().text();
+        }
+    }
+    
+    m_removed = true;
+    m_writes++;
+}
+
+void LocalLibraryScanner::removeFolder(const QString &folder) {
+    QSqlQuery query(m_db);
+    
+    if (m_search) {
+        query.prepare("DELETE FROM localTracksSearch WHERE docid IN (SELECT id FROM localTracks WHERE folder = ?)");
+        query.addBindValue(folder);
+        
+        if (!query.exec()) {
+            qDebug() << "LocalLibraryScanner::removeFolder: database error:" << query.lastError().text();
+        }
+    }
+    
+    query.prepare("DELETE FROM localTracks WHERE folder = ?");
+    query.addBindValue(folder);
+    
+    if (!query.exec()) {
+        qDebug() << "LocalLibraryScanner::removeFolder: database error:" << query.lastError().text();
+    }
+    
+    query.prepare("DELETE FROM localFolders WHERE path = ?");
+    query.addBindValue(folder);
+    
+    if (!query.exec()) {
+        qDebug() << "LocalLibraryScanner::removeFolder: database error:" << query.lastError().text();
+    }
+    
+    m_removed = true;
+}
+
+QStringList LocalLibraryScanner::knownFolders(const QString &root) {
+    const QString prefix = root + "/";
+    QStringList folders;
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT path FROM localFolders WHERE path = ? OR substr(path, 1, ?) = ?");
+    query.addBindValue(root);
+    query.addBindValue(prefix.size());
+    query.addBindValue(prefix);
+    
+    if (query.exec()) {
+        while (query.next()) {
+            folders << query.value(0).toString();
+        }
+    }
+    else {
+        qDebug() << "LocalLibraryScanner::knownFolders: database error:" << query.lastError().text();
+    }
+    
+    return folders;
+}
+
+QStringList LocalLibraryScanner::knownSubfolders(const QString &folder) {
+    QStringList folders;
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT path FROM localFolders WHERE parent = ?");
+    query.addBindValue(folder);
+    
+    if (query.exec()) {
+        while (query.next()) {
+            folders << query.value(0).toString();
+        }
+    }
+    else {
+        qDebug() << "LocalLibraryScanner::knownSubfolders: database error:" << query.lastError().text();
+    }
+    
+    return folders;
+}
+
+QVariant LocalLibraryScanner::artistId(const QString &name) {
+    if (name.isEmpty()) {
+        return QVariant(QVariant::LongLong);
+    }
+    
+    if (m_artists.contains(name)) {
+        return m_artists.value(name);
+    }
+    
+    QSqlQuery query(m_db);
+    query.prepare("SELECT id FROM localArtists WHERE name = ?");
+    query.addBindValue(name);
+    
+    if ((query.exec()) && (query.next())) {
+        m_artists[name] = query.value(0).toLongLong();
+        return m_artists.value(name);
+    }
+    
+    query.prepare("INSERT INTO localArtists (name) VALUES (?)");
+    query.addBindValue(name);
+    
+    if (!query.exec()) {
+        qDebug() << "LocalLibraryScanner::artistId: database error:" << query.lastError().text();
+        return QVariant(QVariant::LongLong);
+    }
+    
+    m_artists[name] = query.lastInsertId().toLongLong();
+    return m_artists.value(name);
+}
+
+QVariant LocalLibraryScanner::albumId(const QString &title, const QVariant &artistId) {
+    if (title.isEmpty()) {
+        return QVariant(QVariant::LongLong);
+    }
+    
+    const QString key = title + "\n" + artistId.toString();
+    
+    if (m_albums.contains(key)) {
+        return m_albums.value(key);
+    }
+    
+    QSqlQuery query(m_db);
+    query.prepare("SELECT id FROM localAlbums WHERE title = ? AND artistId IS ?");
+    query.addBindValue(title);
+    query.addBindValue(artistId);
+    
+    if ((query.exec()) && (query.next())) {
+        m_albums[key] = query.value(0).toLongLong();
+        return m_albums.value(key);
+    }
+    
+    query.prepare("INSERT INTO localAlbums (title, artistId) VALUES (?, ?)");
+    query.addBindValue(title);
+    query.addBindValue(artistId);
+    
+    if (!query.exec()) {
+        qDebug() << "LocalLibraryScanner::albumId: database error:" << query.lastError().text();
+        return QVariant(QVariant::LongLong);
+    }
+    
+    m_albums[key] = query.lastInsertId().toLongLong();
+    return m_albums.value(key);
+}
+
+void LocalLibraryScanner::removeOrphans() {
+    if (!m_removed) {
+        return;
+    }
+    
+    // Artists and albums are removed once they have no tracks
+    QSqlQuery query(m_db);
+    
+    if (!query.exec("DELETE FROM localAlbums WHERE id NOT IN (SELECT albumId FROM localTracks \
+WHERE albumId IS NOT NULL)")) {
+        qDebug() << "LocalLibraryScanner::removeOrphans: database error:" << query.lastError().text();
+    }
+    
+    if (!query.exec("DELETE FROM localArtists WHERE id NOT IN (SELECT artistId FROM localTracks \
+WHERE artistId IS NOT NULL)")) {
+        qDebug() << "LocalLibraryScanner::removeOrphans: database error:" << query.lastError().text();
+    }
+    
+    m_artists.clear();
+    m_albums.clear();
+}
+
+void LocalLibraryScanner::commit() {
+    if (!m_db.commit()) {
+        qDebug() << "LocalLibraryScanner::commit: database error:" << m_db.lastError().text();
+    }
+    
+    if (m_writes >= CHANGED_INTERVAL) {
+        m_writes = 0;
+        emit changed();
+    }
+}
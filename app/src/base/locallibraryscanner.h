@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOCALLIBRARYSCANNER_H
+#define LOCALLIBRARYSCANNER_H
+
+#include <QThread>
+#include <QHash>
+#include <QSqlDatabase>
+#include <QStringList>
+#include <QVariant>
+
+struct LocalLibraryJob {
+    enum Type {
+        Scan = 0, // Index a directory tree
+        Update,   // Reindex a directory whose entries have changed
+        Remove    // Remove a directory tree from the index
+    };
+    
+    LocalLibraryJob(Type t, const QString &f) : type(t), folder(f) {}
+    
+    bool operator==(const LocalLibraryJob &other) const { return (type == other.type) && (folder == other.folder); }
+    
+    Type type;
+    QString folder;
+};
+
+/*
+ * Updates the local library tables on a worker thread, using its own database connection. Files are only read
+ * again when their size or modification time has changed. Tags are read outside of any transaction and changes
+ * are committed in short batches, so that other connections are never locked out of the database for long.
+ * changed() is emitted after every few hundred changes, and when each job is finished.
+ */
+class LocalLibraryScanner : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit LocalLibraryScanner(const QString &databaseName, const QList<LocalLibraryJob> &jobs,
+                                 QObject *parent = 0);
+    
+    void cancel();
+    bool isCancelled() const;
+
+Q_SIGNALS:
+    void changed();
+    void foldersFound(const QStringList &folders);
+    void foldersRemoved(const QStringList &folders);
+    
+protected:
+    void run();
+    
+private:
+    void scanTree(const QString &root);
+    void updateFolder(const QString &folder);
+    void removeTree(const QString &root);
+    
+    QStringList scanFolder(const QString &folder);
+    struct PendingTrack {
+        PendingTrack(qint64 i, const QString &f, qint64 s, qint64 m) : id(i), fileName(f), size(s), lastModified(m) {}
+        
+        qint64 id;
+        QString fileName;
+        qint64 size;
+        qint64 lastModified;
+    };
+    
+    void writeTracks(const QList<PendingTrack> &tracks, const QString &folder);
+    void writeTrack(qint64 id, const QString &fileName, const QString &folder, qint64 size, qint64 lastModified,
+                    const QVariantMap &tags);
+    void removeTrack(qint64 id);
+    void removeFolder(const QString &folder);
+    
+    QStringList knownFolders(const QString &root);
+    QStringList knownSubfolders(const QString &folder);
+    
+    QVariant artistId(const QString &name);
+    QVariant albumId(const QString &title, const QVariant &artistId);
+    
+    void removeOrphans();
+    void commit();
+    
+    QString m_databaseName;
+    QList<LocalLibraryJob> m_jobs;
+    
+    QSqlDatabase m_db;
+    bool m_search;
+    
+    QHash<QString, qint64> m_artists;
+    QHash<QString, qint64> m_albums;
+    
+    int m_writes;
+    bool m_removed;
+    
+    QAtomicInt m_cancelled;
+};
+
+#endif // LOCALLIBRARYSCANNER_H
@@ -27,6 +27,11 @@ static const QStringList PROPERTY_NAMES = QStringList() << QDocumentGallery::art
                                                         << QDocumentGallery::fileSize << QDocumentGallery::genre
                                                         << QDocumentGallery::lastModified << QDocumentGallery::playCount
                                                         << QDocumentGallery::title;
+#else
+#include "tagreader.h"
+#include "utils.h"
+#include <QDateTime>
+#include <QThreadPool>
 #endif
 
 LocalTrack::LocalTrack(QObject *parent) :
@@ -56,15 +61,52 @@ LocalTrack::LocalTrack(LocalTrack *track, QObject *parent) :
 {
 }
 
+LocalTrack::LocalTrack(const TrackRecord &record, QObject *parent) :
+    MKTrack(record, parent)
+#ifdef FETCH_LOCAL_METADATA
+    ,m_request(0)
+#endif
+{
+    setDownloadable(false);
+    loadMetaData(record.url());
+}
+
+TrackRecord LocalTrack::toRecord(const QUrl &url) {
+    TrackRecord record;
+    record.setDownloadable(false);
+    record.setFormat(url.path().section('.', -1).toUpper());
+    record.setLocal(true);
+    record.setStreamUrl(url);
+    record.setTitle(url.path().section('/', -1).section('.', 0, -2));
+    record.setUrl(url);
+    return record;
+}
+
+TrackRecord LocalTrack::record() const {
+    TrackRecord record = MKTrack::record();
+    record.setLocal(true);
+    return record;
+}
+
 void LocalTrack::loadTrack(const QUrl &url) {
     setFormat(url.path().section('.', -1).toUpper());
     setStreamUrl(url);
     setTitle(url.path().section('/', -1).section('.', 0, -2));
     setUrl(url);
+    loadMetaData(url);
+}
+
+void LocalTrack::loadMetaData(const QUrl &url) {
 #ifdef FETCH_LOCAL_METADATA
     initRequest();
     m_request->setItemId("localtagfs::music/songs/" + url.path().replace("/", "%2F"));
     m_request->execute();
+#else
+    if (Utils::isLocalFile(url)) {
+        TagReaderTask *task = new TagReaderTask(url.scheme() == "file" ? url.toLocalFile() : url.toString());
+        connect(task, SIGNAL(finished(QVariantMap)), this, SLOT(onTagsRead(QVariantMap)));
+        QThreadPool::globalInstance()->start(task);
+    }
 #endif
 }
 
@@ -104,4 +146,25 @@ void LocalTrack::onRequestError(int error, const QString &errorString) {
     qDebug() << "LocalTrack::onRequestError" << m_request->itemId() << error << errorString;
 }
 #endif
+#else
+void LocalTrack::onTagsRead(const QVariantMap &tags) {
+    if (tags.contains("artist")) {
+        setArtist(tags.value("artist").toString());
+    }
+    
+    if (tags.contains("duration")) {
+        setDuration(tags.value("duration").toLongLong());
+    }
+    
+    if (tags.contains("genre")) {
+        setGenre(tags.value("genre").toString());
+    }
+    
+    if (tags.contains("title")) {
+        setTitle(tags.value("title").toString());
+    }
+    
+    setDate(tags.value("lastModified").toDateTime().toString("dd MMM yyyy"));
+    setSize(tags.value("size").toLongLong());
+}
 #endif
@@ -40,8 +40,16 @@ public:
     explicit LocalTrack(QObject *parent = 0);
     explicit LocalTrack(const QUrl &url, QObject *parent = 0);
     explicit LocalTrack(LocalTrack *track, QObject *parent = 0);
+    explicit LocalTrack(const TrackRecord &record, QObject *parent = 0);
+    
+    static TrackRecord toRecord(const QUrl &url);
+    
+    TrackRecord record() const;
 
     Q_INVOKABLE virtual void loadTrack(const QUrl &url);
+    
+private:
+    void loadMetaData(const QUrl &url);
 
 #ifdef FETCH_LOCAL_METADATA
 private Q_SLOTS:
@@ -54,6 +62,9 @@ private:
     void initRequest();
     
     QGalleryItemRequest *m_request;
+#else
+private Q_SLOTS:
+    void onTagsRead(const QVariantMap &tags);
 #endif
 };
 
@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "localtrackmodel.h"
+#include "database.h"
+#include "locallibrary.h"
+#include "roletable.h"
+#include <QDateTime>
+#include <QFileInfo>
+
+static const char* const ROLE_NAMES[] = {
+    "artist",
+    "artistId",
+    "date",
+    "duration",
+    "durationString",
+    "format",
+    "genre",
+    "id",
+    "size",
+    "sizeString",
+    "streamUrl",
+    "thumbnailUrl",
+    "title",
+    "url",
+    0
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(RoleTable, roleTable, (LocalTrackModel::ArtistRole, ROLE_NAMES))
+
+static QVariant trackData(const LocalTrack *track, int role) {
+    switch (role) {
+    case LocalTrackModel::ArtistRole:
+        return track->artist();
+    case LocalTrackModel::ArtistIdRole:
+        return track->artistId();
+    case LocalTrackModel::DateRole:
+        return track->date();
+    case LocalTrackModel::DurationRole:
+        return track->duration();
+    case LocalTrackModel::DurationStringRole:
+        return track->durationString();
+    case LocalTrackModel::FormatRole:
+        return track->format();
+    case LocalTrackModel::GenreRole:
+        return track->genre();
+    case LocalTrackModel::IdRole:
+        return track->id();
+    case LocalTrackModel::SizeRole:
+        return track->size();
+    case LocalTrackModel::SizeStringRole:
+        return track->sizeString();
+    case LocalTrackModel::StreamUrlRole:
+        return track->streamUrl();
+    case LocalTrackModel::ThumbnailUrlRole:
+        return track->thumbnailUrl();
+    case LocalTrackModel::TitleRole:
+        return track->title();
+    case LocalTrackModel::UrlRole:
+        return track->url();
+    default:
+        return QVariant();
+    }
+}
+
+// The number of tracks fetched by each query
+static const int PAGE_SIZE = 100;
+
+LocalTrackModel::LocalTrackModel(QObject *parent) :
+    QAbstractListModel(parent),
+    m_moreResults(false)
+{
+#if QT_VERSION < 0x050000
+    setRoleNames(roleTable()->roleNames());
+#endif
+    if (LocalLibrary *library = LocalLibrary::instance()) {
+        connect(library, SIGNAL(changed()), this, SLOT(refresh()));
+    }
+}
+
+#if QT_VERSION >=0x050000
+QHash<int, QByteArray> LocalTrackModel::roleNames() const {
+    return roleTable()->roleNames();
+}
+#endif
+
+int LocalTrackModel::rowCount(const QModelIndex &) const {
+    return m_items.size();
+}
+
+bool LocalTrackModel::canFetchMore(const QModelIndex &) const {
+    return m_moreResults;
+}
+
+void LocalTrackModel::fetchMore(const QModelIndex &) {
+    if (!canFetchMore()) {
+        return;
+    }
+    
+    QStringList conditions;
+    QVariantList values;
+    addFilterConditions(&conditions, &values);
+    
+    if (!m_items.isEmpty()) {
+        // Continue after the last track fetched, rather than skipping rows with an offset
+        const LocalTrack *last = m_items.last();
+        conditions << "(t.title > ? OR (t.title = ? AND t.id > ?))";
+        values << last->title() << last->title() << last->id().toLongLong();
+    }
+    
+    bool ok = false;
+    const QList<LocalTrack*> tracks = queryTracks(conditions, values, PAGE_SIZE, &ok);
+    m_moreResults = (ok) && (tracks.size() == PAGE_SIZE);
+    
+    if (!tracks.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + tracks.size() - 1);
+        m_items << tracks;
+        endInsertRows();
+    }
+    
+    emit countChanged(rowCount());
+}
+
+QVariant LocalTrackModel::data(const QModelIndex &index, int role) const {
+    if (const LocalTrack *track = get(index.row())) {
+        return trackData(track, role);
+    }
+    
+    return QVariant();
+}
+
+QMap<int, QVariant> LocalTrackModel::itemData(const QModelIndex &index) const {
+    QMap<int, QVariant> map;
+    
+    if ((index.row() >= 0) && (index.row() < rowCount())) {
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[role] = data(index, role);
+        }
+    }
+    
+    return map;
+}
+
+QVariant LocalTrackModel::data(int row, const QByteArray &role) const {
+    return data(index(row), roleTable()->role(role));
+}
+
+QVariantMap LocalTrackModel::itemData(int row) const {
+    QVariantMap map;
+    
+    if ((row >= 0) && (row < rowCount())) {
+        const QModelIndex idx = index(row);
+        
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[roleTable()->name(role)] = data(idx, role);
+        }
+    }
+    
+    return map;
+}
+
+LocalTrack* LocalTrackModel::get(int row) const {
+    if ((row >= 0) && (row < m_items.size())) {
+        return m_items.at(row);
+    }
+    
+    return 0;
+}
+
+void LocalTrackModel::list(const QVariantMap &filters) {
+    m_filters = filters;
+    reload();
+}
+
+void LocalTrackModel::clear() {
+    if (!m_items.isEmpty()) {
+        beginResetModel();
+        qDeleteAll(m_items);
+        m_items.clear();
+        m_moreResults = false;
+        endResetModel();
+        emit countChanged(rowCount());
+    }
+}
+
+void LocalTrackModel::reload() {
+    clear();
+    m_moreResults = true;
+    fetchMore();
+}
+
+void LocalTrackModel::refresh() {
+    if (m_items.isEmpty()) {
+        reload();
+        return;
+    }
+    
+    QStringList conditions;
+    QVariantList values;
+    addFilterConditions(&conditions, &values);
+    
+    if (m_moreResults) {
+        // Rows after the last track fetched are read by fetchMore() as usual
+        const LocalTrack *last = m_items.last();
+        conditions << "(t.title < ? OR (t.title = ? AND t.id <= ?))";
+        values << last->title() << last->title() << last->id().toLongLong();
+    }
+    
+    bool ok = false;
+    QList<LocalTrack*> tracks = queryTracks(conditions, values, -1, &ok);
+    
+    if (!ok) {
+        return;
+    }
+    
+    QHash<QString, LocalTrack*> current;
+    
+    foreach (LocalTrack *track, tracks) {
+        current[track->id()] = track;
+    }
+    
+    // Remove the rows that are gone or whose position may have changed. The remaining rows are then in the
+    // same order as the new rows, so the new rows can be inserted around them.
+    for (int i = m_items.size() - 1; i >= 0; i--) {
+        const LocalTrack *track = current.value(m_items.at(i)->id());
+        
+        if ((!track) || (track->title() != m_items.at(i)->title())) {
+            beginRemoveRows(QModelIndex(), i, i);
+            delete m_items.takeAt(i);
+            endRemoveRows();
+        }
+    }
+    
+    for (int i = 0; i < tracks.size(); i++) {
+        LocalTrack *track = tracks.at(i);
+        
+        if ((i < m_items.size()) && (m_items.at(i)->id() == track->id())) {
+            bool changed = false;
+            
+            for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+                if (trackData(m_items.at(i), role) != trackData(track, role)) {
+                    changed = true;
+                    break;
+                }
+            }
+            
+            if (changed) {
+                m_items.at(i)->MKTrack::loadTrack(track);
+                emit dataChanged(index(i), index(i));
+            }
+            
+            delete track;
+        }
+        else {
+            beginInsertRows(QModelIndex(), i, i);
+            m_items.insert(i, track);
+            endInsertRows();
+        }
+    }
+    
+    emit countChanged(rowCount());
+}
+
+void LocalTrackModel::addFilterConditions(QStringList *conditions, QVariantList *values) const {
+    if (m_filters.contains("artistId")) {
+        *conditions << "t.artistId = ?";
+        *values << m_filters.value("artistId");
+    }
+    
+    if (m_filters.contains("albumId")) {
+        *conditions << "t.albumId = ?";
+        *values << m_filters.value("albumId");
+    }
+    
+    if (m_filters.contains("folder")) {
+        *conditions << "t.folder = ?";
+        *values << m_filters.value("folder");
+    }
+    
+    const QString search = m_filters.value("search").toString().trimmed();
+    
+    if (!search.isEmpty()) {
+        if (hasSearchIndex()) {
+            *conditions << "t.id IN (SELECT docid FROM localTracksSearch WHERE localTracksSearch MATCH ?)";
+            *values << searchQuery(search);
+        }
+        else {
+            *conditions << "(t.title LIKE ? OR a.name LIKE ?)";
+            *values << QString("%" + search + "%") << QString("%" + search + "%");
+        }
+    }
+}
+
+QList<LocalTrack*> LocalTrackModel::queryTracks(const QStringList &conditions, QVariantList values, int limit,
+                                                bool *ok) {
+    QString statement("SELECT t.id, t.fileName, t.title, t.artistId, a.name, t.genre, t.duration, t.size, \
+t.lastModified FROM localTracks t LEFT JOIN localArtists a ON a.id = t.artistId");
+    
+    if (!conditions.isEmpty()) {
+        statement.append(" WHERE " + conditions.join(" AND "));
+    }
+    
+    statement.append(" ORDER BY t.title, t.id");
+    
+    if (limit >= 0) {
+        statement.append(" LIMIT ?");
+        values << limit;
+    }
+    
+    QSqlQuery query(getDatabase());
+    query.setForwardOnly(true);
+    query.prepare(statement);
+    
+    foreach (const QVariant &value, values) {
+        query.addBindValue(value);
+    }
+    
+    QList<LocalTrack*> tracks;
+    *ok = query.exec();
+    
+    if (!*ok) {
+        qDebug() << "LocalTrackModel::queryTracks: database error:" << query.lastError().text();
+        return tracks;
+    }
+    
+    while (query.next()) {
+        const QString fileName = query.value(1).toString();
+        const QUrl url = QUrl::fromLocalFile(fileName);
+        LocalTrack *track = new LocalTrack(this);
+        track->setArtist(query.value(4).toString());
+        track->setArtistId(query.value(3).toString());
+        track->setDate(QDateTime::fromMSecsSinceEpoch(query.value(8).toLongLong()).toString("dd MMM yyyy"));
+        track->setDuration(query.value(6).toLongLong());
+        track->setFormat(QFileInfo(fileName).suffix().toUpper());
+        track->setGenre(query.value(5).toString());
+        track->setId(query.value(0).toString());
+        track->setSize(query.value(7).toLongLong());
+        track->setStreamUrl(url);
+        track->setTitle(query.value(2).toString());
+        track->setUrl(url);
+        tracks << track;
+    }
+    
+    return tracks;
+}
+
+bool LocalTrackModel::hasSearchIndex() {
+    // The full text search module may not be available in the SQLite library
+    static const bool search = getDatabase().tables().contains("localTracksSearch");
+    return search;
+}
+
+QString LocalTrackModel::searchQuery(const QString &text) {
+    // Each word matches words in the title or artist that begin with it
+    QStringList terms = text.split(QRegExp("\\W+"), QString::SkipEmptyParts);
+    
+    for (int i = 0; i < terms.size(); i++) {
+        terms[i].append('*');
+    }
+    
+    return terms.join(" ");
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOCALTRACKMODEL_H
+#define LOCALTRACKMODEL_H
+
+#include "localtrack.h"
+#include <QAbstractListModel>
+#include <QStringList>
+
+/*
+ * Lists the tracks of the local library, ordered by title. The filters are "search", which matches words in
+ * the title and artist, "artistId", "albumId" and "folder". Tracks are fetched a page at a time, starting
+ * after the last track fetched, so that each query only reads the rows that it returns.
+ *
+ * When the library changes, the rows already fetched are queried again, and only the rows that were added,
+ * removed or changed are updated, so that the view keeps its position.
+ */
+class LocalTrackModel : public QAbstractListModel
+{
+    Q_OBJECT
+    
+    Q_PROPERTY(bool canFetchMore READ canFetchMore NOTIFY countChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    
+public:
+    enum Roles {
+        ArtistRole = Qt::UserRole + 1,
+        ArtistIdRole,
+        DateRole,
+        DurationRole,
+        DurationStringRole,
+        FormatRole,
+        GenreRole,
+        IdRole,
+        SizeRole,
+        SizeStringRole,
+        StreamUrlRole,
+        ThumbnailUrlRole,
+        TitleRole,
+        UrlRole
+    };
+    
+    explicit LocalTrackModel(QObject *parent = 0);
+    
+#if QT_VERSION >= 0x050000
+    QHash<int, QByteArray> roleNames() const;
+#endif
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    
+    bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
+    Q_INVOKABLE void fetchMore(const QModelIndex &parent = QModelIndex());
+    
+    QVariant data(const QModelIndex &index, int role) const;
+    QMap<int, QVariant> itemData(const QModelIndex &index) const;
+    
+    Q_INVOKABLE QVariant data(int row, const QByteArray &role) const;
+    Q_INVOKABLE QVariantMap itemData(int row) const;
+    
+    Q_INVOKABLE LocalTrack* get(int row) const;
+    
+    Q_INVOKABLE void list(const QVariantMap &filters = QVariantMap());
+
+public Q_SLOTS:
+    void clear();
+    void reload();
+    
+private Q_SLOTS:
+    void refresh();
+    
+Q_SIGNALS:
+    void countChanged(int c);
+    
+private:
+    static bool hasSearchIndex();
+    static QString searchQuery(const QString &text);
+    
+    void addFilterConditions(QStringList *conditions, QVariantList *values) const;
+    QList<LocalTrack*> queryTracks(const QStringList &conditions, QVariantList values, int limit, bool *ok);
+    
+    QVariantMap m_filters;
+    bool m_moreResults;
+    
+    QList<LocalTrack*> m_items;
+};
+
+#endif // LOCALTRACKMODEL_H
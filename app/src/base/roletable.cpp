@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "roletable.h"
+
+RoleTable::RoleTable(int firstRole, const char* const *names) :
+    m_firstRole(firstRole)
+{
+    for (int i = 0; names[i]; i++) {
+        const QByteArray name(names[i]);
+        m_names << name;
+        m_roles[name] = firstRole + i;
+        m_roleNames[firstRole + i] = name;
+    }
+}
+
+int RoleTable::firstRole() const {
+    return m_firstRole;
+}
+
+int RoleTable::lastRole() const {
+    return m_firstRole + m_names.size() - 1;
+}
+
+QByteArray RoleTable::name(int role) const {
+    const int i = role - m_firstRole;
+    
+    if ((i >= 0) && (i < m_names.size())) {
+        return m_names.at(i);
+    }
+    
+    return QByteArray();
+}
+
+int RoleTable::role(const QByteArray &name) const {
+    return m_roles.value(name, -1);
+}
+
+QHash<int, QByteArray> RoleTable::roleNames() const {
+    return m_roleNames;
+}
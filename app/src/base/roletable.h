@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROLETABLE_H
+#define ROLETABLE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+/*
+ * The role names of a list model, built once and shared by every instance of the model.
+ *
+ * The names are given in the order of the model's Roles enum, starting with firstRole and terminated by a null
+ * pointer, so that a role is converted to a name by indexing into the table. Models read their values with a
+ * switch over the role, and only the string-keyed data(int, QByteArray) used by QML needs role(name).
+ */
+class RoleTable
+{
+
+public:
+    RoleTable(int firstRole, const char* const *names);
+    
+    int firstRole() const;
+    int lastRole() const;
+    
+    QByteArray name(int role) const;
+    int role(const QByteArray &name) const;
+    
+    QHash<int, QByteArray> roleNames() const;
+
+private:
+    int m_firstRole;
+    
+    QList<QByteArray> m_names;
+    QHash<QByteArray, int> m_roles;
+    QHash<int, QByteArray> m_roleNames;
+};
+
+#endif // ROLETABLE_H
@@ -213,6 +213,28 @@ void Settings::setDownloadPath(const QString &path) {
     }
 }
 
+int Settings::audioCacheSize() const {
+    return qMax(0, value("Cache/audioCacheSize", DEFAULT_AUDIO_CACHE_SIZE).toInt());
+}
+
+void Settings::setAudioCacheSize(int size) {
+    if (size != audioCacheSize()) {
+        setValue("Cache/audioCacheSize", qMax(0, size));
+        emit audioCacheSizeChanged();
+    }
+}
+
+int Settings::imageCacheSize() const {
+    return qMax(0, value("Cache/imageCacheSize", DEFAULT_IMAGE_CACHE_SIZE).toInt());
+}
+
+void Settings::setImageCacheSize(int size) {
+    if (size != imageCacheSize()) {
+        setValue("Cache/imageCacheSize", qMax(0, size));
+        emit imageCacheSizeChanged();
+    }
+}
+
 int Settings::maximumConcurrentTransfers() const {
     return qBound(1, value("Transfers/maximumConcurrentTransfers", 1).toInt(), MAX_CONCURRENT_TRANSFERS);
 }
@@ -42,6 +42,8 @@ class Settings : public QObject
                NOTIFY clipboardMonitorEnabledChanged)
     Q_PROPERTY(QString currentService READ currentService WRITE setCurrentService NOTIFY currentServiceChanged)
     Q_PROPERTY(QString downloadPath READ downloadPath WRITE setDownloadPath NOTIFY downloadPathChanged)
+    Q_PROPERTY(int audioCacheSize READ audioCacheSize WRITE setAudioCacheSize NOTIFY audioCacheSizeChanged)
+    Q_PROPERTY(int imageCacheSize READ imageCacheSize WRITE setImageCacheSize NOTIFY imageCacheSizeChanged)
     Q_PROPERTY(int maximumConcurrentTransfers READ maximumConcurrentTransfers WRITE setMaximumConcurrentTransfers
                NOTIFY maximumConcurrentTransfersChanged)
     Q_PROPERTY(bool networkProxyEnabled READ networkProxyEnabled WRITE setNetworkProxyEnabled
@@ -86,6 +88,9 @@ public:
         
     QString downloadPath() const;
     Q_INVOKABLE QString downloadPath(const QString &category) const;
+    
+    int audioCacheSize() const;
+    int imageCacheSize() const;
             
     int maximumConcurrentTransfers() const;
     
@@ -124,6 +129,9 @@ public Q_SLOTS:
     void setDefaultSearchType(const QString &service, const QString &type);
         
     void setDownloadPath(const QString &path);
+    
+    void setAudioCacheSize(int size);
+    void setImageCacheSize(int size);
         
     void setMaximumConcurrentTransfers(int maximum);
     
@@ -157,6 +165,8 @@ Q_SIGNALS:
     void defaultSearchTypeChanged();
     void downloadFormatsChanged();
     void downloadPathChanged();
+    void audioCacheSizeChanged();
+    void imageCacheSizeChanged();
     void maximumConcurrentTransfersChanged();
     void networkProxyChanged();
     void playbackFormatsChanged();
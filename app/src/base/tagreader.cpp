@@ -0,0 +1,791 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tagreader.h"
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QVector>
+#include <QtEndian>
+#include <string.h>
+#ifdef MUSIKLOUD_DEBUG
+#include <QDebug>
+#endif
+
+// The standard ID3v1 genres, which are also referred to by number in ID3v2 and MP4 tags
+static const char* const GENRES[] = {
+    "Blues", "Classic Rock", "Country", "Dance", "Disco", "Funk", "Grunge", "Hip-Hop", "Jazz", "Metal", "New Age",
+    "Oldies", "Other", "Pop", "R&B", "Rap", "Reggae", "Rock", "Techno", "Industrial", "Alternative", "Ska",
+    "Death Metal", "Pranks", "Soundtrack", "Euro-Techno", "Ambient", "Trip-Hop", "Vocal", "Jazz+Funk", "Fusion",
+    "Trance", "Classical", "Instrumental", "Acid", "House", "Game", "Sound Clip", "Gospel", "Noise", "AlternRock",
+    "Bass", "Soul", "Punk", "Space", "Meditative", "Instrumental Pop", "Instrumental Rock", "Ethnic", "Gothic",
+    "Darkwave", "Techno-Industrial", "Electronic", "Pop-Folk", "Eurodance", "Dream", "Southern Rock", "Comedy",
+    "Cult", "Gangsta", "Top 40", "Christian Rap", "Pop/Funk", "Jungle", "Native American", "Cabaret", "New Wave",
+    "Psychedelic", "Rave", "Showtunes", "Trailer", "Lo-Fi", "Tribal", "Acid Punk", "Acid Jazz", "Polka", "Retro",
+    "Musical", "Rock & Roll", "Hard Rock"
+};
+
+static const int GENRE_COUNT = sizeof(GENRES) / sizeof(GENRES[0]);
+
+// Bit rates in kbps, indexed by MPEG version (1, or 2 and 2.5), layer and bit rate index
+static const int BIT_RATES[2][3][15] = {
+    {
+        { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+        { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384 },
+        { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 }
+    },
+    {
+        { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 },
+        { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },
+        { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 }
+    }
+};
+
+static const int SAMPLE_RATES[3] = { 44100, 48000, 32000 };
+
+// The first MPEG frame header is only searched for this far after the ID3v2 tag
+static const qint64 MAX_FRAME_SEARCH = 64 * 1024;
+
+// The last Ogg page, which holds the length of the stream, is only searched for this far from the end
+static const qint64 MAX_PAGE_SEARCH = 64 * 1024;
+
+// Ogg comment packets larger than this, usually because of embedded pictures, are truncated
+static const int MAX_COMMENT_SIZE = 1024 * 1024;
+
+// The ID3v2 and FLAC picture type of the front cover, which is preferred to any other embedded picture
+static const int FRONT_COVER = 3;
+
+static void insertText(QVariantMap &tags, const QString &key, const QString &text) {
+    // Values that have already been read from a more detailed tag are kept
+    if ((!text.isEmpty()) && (!tags.contains(key))) {
+        tags[key] = text;
+    }
+}
+
+static void insertDuration(QVariantMap &tags, qint64 duration) {
+    if ((duration > 0) && (!tags.contains("duration"))) {
+        tags["duration"] = duration;
+    }
+}
+
+static QString genreName(int index) {
+    return (index >= 0) && (index < GENRE_COUNT) ? QString::fromLatin1(GENRES[index]) : QString();
+}
+
+static void insertPicture(QVariantMap &tags, const QByteArray &picture, int type) {
+    if ((!picture.isEmpty()) && ((type == FRONT_COVER) || (!tags.contains("picture")))) {
+        tags["picture"] = picture;
+    }
+}
+
+static qint64 synchsafe(const uchar *data) {
+    return (qint64(data[0] & 0x7f) << 21) | ((data[1] & 0x7f) << 14) | ((data[2] & 0x7f) << 7) | (data[3] & 0x7f);
+}
+
+static QString id3Text(const uchar *data, qint64 size) {
+    if (size < 1) {
+        return QString();
+    }
+    
+    const uchar encoding = data[0];
+    data++;
+    size--;
+    QString text;
+    
+    switch (encoding) {
+    case 1:
+    case 2: {
+        // UTF-16 with a byte order mark, or big endian UTF-16 without one
+        bool bigEndian = encoding == 2;
+        
+        if ((encoding == 1) && (size >= 2) && (((data[0] == 0xfe) && (data[1] == 0xff))
+                                               || ((data[0] == 0xff) && (data[1] == 0xfe)))) {
+            bigEndian = data[0] == 0xfe;
+            data += 2;
+            size -= 2;
+        }
+        
+        QVector<ushort> utf16(size / 2);
+        
+        for (int i = 0; i < utf16.size(); i++) {
+            utf16[i] = bigEndian ? qFromBigEndian<quint16>(data + i * 2) : qFromLittleEndian<quint16>(data + i * 2);
+        }
+        
+        text = QString::fromUtf16(utf16.constData(), utf16.size());
+        break;
+    }
+    case 3:
+        text = QString::fromUtf8(reinterpret_cast<const char*>(data), size);
+        break;
+    default:
+        text = QString::fromLatin1(reinterpret_cast<const char*>(data), size);
+        break;
+    }
+    
+    // Values are null terminated or padded, and only the first of a list of values is used
+    const int nul = text.indexOf(QChar(0));
+    
+    if (nul >= 0) {
+        text.truncate(nul);
+    }
+    
+    return text.trimmed();
+}
+
+static QString id3Genre(const QString &genre) {
+    // ID3v2.3 refers to an ID3v1 genre as "(n)", optionally followed by a refinement, and ID3v2.4 as "n"
+    QString index = genre;
+    
+    if (genre.startsWith('(')) {
+        const int end = genre.indexOf(')');
+        
+        if (end > 1) {
+            const QString refinement = genre.mid(end + 1).trimmed();
+            
+            if (!refinement.isEmpty()) {
+                return refinement;
+            }
+            
+            index = genre.mid(1, end - 1);
+        }
+    }
+    
+    bool ok;
+    const int i = index.toInt(&ok);
+    return ok ? genreName(i) : genre;
+}
+
+// Returns the image data of an APIC frame, or a PIC frame in ID3v2.2, and sets type to its picture type
+static QByteArray id3Picture(const uchar *data, qint64 size, bool v22, int &type) {
+    if (size < 4) {
+        return QByteArray();
+    }
+    
+    const int encoding = data[0];
+    qint64 pos = 1;
+    
+    if (v22) {
+        // The image format
+        pos += 3;
+    }
+    else {
+        // The MIME type
+        while ((pos < size) && (data[pos] != 0)) {
+            pos++;
+        }
+        
+        pos++;
+    }
+    
+    if (pos >= size) {
+        return QByteArray();
+    }
+    
+    type = data[pos++];
+    
+    // The description, terminated by a null character of its encoding
+    if ((encoding == 1) || (encoding == 2)) {
+        while ((pos + 1 < size) && ((data[pos] != 0) || (data[pos + 1] != 0))) {
+            pos += 2;
+        }
+        
+        pos += 2;
+    }
+    else {
+        while ((pos < size) && (data[pos] != 0)) {
+            pos++;
+        }
+        
+        pos++;
+    }
+    
+    if (pos >= size) {
+        return QByteArray();
+    }
+    
+    return QByteArray(reinterpret_cast<const char*>(data + pos), size - pos);
+}
+
+// Returns the size of the ID3v2 tag at the start of the file, or 0 if there is none
+static qint64 readId3v2(const uchar *data, qint64 size, bool picture, QVariantMap &tags) {
+    if ((size < 10) || (memcmp(data, "ID3", 3) != 0)) {
+        return 0;
+    }
+    
+    const int version = data[3];
+    const int flags = data[5];
+    const qint64 end = qMin(size, synchsafe(data + 6) + 10);
+    const qint64 tagSize = synchsafe(data + 6) + ((flags & 0x10) ? 20 : 10);
+    
+    // Tags that are unsynchronised as a whole are not decoded
+    if ((version < 2) || (version > 4) || ((version < 4) && (flags & 0x80))) {
+        return tagSize;
+    }
+    
+    qint64 pos = 10;
+    
+    if ((version > 2) && (flags & 0x40)) {
+        // Skip the extended header
+        if (pos + 4 > end) {
+            return tagSize;
+        }
+        
+        pos += version == 3 ? qint64(qFromBigEndian<quint32>(data + pos)) + 4 : synchsafe(data + pos);
+    }
+    
+    const int idSize = version == 2 ? 3 : 4;
+    const int headerSize = version == 2 ? 6 : 10;
+    
+    while (pos + headerSize <= end) {
+        const uchar *frame = data + pos;
+        
+        if (frame[0] == 0) {
+            // Padding
+            break;
+        }
+        
+        const QByteArray id(reinterpret_cast<const char*>(frame), idSize);
+        qint64 frameSize;
+        bool encoded = false;
+        
+        if (version == 2) {
+            frameSize = (frame[3] << 16) | (frame[4] << 8) | frame[5];
+        }
+        else if (version == 3) {
+            frameSize = qFromBigEndian<quint32>(frame + 4);
+            encoded = (frame[9] & 0xc0) != 0;
+        }
+        else {
+            frameSize = synchsafe(frame + 4);
+            encoded = (frame[9] & 0x0e) != 0;
+        }
+        
+        pos += headerSize;
+        
+        if ((frameSize <= 0) || (pos + frameSize > end)) {
+            break;
+        }
+        
+        // Compressed, encrypted and unsynchronised frames are skipped
+        if ((!encoded) && ((id.startsWith('T')) || ((picture) && ((id == "APIC") || (id == "PIC"))))) {
+            const uchar *value = data + pos;
+            qint64 valueSize = frameSize;
+            
+            if ((version == 4) && (frame[9] & 0x01) && (valueSize > 4)) {
+                // Skip the data length indicator
+                value += 4;
+                valueSize -= 4;
+            }
+            
+            if ((id == "APIC") || (id == "PIC")) {
+                int type = 0;
+                const QByteArray image = id3Picture(value, valueSize, version == 2, type);
+                insertPicture(tags, image, type);
+            }
+            else if ((id == "TIT2") || (id == "TT2")) {
+                insertText(tags, "title", id3Text(value, valueSize));
+            }
+            else if ((id == "TPE1") || (id == "TP1")) {
+                insertText(tags, "artist", id3Text(value, valueSize));
+            }
+            else if ((id == "TALB") || (id == "TAL")) {
+                insertText(tags, "album", id3Text(value, valueSize));
+            }
+            else if ((id == "TCON") || (id == "TCO")) {
+                insertText(tags, "genre", id3Genre(id3Text(value, valueSize)));
+            }
+            else if ((id == "TYER") || (id == "TYE") || (id == "TDRC")) {
+                insertText(tags, "year", id3Text(value, valueSize).left(4));
+            }
+            else if ((id == "TLEN") || (id == "TLE")) {
+                insertDuration(tags, id3Text(value, valueSize).toLongLong());
+            }
+        }
+        
+        pos += frameSize;
+    }
+    
+    return tagSize;
+}
+
+static QString id3v1Text(const uchar *data, int size) {
+    const char *text = reinterpret_cast<const char*>(data);
+    return QString::fromLatin1(text, qstrnlen(text, size)).trimmed();
+}
+
+static bool readId3v1(const uchar *data, qint64 size, QVariantMap &tags) {
+    if (size < 128) {
+        return false;
+    }
+    
+    const uchar *tag = data + size - 128;
+    
+    if (memcmp(tag, "TAG", 3) != 0) {
+        return false;
+    }
+    
+    insertText(tags, "title", id3v1Text(tag + 3, 30));
+    insertText(tags, "artist", id3v1Text(tag + 33, 30));
+    insertText(tags, "album", id3v1Text(tag + 63, 30));
+    insertText(tags, "year", id3v1Text(tag + 93, 4));
+    insertText(tags, "genre", genreName(tag[127]));
+    return true;
+}
+
+// Returns the duration of the MPEG audio stream in [start, end), from the Xing or VBRI header of a variable
+// bit rate stream, or from the bit rate of the first frame otherwise
+static qint64 mpegDuration(const uchar *data, qint64 start, qint64 end) {
+    const qint64 limit = qMin(end - 4, start + MAX_FRAME_SEARCH);
+    
+    for (qint64 pos = start; pos < limit; pos++) {
+        const uchar *header = data + pos;
+        
+        if ((header[0] != 0xff) || ((header[1] & 0xe0) != 0xe0)) {
+            continue;
+        }
+        
+        const int version = (header[1] >> 3) & 0x03; // 0 = MPEG 2.5, 2 = MPEG 2, 3 = MPEG 1
+        const int layer = 4 - ((header[1] >> 1) & 0x03);
+        const int bitRateIndex = header[2] >> 4;
+        const int sampleRateIndex = (header[2] >> 2) & 0x03;
+        
+        if ((version == 1) || (layer == 4) || (bitRateIndex == 0) || (bitRateIndex == 15) || (sampleRateIndex == 3)) {
+            continue;
+        }
+        
+        const bool mpeg1 = version == 3;
+        const bool mono = (header[3] >> 6) == 3;
+        const int bitRate = BIT_RATES[mpeg1 ? 0 : 1][layer - 1][bitRateIndex] * 1000;
+        const int sampleRate = SAMPLE_RATES[sampleRateIndex] >> (mpeg1 ? 0 : version == 2 ? 1 : 2);
+        const int samplesPerFrame = layer == 1 ? 384 : (layer == 3) && (!mpeg1) ? 576 : 1152;
+        const int padding = (header[2] >> 1) & 0x01;
+        const qint64 frameSize = layer == 1 ? (12 * bitRate / sampleRate + padding) * 4
+                                            : samplesPerFrame / 8 * bitRate / sampleRate + padding;
+        
+        // Require the next frame to follow, so that stray sync bits are not mistaken for a header
+        if ((pos + frameSize + 2 <= end) && ((data[pos + frameSize] != 0xff)
+                                              || ((data[pos + frameSize + 1] & 0xe0) != 0xe0))) {
+            continue;
+        }
+        
+        if (layer == 3) {
+            const qint64 xing = pos + 4 + (mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17));
+            
+            if ((xing + 12 <= end) && ((memcmp(data + xing, "Xing", 4) == 0) || (memcmp(data + xing, "Info", 4) == 0))
+                && (qFromBigEndian<quint32>(data + xing + 4) & 0x01)) {
+                return qint64(qFromBigEndian<quint32>(data + xing + 8)) * samplesPerFrame * 1000 / sampleRate;
+            }
+            
+            const qint64 vbri = pos + 36;
+            
+            if ((vbri + 18 <= end) && (memcmp(data + vbri, "VBRI", 4) == 0)) {
+                return qint64(qFromBigEndian<quint32>(data + vbri + 14)) * samplesPerFrame * 1000 / sampleRate;
+            }
+        }
+        
+        return (end - pos) * 8 * 1000 / bitRate;
+    }
+    
+    return 0;
+}
+
+// Returns the image data of a FLAC picture block, and sets type to its picture type
+static QByteArray flacPicture(const uchar *data, qint64 size, int &type) {
+    if (size < 32) {
+        return QByteArray();
+    }
+    
+    type = qFromBigEndian<quint32>(data);
+    
+    // Skip the MIME type and the description
+    qint64 pos = qint64(qFromBigEndian<quint32>(data + 4)) + 8;
+    
+    if (pos + 4 > size) {
+        return QByteArray();
+    }
+    
+    // Skip the width, height, colour depth and number of colours
+    pos += qint64(qFromBigEndian<quint32>(data + pos)) + 20;
+    
+    if (pos + 4 > size) {
+        return QByteArray();
+    }
+    
+    const qint64 length = qFromBigEndian<quint32>(data + pos);
+    pos += 4;
+    
+    if (pos + length > size) {
+        return QByteArray();
+    }
+    
+    return QByteArray(reinterpret_cast<const char*>(data + pos), length);
+}
+
+static void readVorbisComments(const uchar *data, qint64 size, bool picture, QVariantMap &tags) {
+    if (size < 8) {
+        return;
+    }
+    
+    // Skip the vendor string
+    qint64 pos = qint64(qFromLittleEndian<quint32>(data)) + 4;
+    
+    if (pos + 4 > size) {
+        return;
+    }
+    
+    const quint32 count = qFromLittleEndian<quint32>(data + pos);
+    pos += 4;
+    
+    for (quint32 i = 0; (i < count) && (pos + 4 <= size); i++) {
+        const qint64 length = qFromLittleEndian<quint32>(data + pos);
+        pos += 4;
+        
+        if (pos + length > size) {
+            break;
+        }
+        
+        const char *comment = reinterpret_cast<const char*>(data + pos);
+        const char *separator = static_cast<const char*>(memchr(comment, '=', length));
+        pos += length;
+        
+        if ((separator) && (separator > comment)) {
+            // Only the key is decoded before it is matched, since pictures are held in large base64 values
+            const QByteArray key = QByteArray(comment, separator - comment).toUpper();
+            const int valueSize = comment + length - separator - 1;
+            
+            if (key == "METADATA_BLOCK_PICTURE") {
+                if (picture) {
+                    const QByteArray block = QByteArray::fromBase64(QByteArray::fromRawData(separator + 1, valueSize));
+                    int type = 0;
+                    const QByteArray image = flacPicture(reinterpret_cast<const uchar*>(block.constData()),
+                                                         block.size(), type);
+                    insertPicture(tags, image, type);
+                }
+                
+                continue;
+            }
+            
+            const QString value = QString::fromUtf8(separator + 1, valueSize).trimmed();
+            
+            if (key == "TITLE") {
+                insertText(tags, "title", value);
+            }
+            else if (key == "ARTIST") {
+                insertText(tags, "artist", value);
+            }
+            else if (key == "ALBUM") {
+                insertText(tags, "album", value);
+            }
+            else if (key == "GENRE") {
+                insertText(tags, "genre", value);
+            }
+            else if (key == "DATE") {
+                insertText(tags, "year", value.left(4));
+            }
+        }
+    }
+}
+
+static bool readFlac(const uchar *data, qint64 size, qint64 start, bool picture, QVariantMap &tags) {
+    if ((start + 4 > size) || (memcmp(data + start, "fLaC", 4) != 0)) {
+        return false;
+    }
+    
+    qint64 pos = start + 4;
+    bool last = false;
+    
+    while ((!last) && (pos + 4 <= size)) {
+        const uchar *block = data + pos;
+        const int type = block[0] & 0x7f;
+        const qint64 length = (block[1] << 16) | (block[2] << 8) | block[3];
+        last = block[0] & 0x80;
+        pos += 4;
+        
+        if (pos + length > size) {
+            break;
+        }
+        
+        if ((type == 0) && (length >= 18)) {
+            // STREAMINFO
+            const uchar *info = data + pos;
+            const qint64 sampleRate = (info[10] << 12) | (info[11] << 4) | (info[12] >> 4);
+            const qint64 samples = (qint64(info[13] & 0x0f) << 32) | qFromBigEndian<quint32>(info + 14);
+            
+            if (sampleRate > 0) {
+                insertDuration(tags, samples * 1000 / sampleRate);
+            }
+        }
+        else if (type == 4) {
+            // VORBIS_COMMENT
+            readVorbisComments(data + pos, length, picture, tags);
+        }
+        else if ((type == 6) && (picture)) {
+            // PICTURE
+            int pictureType = 0;
+            const QByteArray image = flacPicture(data + pos, length, pictureType);
+            insertPicture(tags, image, pictureType);
+        }
+        
+        pos += length;
+    }
+    
+    return true;
+}
+
+static bool readOgg(const uchar *data, qint64 size, bool picture, QVariantMap &tags) {
+    if ((size < 27) || (memcmp(data, "OggS", 4) != 0)) {
+        return false;
+    }
+    
+    // The identification and comment headers are the first two packets of the stream,
+    // and the comment header may span several pages
+    QByteArray packets[2];
+    int packet = 0;
+    qint64 pos = 0;
+    
+    while ((packet < 2) && (pos + 27 <= size) && (memcmp(data + pos, "OggS", 4) == 0)) {
+        const int segments = data[pos + 26];
+        const uchar *lacing = data + pos + 27;
+        qint64 body = pos + 27 + segments;
+        
+        if (body > size) {
+            break;
+        }
+        
+        for (int i = 0; i < segments; i++) {
+            const int length = lacing[i];
+            
+            if (body + length > size) {
+                packet = 2;
+                break;
+            }
+            
+            if ((packet < 2) && (packets[packet].size() < MAX_COMMENT_SIZE)) {
+                packets[packet].append(reinterpret_cast<const char*>(data + body), length);
+            }
+            
+            body += length;
+            
+            if (length < 255) {
+                packet++;
+            }
+        }
+        
+        pos = body;
+    }
+    
+    qint64 sampleRate = 0;
+    qint64 preSkip = 0;
+    
+    if ((packets[0].size() >= 16) && (packets[0].startsWith("\x01vorbis"))) {
+        sampleRate = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(packets[0].constData()) + 12);
+        
+        if (packets[1].startsWith("\x03vorbis")) {
+            readVorbisComments(reinterpret_cast<const uchar*>(packets[1].constData()) + 7, packets[1].size() - 7,
+                               picture, tags);
+        }
+    }
+    else if ((packets[0].size() >= 12) && (packets[0].startsWith("OpusHead"))) {
+        // Opus granule positions are always in 48kHz samples
+        sampleRate = 48000;
+        preSkip = qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(packets[0].constData()) + 10);
+        
+        if (packets[1].startsWith("OpusTags")) {
+            readVorbisComments(reinterpret_cast<const uchar*>(packets[1].constData()) + 8, packets[1].size() - 8,
+                               picture, tags);
+        }
+    }
+    
+    if (sampleRate > 0) {
+        // The granule position of the last page is the number of samples in the stream
+        for (pos = size - 27; pos >= qMax(qint64(0), size - MAX_PAGE_SEARCH); pos--) {
+            if ((memcmp(data + pos, "OggS", 4) == 0) && (data[pos + 4] == 0)) {
+                // Pages on which no packet ends have a granule position of -1
+                const qint64 granule = qFromLittleEndian<quint64>(data + pos + 6);
+                
+                if (granule > preSkip) {
+                    insertDuration(tags, (granule - preSkip) * 1000 / sampleRate);
+                    break;
+                }
+            }
+        }
+    }
+    
+    return true;
+}
+
+static QString mp4Text(const uchar *data, qint64 pos, qint64 end) {
+    // The value of a metadata item is held in a "data" atom, after its type and locale
+    if ((pos + 16 > end) || (memcmp(data + pos + 4, "data", 4) != 0)) {
+        return QString();
+    }
+    
+    const qint64 dataEnd = qMin(end, pos + qFromBigEndian<quint32>(data + pos));
+    
+    if ((qFromBigEndian<quint32>(data + pos + 8) & 0xffffff) == 1) {
+        return QString::fromUtf8(reinterpret_cast<const char*>(data + pos + 16), qMax(qint64(0), dataEnd - pos - 16))
+                       .trimmed();
+    }
+    
+    if ((dataEnd - pos >= 18) && (memcmp(data + pos - 4, "gnre", 4) == 0)) {
+        // The ID3v1 genre index plus one
+        return genreName(qFromBigEndian<quint16>(data + pos + 16) - 1);
+    }
+    
+    return QString();
+}
+
+// Returns the image data of a "covr" metadata item
+static QByteArray mp4Picture(const uchar *data, qint64 pos, qint64 end) {
+    if ((pos + 16 > end) || (memcmp(data + pos + 4, "data", 4) != 0)) {
+        return QByteArray();
+    }
+    
+    const qint64 dataEnd = qMin(end, pos + qFromBigEndian<quint32>(data + pos));
+    return QByteArray(reinterpret_cast<const char*>(data + pos + 16), qMax(qint64(0), dataEnd - pos - 16));
+}
+
+// Walks the atoms in [pos, end), descending only into the atoms that lead to the movie header and metadata
+static void readMp4Atoms(const uchar *data, qint64 pos, qint64 end, bool items, bool picture, QVariantMap &tags) {
+    while (pos + 8 <= end) {
+        qint64 atomSize = qFromBigEndian<quint32>(data + pos);
+        qint64 headerSize = 8;
+        
+        if (atomSize == 1) {
+            if (pos + 16 > end) {
+                return;
+            }
+            
+            atomSize = qFromBigEndian<quint64>(data + pos + 8);
+            headerSize = 16;
+        }
+        else if (atomSize == 0) {
+            atomSize = end - pos;
+        }
+        
+        if ((atomSize < headerSize) || (atomSize > end - pos)) {
+            return;
+        }
+        
+        const QByteArray type(reinterpret_cast<const char*>(data + pos + 4), 4);
+        const qint64 body = pos + headerSize;
+        const qint64 atomEnd = pos + atomSize;
+        
+        if (items) {
+            if (type == "\xa9nam") {
+                insertText(tags, "title", mp4Text(data, body, atomEnd));
+            }
+            else if (type == "\xa9" "ART") {
+                insertText(tags, "artist", mp4Text(data, body, atomEnd));
+            }
+            else if (type == "\xa9" "alb") {
+                insertText(tags, "album", mp4Text(data, body, atomEnd));
+            }
+            else if ((type == "\xa9gen") || (type == "gnre")) {
+                insertText(tags, "genre", mp4Text(data, body, atomEnd));
+            }
+            else if (type == "\xa9" "day") {
+                insertText(tags, "year", mp4Text(data, body, atomEnd).left(4));
+            }
+            else if ((type == "covr") && (picture)) {
+                insertPicture(tags, mp4Picture(data, body, atomEnd), FRONT_COVER);
+            }
+        }
+        else if ((type == "moov") || (type == "udta")) {
+            readMp4Atoms(data, body, atomEnd, false, picture, tags);
+        }
+        else if (type == "meta") {
+            // A full atom, with a version and flags before its children
+            readMp4Atoms(data, body + 4, atomEnd, false, picture, tags);
+        }
+        else if (type == "ilst") {
+            readMp4Atoms(data, body, atomEnd, true, picture, tags);
+        }
+        else if ((type == "mvhd") && (body + 32 <= atomEnd)) {
+            const bool version1 = data[body] == 1;
+            const qint64 timeScale = qFromBigEndian<quint32>(data + body + (version1 ? 20 : 12));
+            const qint64 duration = version1 ? qint64(qFromBigEndian<quint64>(data + body + 24))
+                                             : qint64(qFromBigEndian<quint32>(data + body + 16));
+            
+            if (timeScale > 0) {
+                insertDuration(tags, duration * 1000 / timeScale);
+            }
+        }
+        
+        pos = atomEnd;
+    }
+}
+
+static bool readMp4(const uchar *data, qint64 size, bool picture, QVariantMap &tags) {
+    if ((size < 12) || (memcmp(data + 4, "ftyp", 4) != 0)) {
+        return false;
+    }
+    
+    readMp4Atoms(data, 0, size, false, picture, tags);
+    return true;
+}
+
+QVariantMap TagReader::read(const QString &fileName, bool picture) {
+    QVariantMap tags;
+    QFile file(fileName);
+    
+    if (!file.open(QFile::ReadOnly)) {
+        return tags;
+    }
+    
+    const QFileInfo info(file);
+    const qint64 size = file.size();
+    tags["size"] = size;
+    tags["lastModified"] = info.lastModified();
+    
+    // The whole file is mapped, but only the pages holding the tags and headers are read from disk
+    uchar *data = size > 0 ? file.map(0, size) : 0;
+    
+    if (!data) {
+        return tags;
+    }
+    
+    const qint64 id3Size = qMin(readId3v2(data, size, picture, tags), size);
+    
+    if ((!readFlac(data, size, id3Size, picture, tags)) && (!readOgg(data, size, picture, tags))
+        && (!readMp4(data, size, picture, tags))) {
+        const bool id3v1 = readId3v1(data, size, tags);
+        
+        if ((id3Size > 0) || (info.suffix().compare("mp3", Qt::CaseInsensitive) == 0)) {
+            insertDuration(tags, mpegDuration(data, id3Size, id3v1 ? size - 128 : size));
+        }
+    }
+    
+    file.unmap(data);
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "TagReader::read" << fileName << tags.keys();
+#endif
+    return tags;
+}
+
+TagReaderTask::TagReaderTask(const QString &fileName) :
+    QObject(),
+    QRunnable(),
+    m_fileName(fileName)
+{
+    // The task is deleted in the thread that created it, once finished() has been delivered
+    setAutoDelete(false);
+    connect(this, SIGNAL(finished(QVariantMap)), this, SLOT(deleteLater()));
+}
+
+void TagReaderTask::run() {
+    emit finished(TagReader::read(m_fileName));
+}
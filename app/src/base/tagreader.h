@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TAGREADER_H
+#define TAGREADER_H
+
+#include <QObject>
+#include <QRunnable>
+#include <QVariantMap>
+
+/*
+ * Reads the metadata of local audio files without a media framework. ID3v1/v2 tags and MPEG frame headers,
+ * Vorbis comments in FLAC and Ogg files, and MP4 metadata atoms are supported. The file is memory mapped, so
+ * only the pages holding the tags and headers are read. read() is reentrant and may be called from any thread.
+ *
+ * The returned map contains whichever of "title", "artist", "album", "genre", "year" and "duration"
+ * (in milliseconds) were found, together with the "size" and "lastModified" date of the file. If picture is
+ * true, the encoded image data of the embedded front cover, or of the first embedded picture when there is
+ * no front cover, is returned as "picture".
+ */
+class TagReader
+{
+
+public:
+    static QVariantMap read(const QString &fileName, bool picture = false);
+};
+
+/*
+ * Reads the metadata of a file on the global thread pool. finished() is emitted from the pool thread,
+ * and the task deletes itself once it has been delivered.
+ */
+class TagReaderTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit TagReaderTask(const QString &fileName);
+    
+    void run();
+
+Q_SIGNALS:
+    void finished(const QVariantMap &tags);
+    
+private:
+    QString m_fileName;
+};
+
+#endif // TAGREADER_H
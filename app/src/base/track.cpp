@@ -57,6 +57,30 @@ MKTrack::MKTrack(MKTrack *track, QObject *parent) :
 {
 }
 
+MKTrack::MKTrack(const TrackRecord &record, QObject *parent) :
+    QObject(parent),
+    m_artist(record.artist()),
+    m_artistId(record.artistId()),
+    m_date(record.date()),
+    m_description(record.description()),
+    m_downloadable(record.isDownloadable()),
+    m_duration(record.duration()),
+    m_durationString(record.durationString()),
+    m_format(record.format()),
+    m_genre(record.genre()),
+    m_id(record.id()),
+    m_largeThumbnailUrl(record.largeThumbnailUrl()),
+    m_thumbnailUrl(record.thumbnailUrl()),
+    m_playCount(record.playCount()),
+    m_service(record.service()),
+    m_size(record.size()),
+    m_sizeString(record.sizeString()),
+    m_streamUrl(record.streamUrl()),
+    m_title(record.title()),
+    m_url(record.url())
+{
+}
+
 QString MKTrack::artist() const {
     return m_artist;
 }
@@ -268,6 +292,60 @@ void MKTrack::setUrl(const QUrl &u) {
     }
 }
 
+TrackRecord MKTrack::record() const {
+    TrackRecord record;
+    record.setArtist(artist());
+    record.setArtistId(artistId());
+    record.setDate(date());
+    record.setDescription(description());
+    record.setDownloadable(isDownloadable());
+    record.setDuration(duration());
+    record.setFormat(format());
+    record.setGenre(genre());
+    record.setId(id());
+    record.setLargeThumbnailUrl(largeThumbnailUrl());
+    record.setThumbnailUrl(thumbnailUrl());
+    record.setPlayCount(playCount());
+    record.setService(service());
+    record.setSize(size());
+    record.setStreamUrl(streamUrl());
+    record.setTitle(title());
+    record.setUrl(url());
+    
+    // The record only holds the strings that differ from those it formats itself
+    if (durationString() != record.durationString()) {
+        record.setDurationString(durationString());
+    }
+    
+    if (sizeString() != record.sizeString()) {
+        record.setSizeString(sizeString());
+    }
+    
+    return record;
+}
+
+void MKTrack::loadRecord(const TrackRecord &record) {
+    setArtist(record.artist());
+    setArtistId(record.artistId());
+    setDate(record.date());
+    setDescription(record.description());
+    setDownloadable(record.isDownloadable());
+    setDuration(record.duration());
+    setDurationString(record.durationString());
+    setFormat(record.format());
+    setGenre(record.genre());
+    setId(record.id());
+    setLargeThumbnailUrl(record.largeThumbnailUrl());
+    setThumbnailUrl(record.thumbnailUrl());
+    setPlayCount(record.playCount());
+    setService(record.service());
+    setSize(record.size());
+    setSizeString(record.sizeString());
+    setStreamUrl(record.streamUrl());
+    setTitle(record.title());
+    setUrl(record.url());
+}
+
 void MKTrack::loadTrack(MKTrack *track) {
     setArtist(track->artist());
     setArtistId(track->artistId());
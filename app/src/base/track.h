@@ -17,6 +17,7 @@
 #ifndef MKTRACK_H
 #define MKTRACK_H
 
+#include "trackrecord.h"
 #include <QObject>
 #include <QUrl>
 
@@ -47,6 +48,7 @@ class MKTrack : public QObject
 public:
     explicit MKTrack(QObject *parent = 0);
     explicit MKTrack(MKTrack *track, QObject *parent = 0);
+    explicit MKTrack(const TrackRecord &record, QObject *parent = 0);
     
     QString artist() const;
     QString artistId() const;
@@ -82,12 +84,16 @@ public:
     
     QUrl url() const;
     
+    virtual TrackRecord record() const;
+    
     Q_INVOKABLE virtual void loadTrack(MKTrack *track);
 
 public Q_SLOTS:
     virtual void played();
     
 protected:
+    void loadRecord(const TrackRecord &record);
+    
     void setArtist(const QString &a);
     void setArtistId(const QString &i);
     
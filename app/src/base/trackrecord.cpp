@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trackrecord.h"
+#include "utils.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+
+// The number of distinct strings that are interned. Once the pool is full, other values are stored unshared.
+static const int MAX_INTERNED_STRINGS = 1000;
+
+class TrackRecordData : public QSharedData
+{
+
+public:
+    // The same defaults as MKTrack, so that a track created from a default record is unchanged
+    TrackRecordData() :
+        QSharedData(),
+        artist(QCoreApplication::translate("MKTrack", "Unknown artist")),
+        date(QCoreApplication::translate("MKTrack", "Unknown date")),
+        description(QCoreApplication::translate("MKTrack", "No description")),
+        format(QCoreApplication::translate("MKTrack", "Unknown format")),
+        genre(QCoreApplication::translate("MKTrack", "Unknown genre")),
+        title(QCoreApplication::translate("MKTrack", "Unknown title")),
+        duration(0),
+        favouriteCount(0),
+        playCount(0),
+        size(0),
+        commentable(true),
+        downloadable(true),
+        favourite(false),
+        local(false),
+        streamable(true)
+    {
+    }
+    
+    QString artist;
+    QString artistId;
+    QString date;
+    QString description;
+    QString durationString;
+    QString format;
+    QString genre;
+    QString id;
+    QString service;
+    QString sharing;
+    QString sizeString;
+    QString title;
+    
+    QUrl largeThumbnailUrl;
+    QUrl streamUrl;
+    QUrl thumbnailUrl;
+    QUrl url;
+    QUrl waveformUrl;
+    
+    qint64 duration;
+    qint64 favouriteCount;
+    qint64 playCount;
+    qint64 size;
+    
+    bool commentable;
+    bool downloadable;
+    bool favourite;
+    bool local;
+    bool streamable;
+};
+
+struct SharedNull
+{
+    SharedNull() : d(new TrackRecordData) {}
+    
+    QSharedDataPointer<TrackRecordData> d;
+};
+
+struct StringPool
+{
+    QMutex mutex;
+    QSet<QString> strings;
+};
+
+Q_GLOBAL_STATIC(SharedNull, sharedNull)
+Q_GLOBAL_STATIC(StringPool, stringPool)
+
+TrackRecord::TrackRecord() :
+    d(sharedNull()->d)
+{
+}
+
+TrackRecord::TrackRecord(const TrackRecord &other) :
+    d(other.d)
+{
+}
+
+TrackRecord::~TrackRecord() {}
+
+TrackRecord& TrackRecord::operator=(const TrackRecord &other) {
+    d = other.d;
+    return *this;
+}
+
+QString TrackRecord::artist() const {
+    return d->artist;
+}
+
+void TrackRecord::setArtist(const QString &a) {
+    d->artist = a;
+}
+
+QString TrackRecord::artistId() const {
+    return d->artistId;
+}
+
+void TrackRecord::setArtistId(const QString &i) {
+    d->artistId = i;
+}
+
+bool TrackRecord::isCommentable() const {
+    return d->commentable;
+}
+
+void TrackRecord::setCommentable(bool c) {
+    d->commentable = c;
+}
+
+QString TrackRecord::date() const {
+    return d->date;
+}
+
+void TrackRecord::setDate(const QString &dt) {
+    d->date = dt;
+}
+
+QString TrackRecord::description() const {
+    return d->description;
+}
+
+void TrackRecord::setDescription(const QString &dsc) {
+    d->description = dsc;
+}
+
+bool TrackRecord::isDownloadable() const {
+    return d->downloadable;
+}
+
+void TrackRecord::setDownloadable(bool dl) {
+    d->downloadable = dl;
+}
+
+qint64 TrackRecord::duration() const {
+    return d->duration;
+}
+
+void TrackRecord::setDuration(qint64 dr) {
+    d->duration = dr;
+}
+
+QString TrackRecord::durationString() const {
+    if (!d->durationString.isEmpty()) {
+        return d->durationString;
+    }
+    
+    return d->duration > 0 ? Utils::formatMSecs(d->duration) : QString("--:--");
+}
+
+void TrackRecord::setDurationString(const QString &s) {
+    d->durationString = s;
+}
+
+bool TrackRecord::isFavourite() const {
+    return d->favourite;
+}
+
+void TrackRecord::setFavourite(bool f) {
+    d->favourite = f;
+}
+
+qint64 TrackRecord::favouriteCount() const {
+    return d->favouriteCount;
+}
+
+void TrackRecord::setFavouriteCount(qint64 c) {
+    d->favouriteCount = c;
+}
+
+QString TrackRecord::format() const {
+    return d->format;
+}
+
+void TrackRecord::setFormat(const QString &f) {
+    d->format = intern(f);
+}
+
+QString TrackRecord::genre() const {
+    return d->genre;
+}
+
+void TrackRecord::setGenre(const QString &g) {
+    d->genre = intern(g);
+}
+
+QString TrackRecord::id() const {
+    return d->id;
+}
+
+void TrackRecord::setId(const QString &i) {
+    d->id = i;
+}
+
+QUrl TrackRecord::largeThumbnailUrl() const {
+    return d->largeThumbnailUrl;
+}
+
+void TrackRecord::setLargeThumbnailUrl(const QUrl &u) {
+    d->largeThumbnailUrl = u;
+}
+
+bool TrackRecord::isLocal() const {
+    return d->local;
+}
+
+void TrackRecord::setLocal(bool l) {
+    d->local = l;
+}
+
+qint64 TrackRecord::playCount() const {
+    return d->playCount;
+}
+
+void TrackRecord::setPlayCount(qint64 c) {
+    d->playCount = c;
+}
+
+QString TrackRecord::service() const {
+    return d->service;
+}
+
+void TrackRecord::setService(const QString &s) {
+    d->service = intern(s);
+}
+
+QString TrackRecord::sharing() const {
+    return d->sharing;
+}
+
+void TrackRecord::setSharing(const QString &s) {
+    d->sharing = intern(s);
+}
+
+qint64 TrackRecord::size() const {
+    return d->size;
+}
+
+void TrackRecord::setSize(qint64 s) {
+    d->size = s;
+}
+
+QString TrackRecord::sizeString() const {
+    if (!d->sizeString.isEmpty()) {
+        return d->sizeString;
+    }
+    
+    return d->size > 0 ? Utils::formatBytes(d->size) : QString();
+}
+
+void TrackRecord::setSizeString(const QString &s) {
+    d->sizeString = s;
+}
+
+bool TrackRecord::isStreamable() const {
+    return d->streamable;
+}
+
+void TrackRecord::setStreamable(bool s) {
+    d->streamable = s;
+}
+
+QUrl TrackRecord::streamUrl() const {
+    return d->streamUrl;
+}
+
+void TrackRecord::setStreamUrl(const QUrl &u) {
+    d->streamUrl = u;
+}
+
+QUrl TrackRecord::thumbnailUrl() const {
+    return d->thumbnailUrl;
+}
+
+void TrackRecord::setThumbnailUrl(const QUrl &u) {
+    d->thumbnailUrl = u;
+}
+
+QString TrackRecord::title() const {
+    return d->title;
+}
+
+void TrackRecord::setTitle(const QString &t) {
+    d->title = t;
+}
+
+QUrl TrackRecord::url() const {
+    return d->url;
+}
+
+void TrackRecord::setUrl(const QUrl &u) {
+    d->url = u;
+}
+
+QUrl TrackRecord::waveformUrl() const {
+    return d->waveformUrl;
+}
+
+void TrackRecord::setWaveformUrl(const QUrl &u) {
+    d->waveformUrl = u;
+}
+
+QString TrackRecord::intern(const QString &s) {
+    if (s.isEmpty()) {
+        return QString();
+    }
+    
+    StringPool *pool = stringPool();
+    QMutexLocker locker(&pool->mutex);
+    QSet<QString>::const_iterator iterator = pool->strings.constFind(s);
+    
+    if (iterator != pool->strings.constEnd()) {
+        return *iterator;
+    }
+    
+    if (pool->strings.size() < MAX_INTERNED_STRINGS) {
+        pool->strings.insert(s);
+    }
+    
+    return s;
+}
+
+// The same layout as the records of MKTrack that were stored before TrackRecord was added
+QDataStream& operator<<(QDataStream &stream, const TrackRecord &record) {
+    const TrackRecordData *d = record.d.constData();
+    stream << d->artist << d->artistId << d->date << d->description << d->downloadable << d->duration
+           << d->durationString << d->format << d->genre << d->id << d->largeThumbnailUrl << d->thumbnailUrl
+           << d->playCount << d->service << d->size << d->sizeString << d->streamUrl << d->title << d->url;
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream &stream, TrackRecord &record) {
+    TrackRecordData *d = record.d.data();
+    stream >> d->artist >> d->artistId >> d->date >> d->description >> d->downloadable >> d->duration
+           >> d->durationString >> d->format >> d->genre >> d->id >> d->largeThumbnailUrl >> d->thumbnailUrl
+           >> d->playCount >> d->service >> d->size >> d->sizeString >> d->streamUrl >> d->title >> d->url;
+    d->format = TrackRecord::intern(d->format);
+    d->genre = TrackRecord::intern(d->genre);
+    d->service = TrackRecord::intern(d->service);
+    return stream;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACKRECORD_H
+#define TRACKRECORD_H
+
+#include <QSharedDataPointer>
+#include <QString>
+#include <QUrl>
+
+class TrackRecordData;
+class QDataStream;
+
+/*
+ * An implicitly shared copy of the metadata of a track, used by list models and the playback queue in place of
+ * a QObject per row. Copying a record only copies a pointer, and default constructed records share a single
+ * instance. The format, genre, service and sharing, which have few distinct values that are repeated across
+ * many tracks, are interned in a bounded pool, so that every record holding the same value shares one string.
+ * durationString() and sizeString() are formatted when they are read, unless they have been set explicitly.
+ *
+ * Records are reentrant, so they can be created in any thread. MKTrack(const TrackRecord&) creates a track object
+ * from a record when one is needed by QML or a window, and MKTrack::record() returns a record of a track.
+ */
+class TrackRecord
+{
+
+public:
+    TrackRecord();
+    TrackRecord(const TrackRecord &other);
+    ~TrackRecord();
+    
+    TrackRecord& operator=(const TrackRecord &other);
+    
+    QString artist() const;
+    void setArtist(const QString &a);
+    
+    QString artistId() const;
+    void setArtistId(const QString &i);
+    
+    bool isCommentable() const;
+    void setCommentable(bool c);
+    
+    QString date() const;
+    void setDate(const QString &d);
+    
+    QString description() const;
+    void setDescription(const QString &d);
+    
+    bool isDownloadable() const;
+    void setDownloadable(bool d);
+    
+    qint64 duration() const;
+    void setDuration(qint64 d);
+    
+    QString durationString() const;
+    void setDurationString(const QString &s);
+    
+    bool isFavourite() const;
+    void setFavourite(bool f);
+    
+    qint64 favouriteCount() const;
+    void setFavouriteCount(qint64 c);
+    
+    QString format() const;
+    void setFormat(const QString &f);
+    
+    QString genre() const;
+    void setGenre(const QString &g);
+    
+    QString id() const;
+    void setId(const QString &i);
+    
+    QUrl largeThumbnailUrl() const;
+    void setLargeThumbnailUrl(const QUrl &u);
+    
+    bool isLocal() const;
+    void setLocal(bool l);
+    
+    qint64 playCount() const;
+    void setPlayCount(qint64 c);
+    
+    QString service() const;
+    void setService(const QString &s);
+    
+    QString sharing() const;
+    void setSharing(const QString &s);
+    
+    qint64 size() const;
+    void setSize(qint64 s);
+    
+    QString sizeString() const;
+    void setSizeString(const QString &s);
+    
+    bool isStreamable() const;
+    void setStreamable(bool s);
+    
+    QUrl streamUrl() const;
+    void setStreamUrl(const QUrl &u);
+    
+    QUrl thumbnailUrl() const;
+    void setThumbnailUrl(const QUrl &u);
+    
+    QString title() const;
+    void setTitle(const QString &t);
+    
+    QUrl url() const;
+    void setUrl(const QUrl &u);
+    
+    QUrl waveformUrl() const;
+    void setWaveformUrl(const QUrl &u);
+    
+    static QString intern(const QString &s);
+
+private:
+    friend QDataStream& operator<<(QDataStream &stream, const TrackRecord &record);
+    friend QDataStream& operator>>(QDataStream &stream, TrackRecord &record);
+    
+    QSharedDataPointer<TrackRecordData> d;
+};
+
+Q_DECLARE_TYPEINFO(TrackRecord, Q_MOVABLE_TYPE);
+
+QDataStream& operator<<(QDataStream &stream, const TrackRecord &record);
+QDataStream& operator>>(QDataStream &stream, TrackRecord &record);
+
+#endif // TRACKRECORD_H
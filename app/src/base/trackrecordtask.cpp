@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trackrecordtask.h"
+#include <QMetaType>
+
+// The number of records inserted by a model in one pass of the event loop
+static const int BATCH_SIZE = 50;
+
+TrackRecordTask::TrackRecordTask(const QString &service, const QVariantList &tracks, Converter converter) :
+    QObject(),
+    QRunnable(),
+    m_service(service),
+    m_tracks(tracks),
+    m_converter(converter)
+{
+    qRegisterMetaType< QList<TrackRecord> >("QList<TrackRecord>");
+    // The task is deleted in the thread that created it, once finished() has been delivered
+    setAutoDelete(false);
+    connect(this, SIGNAL(finished()), this, SLOT(deleteLater()));
+}
+
+void TrackRecordTask::run() {
+    QList<TrackRecord> records;
+    
+    foreach (const QVariant &track, m_tracks) {
+        records << m_converter(m_service, track.toMap());
+        
+        if (records.size() == BATCH_SIZE) {
+            emit recordsReady(records);
+            records.clear();
+        }
+    }
+    
+    if (!records.isEmpty()) {
+        emit recordsReady(records);
+    }
+    
+    emit finished();
+}
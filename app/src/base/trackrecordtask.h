@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACKRECORDTASK_H
+#define TRACKRECORDTASK_H
+
+#include "trackrecord.h"
+#include <QObject>
+#include <QRunnable>
+#include <QVariantList>
+
+/*
+ * Converts a page of tracks returned by a service to records on the global thread pool, so that the GUI thread
+ * only has to insert the finished rows. The records are delivered through recordsReady() in batches, each of
+ * which a model inserts with a single beginInsertRows()/endInsertRows(), and the event loop is able to paint
+ * between batches. The converter must be reentrant. The signals are emitted from the pool thread, and the task
+ * deletes itself once finished() has been delivered.
+ */
+class TrackRecordTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    typedef TrackRecord (*Converter)(const QString &service, const QVariantMap &track);
+    
+    explicit TrackRecordTask(const QString &service, const QVariantList &tracks, Converter converter);
+    
+    void run();
+
+Q_SIGNALS:
+    void recordsReady(const QList<TrackRecord> &records);
+    void finished();
+
+private:
+    QString m_service;
+    QVariantList m_tracks;
+    Converter m_converter;
+};
+
+#endif // TRACKRECORDTASK_H
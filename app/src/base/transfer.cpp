@@ -16,6 +16,7 @@
 
 #include "transfer.h"
 #include "definitions.h"
+#include "downloadindex.h"
 #include "settings.h"
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
@@ -619,6 +620,7 @@ void Transfer::moveDownloadedFiles() {
     }
     
     QDir downDir(downloadPath());
+    QStringList downloadedFileNames;
     
     foreach (QString oldFileName, downDir.entryList(QDir::Files)) {
         int i = 0;
@@ -639,9 +641,22 @@ void Transfer::moveDownloadedFiles() {
             setStatus(Failed);
             return;
         }
+        
+        // The downloaded track is listed before any other files, so that it is the one that is played
+        if (oldFileName == fileName()) {
+            downloadedFileNames.prepend(newFileName);
+        }
+        else {
+            downloadedFileNames << newFileName;
+        }
     }
         
     downDir.rmdir(downDir.path());
+    
+    if (transferType() == Download) {
+        DownloadIndex::insert(service(), resourceId(), downloadedFileNames);
+    }
+    
     setErrorString(QString());
     setStatus(Completed);
 }
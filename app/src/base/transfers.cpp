@@ -114,6 +114,16 @@ Transfer* Transfers::get(const QString &id) const {
     return 0;
 }
 
+Transfer* Transfers::get(const QString &service, const QString &resourceId) const {
+    foreach (Transfer *transfer, m_transfers) {
+        if ((transfer->service() == service) && (transfer->resourceId() == resourceId)) {
+            return transfer;
+        }
+    }
+    
+    return 0;
+}
+
 bool Transfers::start() {
     foreach (Transfer *transfer, m_transfers) {
         transfer->queue();
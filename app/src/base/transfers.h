@@ -43,6 +43,7 @@ public:
     
     Q_INVOKABLE Transfer* get(int i) const;
     Q_INVOKABLE Transfer* get(const QString &id) const;
+    Transfer* get(const QString &service, const QString &resourceId) const;
     
 public Q_SLOTS:
     bool start();
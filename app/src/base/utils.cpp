@@ -15,8 +15,8 @@
  */
 
 #include "utils.h"
+#include "coverart.h"
 #include <QRegExp>
-#include <QDir>
 
 Utils::Utils(QObject *parent) :
     QObject(parent)
@@ -27,16 +27,8 @@ QUrl Utils::findThumbnailUrl(const QUrl &url) {
     if (!isLocalFile(url)) {
         return QUrl();
     }
-        
-    QDir dir(url.path().left(url.path().lastIndexOf('/')));
     
-    foreach (QString fileName, QStringList() << "cover.jpg" << "folder.jpg" << "front.jpg") {
-        if (dir.exists(fileName)) {
-            return QUrl::fromLocalFile(dir.absoluteFilePath(fileName));
-        }
-    }
-    
-    return QUrl();
+    return CoverArt::thumbnailUrl(url.path());
 }
 
 QString Utils::formatBytes(qint64 bytes) {
@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "audiocache.h"
 #include "audioplayer.h"
 #include "categorymodel.h"
 #include "categorynamemodel.h"
@@ -22,6 +23,10 @@
 #include "database.h"
 #include "dbusservice.h"
 #include "definitions.h"
+#include "imagediskcache.h"
+#include "locallibrary.h"
+#include "imageprovider.h"
+#include "localtrackmodel.h"
 #include "networkproxytypemodel.h"
 #include "pluginartistmodel.h"
 #include "plugincategorymodel.h"
@@ -47,6 +52,7 @@
 #include "soundcloudplaylistmodel.h"
 #include "soundcloudsearchtypemodel.h"
 #include "soundcloudstreammodel.h"
+#include "soundcloudsync.h"
 #include "soundcloudtrackmodel.h"
 #include "transfermodel.h"
 #include "transfers.h"
@@ -62,6 +68,7 @@ inline void registerTypes() {
     qmlRegisterType<CategoryModel>("MusiKloud", 2, 0, "CategoryModel");
     qmlRegisterType<CategoryNameModel>("MusiKloud", 2, 0, "CategoryNameModel");
     qmlRegisterType<ConcurrentTransfersModel>("MusiKloud", 2, 0, "ConcurrentTransfersModel");
+    qmlRegisterType<LocalTrackModel>("MusiKloud", 2, 0, "LocalTrackModel");
     qmlRegisterType<MKTrack>("MusiKloud", 2, 0, "Track");
     qmlRegisterType<NetworkProxyTypeModel>("MusiKloud", 2, 0, "NetworkProxyTypeModel");
     qmlRegisterType<PluginArtist>("MusiKloud", 2, 0, "PluginArtist");
@@ -108,11 +115,15 @@ Q_DECL_EXPORT int main(int argc, char *argv[]) {
     app.setWindowIcon(QIcon::fromTheme("musikloud2"));
 
     Settings settings;
+    AudioCache audioCache;
     Clipboard clipboard;
     DBusService dbus;
+    ImageDiskCache imageCache;
+    LocalLibrary localLibrary;
     Resources resources;
     ResourcesPlugins plugins;
     SoundCloud soundcloud;
+    SoundCloudSync soundcloudSync;
     Transfers transfers;
     Utils utils;
         
@@ -120,12 +131,17 @@ Q_DECL_EXPORT int main(int argc, char *argv[]) {
     registerTypes();
     plugins.load();
     settings.setNetworkProxy();
+    localLibrary.rescan();
+    soundcloudSync.sync();
     
     QQmlApplicationEngine engine;
     QQmlContext *context = engine.rootContext();
     
+    engine.addImageProvider("images", new ImageProvider);
+    
     context->setContextProperty("Clipboard", &clipboard);
     context->setContextProperty("DBus", &dbus);
+    context->setContextProperty("LocalLibrary", &localLibrary);
     context->setContextProperty("Plugins", &plugins);
     context->setContextProperty("Resources", &resources);
     context->setContextProperty("Settings", &settings);
@@ -24,7 +24,7 @@ Rectangle {
     id: root
     
     property string artistId
-    property alias thumbnail: thumbnail.source
+    property string thumbnail
     property alias name: nameLabel.text
     property alias description: descriptionLabel.text
     
@@ -48,6 +48,9 @@ Rectangle {
             margins: 10
         }
         smooth: true
+        sourceSize.width: width
+        sourceSize.height: height
+        source: root.thumbnail ? "image://images/" + encodeURIComponent(root.thumbnail) : ""
     }
     
     GridLayout {
@@ -37,7 +37,9 @@ Item {
             left: parent.left
             margins: 10
         }
-        source: thumbnailUrl
+        sourceSize.width: width
+        sourceSize.height: height
+        source: thumbnailUrl ? "image://images/" + encodeURIComponent(thumbnailUrl) : ""
         onClicked: root.thumbnailClicked()
     }
 
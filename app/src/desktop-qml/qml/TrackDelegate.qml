@@ -50,7 +50,9 @@ ItemDelegate {
         
         Image {
             anchors.fill: parent
-            source: view.model.data(styleData.row, "thumbnailUrl")
+            sourceSize.width: width
+            sourceSize.height: height
+            source: view.model.data(styleData.row, "thumbnailUrl") ? "image://images/" + encodeURIComponent(view.model.data(styleData.row, "thumbnailUrl")) : ""
             smooth: true
         }
     }
@@ -24,7 +24,7 @@ Rectangle {
     id: root
     
     property string trackId
-    property alias thumbnail: thumbnail.source
+    property string thumbnail
     property alias title: titleLabel.text
     property alias artist: artistLabel.text
     property alias genre: genreLabel.text
@@ -52,6 +52,9 @@ Rectangle {
             margins: 10
         }
         smooth: true
+        sourceSize.width: width
+        sourceSize.height: height
+        source: root.thumbnail ? "image://images/" + encodeURIComponent(root.thumbnail) : ""
     }
     
     GridLayout {
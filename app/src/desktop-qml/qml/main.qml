@@ -470,7 +470,10 @@ ApplicationWindow {
                 bottom: parent.bottom
                 margins: 5
             }
-            source: player.currentTrack ? player.currentTrack.thumbnailUrl : ""
+            sourceSize.width: width
+            sourceSize.height: height
+            source: (player.currentTrack) && (player.currentTrack.thumbnailUrl)
+                    ? "image://images/" + encodeURIComponent(player.currentTrack.thumbnailUrl) : ""
         }
         
         ColumnLayout {
@@ -526,6 +529,7 @@ ApplicationWindow {
         id: player
         
         onStatusChanged: if (status == AudioPlayer.Failed) messageBox.showError(errorString);
+        Component.onCompleted: restoreQueue()
     }
         
     Loader {
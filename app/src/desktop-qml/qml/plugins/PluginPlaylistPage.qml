@@ -66,7 +66,9 @@ Page {
                         margins: 10
                     }
                     smooth: true
-                    source: playlist.thumbnailUrl
+                    sourceSize.width: width
+                    sourceSize.height: height
+                    source: playlist.thumbnailUrl ? "image://images/" + encodeURIComponent(playlist.thumbnailUrl) : ""
                 }
                 
                 ColumnLayout {
@@ -66,7 +66,9 @@ Page {
                         margins: 10
                     }
                     smooth: true
-                    source: track.thumbnailUrl
+                    sourceSize.width: width
+                    sourceSize.height: height
+                    source: track.thumbnailUrl ? "image://images/" + encodeURIComponent(track.thumbnailUrl) : ""
                 }
                 
                 ColumnLayout {
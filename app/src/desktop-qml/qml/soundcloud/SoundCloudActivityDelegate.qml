@@ -51,7 +51,9 @@ ItemDelegate {
         
         Image {
             anchors.fill: parent
-            source: view.model.data(styleData.row, "originThumbnailUrl")
+            sourceSize.width: width
+            sourceSize.height: height
+            source: view.model.data(styleData.row, "originThumbnailUrl") ? "image://images/" + encodeURIComponent(view.model.data(styleData.row, "originThumbnailUrl")) : ""
             smooth: true
         }
     }
@@ -24,7 +24,7 @@ Rectangle {
     id: root
     
     property string activityId
-    property alias thumbnail: thumbnail.source
+    property string thumbnail
     property alias title: titleLabel.text
     property alias type: typeLabel.text
     property alias description: descriptionLabel.text
@@ -49,6 +49,9 @@ Rectangle {
             margins: 10
         }
         smooth: true
+        sourceSize.width: width
+        sourceSize.height: height
+        source: root.thumbnail ? "image://images/" + encodeURIComponent(root.thumbnail) : ""
     }
     
     GridLayout {
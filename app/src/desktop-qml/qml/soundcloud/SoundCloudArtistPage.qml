@@ -80,7 +80,9 @@ Page {
                         margins: 10
                     }
                     smooth: true
-                    source: artist.thumbnailUrl
+                    sourceSize.width: width
+                    sourceSize.height: height
+                    source: artist.thumbnailUrl ? "image://images/" + encodeURIComponent(artist.thumbnailUrl) : ""
                 }
                 
                 Button {
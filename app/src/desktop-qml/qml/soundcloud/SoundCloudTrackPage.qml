@@ -62,7 +62,9 @@ Page {
                         margins: 10
                     }
                     smooth: true
-                    source: track.thumbnailUrl
+                    sourceSize.width: width
+                    sourceSize.height: height
+                    source: track.thumbnailUrl ? "image://images/" + encodeURIComponent(track.thumbnailUrl) : ""
                 }
                 
                 ColumnLayout {
@@ -30,6 +30,9 @@ static const int MAX_REDIRECTS = 8;
 
 static const int MAX_RESULTS = 20;
 
+static const int DEFAULT_AUDIO_CACHE_SIZE = 100; // MB
+static const int DEFAULT_IMAGE_CACHE_SIZE = 20; // MB
+
 static const int LARGE_THUMBNAIL_SIZE = 500;
 static const int THUMBNAIL_SIZE = 64;
 
@@ -44,6 +47,7 @@ static const QStringList SUPPORTED_AUDIO_FORMATS = QStringList() << "*.aiff" <<
 static const QString DATABASE_PATH(QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + "/MusiKloud2/");
 static const QString DOWNLOAD_PATH("/home/user/MyDocs/MusiKloud2/");
 static const QString STORAGE_PATH(QStandardPaths::writableLocation(QStandardPaths::ConfigLocation) + "/MusiKloud2/");
+static const QString CACHE_PATH(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/MusiKloud2/");
 static const QStringList PLUGIN_PATHS = QStringList() << "/opt/musikloud2/plugins/"
                                                       << QStandardPaths::writableLocation(QStandardPaths::ConfigLocation)
                                                          + "/MusiKloud2/plugins/";
@@ -51,6 +55,7 @@ static const QStringList PLUGIN_PATHS = QStringList() << "/opt/musikloud2/plugin
 static const QString DATABASE_PATH(QDesktopServices::storageLocation(QDesktopServices::HomeLocation) + "/.config/MusiKloud2/");
 static const QString DOWNLOAD_PATH("/home/user/MyDocs/MusiKloud2/");
 static const QString STORAGE_PATH(QDesktopServices::storageLocation(QDesktopServices::HomeLocation) + "/.config/MusiKloud2/");
+static const QString CACHE_PATH(QDesktopServices::storageLocation(QDesktopServices::HomeLocation) + "/.cache/MusiKloud2/");
 static const QStringList PLUGIN_PATHS = QStringList() << "/opt/musikloud2/plugins/"
                                                       << QDesktopServices::storageLocation(QDesktopServices::HomeLocation)
                                                          + "/.config/MusiKloud2/plugins/";
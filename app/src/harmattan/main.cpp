@@ -15,6 +15,7 @@
  */
 
 #include "activecolormodel.h"
+#include "audiocache.h"
 #include "audioplayer.h"
 #include "categorymodel.h"
 #include "categorynamemodel.h"
@@ -24,6 +25,10 @@
 #include "database.h"
 #include "dbusservice.h"
 #include "definitions.h"
+#include "imagediskcache.h"
+#include "locallibrary.h"
+#include "imageprovider.h"
+#include "localtrackmodel.h"
 #include "maskeditem.h"
 #include "networkaccessmanagerfactory.h"
 #include "networkproxytypemodel.h"
@@ -53,6 +58,7 @@
 #include "soundcloudplaylistmodel.h"
 #include "soundcloudsearchtypemodel.h"
 #include "soundcloudstreammodel.h"
+#include "soundcloudsync.h"
 #include "soundcloudtrackmodel.h"
 #include "transfers.h"
 #include "utils.h"
@@ -74,6 +80,7 @@ inline void registerTypes() {
     qmlRegisterType<CategoryNameModel>("MusiKloud", 2, 0, "CategoryNameModel");
     qmlRegisterType<ConcurrentTransfersModel>("MusiKloud", 2, 0, "ConcurrentTransfersModel");
     qmlRegisterType<MaskedItem>("MusiKloud", 2, 0, "MaskedItem");
+    qmlRegisterType<LocalTrackModel>("MusiKloud", 2, 0, "LocalTrackModel");
     qmlRegisterType<MKTrack>("MusiKloud", 2, 0, "Track");
     qmlRegisterType<NetworkProxyTypeModel>("MusiKloud", 2, 0, "NetworkProxyTypeModel");
     qmlRegisterType<PluginArtist>("MusiKloud", 2, 0, "PluginArtist");
@@ -123,13 +130,17 @@ Q_DECL_EXPORT int main(int argc, char *argv[]) {
     app.data()->setApplicationVersion(VERSION_NUMBER);
 
     Settings settings;
+    AudioCache audioCache;
     Clipboard clipboard;
     DBusService dbus;
+    ImageDiskCache imageCache;
+    LocalLibrary localLibrary;
     NetworkAccessManagerFactory factory;
     Resources resources;
     ResourcesPlugins plugins;
     ShareUi shareui;
     SoundCloud soundcloud;
+    SoundCloudSync soundcloudSync;
     Transfers transfers;
     Utils utils;
         
@@ -137,6 +148,8 @@ Q_DECL_EXPORT int main(int argc, char *argv[]) {
     registerTypes();
     plugins.load();
     settings.setNetworkProxy();
+    localLibrary.rescan();
+    soundcloudSync.sync();
     
     QDeclarativeView view;
     QDeclarativeContext *context = view.rootContext();
@@ -144,6 +157,7 @@ Q_DECL_EXPORT int main(int argc, char *argv[]) {
     context->setContextProperty("Clipboard", &clipboard);
     context->setContextProperty("CookieJar", factory.cookieJar());
     context->setContextProperty("DBus", &dbus);
+    context->setContextProperty("LocalLibrary", &localLibrary);
     context->setContextProperty("MainWindow", &view);
     context->setContextProperty("Plugins", &plugins);
     context->setContextProperty("Resources", &resources);
@@ -156,6 +170,7 @@ Q_DECL_EXPORT int main(int argc, char *argv[]) {
     context->setContextProperty("VERSION_NUMBER", VERSION_NUMBER);
 
     view.engine()->setNetworkAccessManagerFactory(&factory);
+    view.engine()->addImageProvider("images", new ImageProvider);
     
     view.setViewport(new QGLWidget);
     view.setSource(QUrl::fromLocalFile("/opt/musikloud2/qml/main.qml"));
@@ -34,7 +34,7 @@ ListItem {
             leftMargin: UI.PADDING_DOUBLE
             verticalCenter: parent.verticalCenter
         }
-        source: thumbnailUrl
+        source: thumbnailUrl ? "image://images/" + encodeURIComponent(thumbnailUrl) : ""
         enabled: false
     }
 
@@ -37,7 +37,7 @@ ListItem {
             top: parent.top
             margins: UI.PADDING_DOUBLE
         }
-        source: thumbnailUrl ? thumbnailUrl : "images/avatar.png"
+        source: thumbnailUrl ? "image://images/" + encodeURIComponent(thumbnailUrl) : "images/avatar.png"
         onClicked: root.thumbnailClicked()
     }
 
@@ -86,7 +86,9 @@ MyPage {
             left: parent.left
             leftMargin: appWindow.inPortrait ? 0 : UI.PADDING_DOUBLE
         }
-        source: player.currentTrack.largeThumbnailUrl
+        sourceSize.width: width
+        sourceSize.height: height
+        source: player.currentTrack.largeThumbnailUrl ? "image://images/" + encodeURIComponent(player.currentTrack.largeThumbnailUrl) : ""
         placeholderText: player.currentTrack.title
         swipeEnabled: true
         onClicked: root.showQueue = true
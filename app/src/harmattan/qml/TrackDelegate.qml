@@ -37,7 +37,9 @@ ListItem {
             leftMargin: UI.PADDING_DOUBLE
             verticalCenter: parent.verticalCenter
         }
-        source: thumbnailUrl
+        sourceSize.width: width
+        sourceSize.height: height
+        source: thumbnailUrl ? "image://images/" + encodeURIComponent(thumbnailUrl) : ""
         placeholderText: title
         onClicked: root.thumbnailClicked()
     }
@@ -51,6 +51,7 @@ AppWindow {
         id: player
         
         onStatusChanged: if (status == AudioPlayer.Failed) infoBanner.showMessage(errorString);
+        Component.onCompleted: restoreQueue()
     }
 
     Connections {
@@ -88,7 +88,7 @@ MyPage {
 
                     width: height
                     height: Math.floor(parent.width / 4)
-                    source: artist.thumbnailUrl
+                    source: artist.thumbnailUrl ? "image://images/" + encodeURIComponent(artist.thumbnailUrl) : ""
                     enabled: false
                 }
 
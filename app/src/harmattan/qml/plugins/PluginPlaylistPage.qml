@@ -118,7 +118,9 @@ MyPage {
                     z: 10
                     width: 150
                     height: 150
-                    source: playlist.largeThumbnailUrl
+                    sourceSize.width: width
+                    sourceSize.height: height
+                    source: playlist.largeThumbnailUrl ? "image://images/" + encodeURIComponent(playlist.largeThumbnailUrl) : ""
                     placeholderText: playlist.title
                     enabled: tracksTab.model.count > 0
                     onClicked: {
@@ -130,7 +130,9 @@ MyPage {
                     z: 10
                     width: 150
                     height: 150
-                    source: track.largeThumbnailUrl
+                    sourceSize.width: width
+                    sourceSize.height: height
+                    source: track.largeThumbnailUrl ? "image://images/" + encodeURIComponent(track.largeThumbnailUrl) : ""
                     placeholderText: track.title
                     onClicked: {
                         player.clearQueue();
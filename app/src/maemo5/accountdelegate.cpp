@@ -15,6 +15,7 @@
  */
 
 #include "accountdelegate.h"
+#include "themecache.h"
 #include <QPainter>
 
 AccountDelegate::AccountDelegate(int activeRole, QObject *parent) :
@@ -31,6 +32,7 @@ void AccountDelegate::paint(QPainter *painter, const QStyleOptionViewItem &optio
         iconRect.moveLeft(iconRect.right() - 56);
         iconRect.moveTop(iconRect.top() + (iconRect.height() - 48) / 2);
         iconRect.setSize(QSize(48, 48));
-        painter->drawImage(iconRect, QImage("/usr/share/icons/hicolor/48x48/hildon/widgets_tickmark_grid.png"));
+        painter->drawPixmap(iconRect, ThemeCache::pixmap("/usr/share/icons/hicolor/48x48/hildon/widgets_tickmark_grid.png",
+                                                          iconRect.size()));
     }
 }
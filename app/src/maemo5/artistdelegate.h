@@ -28,13 +28,21 @@ class ArtistDelegate : public QStyledItemDelegate
 public:
     explicit ArtistDelegate(ImageCache *cache, int nameRole, int thumbnailRole, QObject *parent = 0);
     
+    bool renderCacheEnabled() const;
+    void setRenderCacheEnabled(bool enabled);
+    
     void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
         
 private:
+    void paintRow(QPainter *painter, const QRect &rect, const QModelIndex &index, bool pressed,
+                  const QPixmap &image) const;
+    
     ImageCache *m_cache;
     
     int m_nameRole;
     int m_thumbnailRole;
+    
+    bool m_renderCacheEnabled;
 };
 
 #endif // ARTISTDELEGATE_H
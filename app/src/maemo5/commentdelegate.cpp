@@ -17,6 +17,7 @@
 #include "commentdelegate.h"
 #include "drawing.h"
 #include "imagecache.h"
+#include "themecache.h"
 #include <QPainter>
 #include <QUrl>
 #include <QApplication>
@@ -75,16 +76,16 @@ bool CommentDelegate::editorEvent(QEvent *event, QAbstractItemModel *, const QSt
 
 void CommentDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
                                   const QModelIndex &index) const {
-    QPixmap background("/etc/hildon/theme/images/ContactsAppletBubble.png");
+    const QPixmap background = ThemeCache::pixmap("/etc/hildon/theme/images/ContactsAppletBubble.png");
     
     if (!background.isNull()) {
         qDrawBorderPixmap(painter, option.rect, QMargins(30, 60, 30, 30), background);
     }
     
-    QImage image = m_cache->image(index.data(m_thumbnailRole).toString(), QSize(40, 40));
+    QPixmap image = m_cache->pixmap(index.data(m_thumbnailRole).toString(), QSize(40, 40));
     
     if (image.isNull()) {
-        image = QImage("/usr/share/icons/hicolor/48x48/hildon/general_default_avatar.png");
+        image = ThemeCache::pixmap("/usr/share/icons/hicolor/48x48/hildon/general_default_avatar.png", QSize(40, 40));
     }
     
     QRect imageRect = option.rect;
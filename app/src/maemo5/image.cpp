@@ -80,7 +80,7 @@ void Image::setTransformationMode(Qt::TransformationMode mode) {
 
 void Image::paintEvent(QPaintEvent *) {    
     if (source().isValid()) {    
-        QImage image = m_cache->image(source(), size(), aspectRatioMode(), transformationMode());
+        QPixmap image = m_cache->pixmap(source(), size(), aspectRatioMode(), transformationMode());
         
         if (!image.isNull()) {
             QPainter painter(this);
@@ -90,7 +90,7 @@ void Image::paintEvent(QPaintEvent *) {
     }
     
     if (fallbackSource().isValid()) {    
-        QImage image = m_cache->image(fallbackSource(), size(), aspectRatioMode(), transformationMode());
+        QPixmap image = m_cache->pixmap(fallbackSource(), size(), aspectRatioMode(), transformationMode());
         
         if (!image.isNull()) {
             QPainter painter(this);
@@ -15,15 +15,27 @@
  */
 
 #include "listview.h"
+#include "imagecache.h"
 #include <QMouseEvent>
 #include <QScrollBar>
+#include <QTimer>
 #include <QAbstractKineticScroller>
 
+// Wait for scrolling to settle before re-prioritizing thumbnails
+static const int THUMBNAIL_UPDATE_INTERVAL = 100;
+
 ListView::ListView(QWidget *parent) :
     QListView(parent),
     m_kineticScroller(property("kineticScroller").value<QAbstractKineticScroller *>()),
-    m_clearCurrent(true)
+    m_clearCurrent(true),
+    m_cache(0),
+    m_thumbnailRole(-1),
+    m_thumbnailTimer(new QTimer(this))
 {
+    m_thumbnailTimer->setSingleShot(true);
+    m_thumbnailTimer->setInterval(THUMBNAIL_UPDATE_INTERVAL);
+    connect(m_thumbnailTimer, SIGNAL(timeout()), this, SLOT(updateVisibleThumbnails()));
+    
     setUniformItemSizes(true);
     setAutoScroll(false);
     setEditTriggers(QListView::NoEditTriggers);
@@ -42,6 +54,12 @@ void ListView::setClearCurrentIndexOnMouseRelease(bool enabled) {
     }
 }
 
+void ListView::setImageCache(ImageCache *cache, int thumbnailRole, const QSize &thumbnailSize) {
+    m_cache = cache;
+    m_thumbnailRole = thumbnailRole;
+    m_thumbnailSize = thumbnailSize;
+}
+
 void ListView::positionAtBeginning() {
     scrollTo(model()->index(0, 0), QListView::PositionAtTop);
 }
@@ -88,3 +106,61 @@ void ListView::mouseReleaseEvent(QMouseEvent *e) {
         setCurrentIndex(QModelIndex());
     }
 }
+
+void ListView::resizeEvent(QResizeEvent *e) {
+    QListView::resizeEvent(e);
+    
+    if (m_cache) {
+        m_thumbnailTimer->start();
+    }
+}
+
+void ListView::rowsInserted(const QModelIndex &parent, int start, int end) {
+    QListView::rowsInserted(parent, start, end);
+    
+    if (!m_cache) {
+        return;
+    }
+    
+    // Rows are usually inserted a page at a time by fetchMore(), so queue their thumbnails
+    // before they are scrolled into view
+    for (int i = start; i <= end; i++) {
+        m_cache->prefetch(QUrl(model()->index(i, 0, parent).data(m_thumbnailRole).toString()), m_thumbnailSize);
+    }
+    
+    m_thumbnailTimer->start();
+}
+
+void ListView::scrollContentsBy(int dx, int dy) {
+    QListView::scrollContentsBy(dx, dy);
+    
+    if (m_cache) {
+        m_thumbnailTimer->start();
+    }
+}
+
+void ListView::updateVisibleThumbnails() {
+    if ((!m_cache) || (!model())) {
+        return;
+    }
+    
+    const QModelIndex first = indexAt(QPoint(0, 0));
+    
+    if (!first.isValid()) {
+        return;
+    }
+    
+    QModelIndex last = indexAt(QPoint(0, viewport()->height() - 1));
+    
+    if (!last.isValid()) {
+        last = model()->index(model()->rowCount() - 1, 0);
+    }
+    
+    QList<QUrl> urls;
+    
+    for (int i = first.row(); i <= last.row(); i++) {
+        urls << QUrl(model()->index(i, 0).data(m_thumbnailRole).toString());
+    }
+    
+    m_cache->setVisibleUrls(urls);
+}
@@ -19,7 +19,9 @@
 
 #include <QListView>
 
+class ImageCache;
 class QAbstractKineticScroller;
+class QTimer;
 
 class ListView : public QListView
 {
@@ -34,6 +36,8 @@ public:
     bool clearCurrentIndexOnMouseRelease() const;
     void setClearCurrentIndexOnMouseRelease(bool enabled);
     
+    void setImageCache(ImageCache *cache, int thumbnailRole, const QSize &thumbnailSize = QSize(64, 64));
+    
 public Q_SLOTS:
     void positionAtBeginning();
     void positionAtEnd();
@@ -42,10 +46,21 @@ protected:
     void keyPressEvent(QKeyEvent *e);
     void mousePressEvent(QMouseEvent *e);
     void mouseReleaseEvent(QMouseEvent *e);
+    void resizeEvent(QResizeEvent *e);
+    void rowsInserted(const QModelIndex &parent, int start, int end);
+    void scrollContentsBy(int dx, int dy);
+
+private Q_SLOTS:
+    void updateVisibleThumbnails();
 
 private:
     QAbstractKineticScroller *m_kineticScroller;
     bool m_clearCurrent;
+    
+    ImageCache *m_cache;
+    int m_thumbnailRole;
+    QSize m_thumbnailSize;
+    QTimer *m_thumbnailTimer;
 };
 
 #endif // LISTVIEW_H
@@ -14,15 +14,18 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "audiocache.h"
 #include "audioplayer.h"
 #include "clipboard.h"
 #include "database.h"
 #include "dbusservice.h"
+#include "imagediskcache.h"
 #include "mainwindow.h"
 #include "resourcesplugins.h"
 #include "screen.h"
 #include "settings.h"
 #include "soundcloud.h"
+#include "soundcloudsync.h"
 #include "transfers.h"
 #include <QApplication>
 #include <QSsl>
@@ -38,18 +41,23 @@ int main(int argc, char *argv[]) {
     QSslConfiguration::setDefaultConfiguration(config);
 
     Settings settings;
+    AudioCache audioCache;
     AudioPlayer player;
     Clipboard clipboard;
     DBusService dbus;
+    ImageDiskCache imageCache;
     ResourcesPlugins plugins;
     Screen screen;
     SoundCloud soundcloud;
+    SoundCloudSync soundcloudSync;
     Transfers transfers;
     
     initDatabase();
     plugins.load();
     settings.setNetworkProxy();
     transfers.restoreTransfers();
+    player.restoreQueue();
+    soundcloudSync.sync();
     
     MainWindow window;
     window.show();
@@ -68,6 +68,8 @@ MainWindow::MainWindow(StackedWindow *parent) :
     connect(m_transfersAction, SIGNAL(triggered()), this, SLOT(showTransfers()));
     connect(m_settingsAction, SIGNAL(triggered()), this, SLOT(showSettingsDialog()));
     connect(m_aboutAction, SIGNAL(triggered()), this, SLOT(showAboutDialog()));
+    connect(AudioPlayer::instance(), SIGNAL(folderScanFinished(int)), this, SLOT(onFolderScanFinished(int)));
+    connect(AudioPlayer::instance(), SIGNAL(scanningFolderChanged(bool)), this, SLOT(onScanningFolderChanged(bool)));
     connect(AudioPlayer::instance(), SIGNAL(statusChanged(AudioPlayer::Status)),
             this, SLOT(onPlayerStatusChanged(AudioPlayer::Status)));
     connect(Transfers::instance(), SIGNAL(transferAdded(Transfer*)), this, SLOT(onTransferAdded(Transfer*)));
@@ -126,13 +128,10 @@ void MainWindow::playFolder() {
                                                        QFileDialog::ShowDirsOnly | QFileDialog::ReadOnly);
     
     if (!folder.isEmpty()) {
-        if (AudioPlayer::instance()->playFolder(folder)) {
-            NowPlayingWindow *window = new NowPlayingWindow(this);
-            window->show();
-        }
-        else {
-            QMaemo5InformationBox::information(this, tr("No tracks added"));
-        }
+        // Playback starts with the first track found, while the rest of the folder is scanned
+        AudioPlayer::instance()->playFolder(folder, true);
+        NowPlayingWindow *window = new NowPlayingWindow(this);
+        window->show();
     }
 }
 
@@ -141,15 +140,7 @@ void MainWindow::queueFolder() {
                                                        QFileDialog::ShowDirsOnly | QFileDialog::ReadOnly);
     
     if (!folder.isEmpty()) {
-        const int count = AudioPlayer::instance()->queueCount();
-        
-        if (AudioPlayer::instance()->addFolder(folder)) {
-            QMaemo5InformationBox::information(this, tr("%1 tracks added to playback queue")
-                                              .arg(AudioPlayer::instance()->queueCount() - count));
-        }
-        else {
-            QMaemo5InformationBox::information(this, tr("No tracks added"));
-        }
+        AudioPlayer::instance()->addFolder(folder, true);
     }
 }
 
@@ -185,6 +176,24 @@ void MainWindow::showTransfers() {
     window->show();
 }
 
+void MainWindow::onFolderScanFinished(int count) {
+    if (count > 0) {
+        QMaemo5InformationBox::information(this, tr("%1 tracks added to playback queue").arg(count));
+    }
+    else {
+        QMaemo5InformationBox::information(this, tr("No tracks added"));
+    }
+}
+
+void MainWindow::onScanningFolderChanged(bool scanning) {
+    if (scanning) {
+        showProgressIndicator();
+    }
+    else {
+        hideProgressIndicator();
+    }
+}
+
 void MainWindow::onPlayerStatusChanged(AudioPlayer::Status status) {
     if (status == AudioPlayer::Failed) {
         QMessageBox::critical(this, tr("Error"), AudioPlayer::instance()->errorString());
@@ -53,6 +53,8 @@ private Q_SLOTS:
     void showSettingsDialog();
     void showTransfers();
     
+    void onFolderScanFinished(int count);
+    void onScanningFolderChanged(bool scanning);
     void onPlayerStatusChanged(AudioPlayer::Status status);
     
     void onTransferAdded(Transfer *transfer);
@@ -15,6 +15,7 @@
  */
 
 #include "navdelegate.h"
+#include "themecache.h"
 #include <QPainter>
 
 NavDelegate::NavDelegate(QObject *parent) :
@@ -29,5 +30,6 @@ void NavDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, c
     iconRect.moveLeft(iconRect.right() - 56);
     iconRect.moveTop(iconRect.top() + (iconRect.height() - 48) / 2);
     iconRect.setSize(QSize(48, 48));
-    painter->drawImage(iconRect, QImage("/usr/share/icons/hicolor/48x48/hildon/general_forward.png"));
+    painter->drawPixmap(iconRect, ThemeCache::pixmap("/usr/share/icons/hicolor/48x48/hildon/general_forward.png",
+                                                      iconRect.size()));
 }
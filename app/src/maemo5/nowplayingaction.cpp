@@ -15,6 +15,7 @@
  */
 
 #include "nowplayingaction.h"
+#include "coverart.h"
 #include "imagecache.h"
 #include "nowplayingwindow.h"
 #include "utils.h"
@@ -65,6 +66,7 @@ void NowPlayingButton::connectPlaybackSignals() {
     qDebug() << "NowPlayingButton::connectPlaybackSignals";
 #endif
     connect(AudioPlayer::instance(), SIGNAL(currentIndexChanged(int)), this, SLOT(onCurrentIndexChanged(int)));
+    connect(CoverArt::instance(), SIGNAL(thumbnailReady(QString, QUrl)), this, SLOT(onThumbnailReady(QString)));
     onCurrentIndexChanged(AudioPlayer::instance()->currentIndex());
 }
 
@@ -73,6 +75,7 @@ void NowPlayingButton::disconnectPlaybackSignals() {
     qDebug() << "NowPlayingButton::disconnectPlaybackSignals";
 #endif
     disconnect(AudioPlayer::instance(), SIGNAL(currentIndexChanged(int)), this, SLOT(onCurrentIndexChanged(int)));
+    disconnect(CoverArt::instance(), SIGNAL(thumbnailReady(QString, QUrl)), this, SLOT(onThumbnailReady(QString)));
 }
 
 void NowPlayingButton::showNowPlayingWindow() {
@@ -99,10 +102,10 @@ void NowPlayingButton::onCurrentIndexChanged(int index) {
             thumbnailUrl = Utils::findThumbnailUrl(track->url());
         }
                                
-        const QImage thumbnail = m_cache->image(thumbnailUrl, iconSize());
+        const QPixmap thumbnail = m_cache->pixmap(thumbnailUrl, iconSize());
     
         if (!thumbnail.isNull()) {
-            setIcon(QIcon(QPixmap::fromImage(thumbnail)));
+            setIcon(QIcon(thumbnail));
         }
         else {
             setIcon(QIcon::fromTheme("mediaplayer_default_album"));
@@ -121,13 +124,21 @@ void NowPlayingButton::onImageReady() {
             thumbnailUrl = Utils::findThumbnailUrl(track->url());
         }
         
-        const QImage thumbnail = m_cache->image(thumbnailUrl, iconSize());
+        const QPixmap thumbnail = m_cache->pixmap(thumbnailUrl, iconSize());
     
         if (!thumbnail.isNull()) {
-            setIcon(QIcon(QPixmap::fromImage(thumbnail)));
+            setIcon(QIcon(thumbnail));
             return;
         }
     }
     
     setIcon(QIcon::fromTheme("mediaplayer_default_album"));
 }
+
+void NowPlayingButton::onThumbnailReady(const QString &fileName) {
+    if (MKTrack *track = AudioPlayer::instance()->currentTrack()) {
+        if ((Utils::isLocalFile(track->url())) && (track->url().path() == fileName)) {
+            onCurrentIndexChanged(AudioPlayer::instance()->currentIndex());
+        }
+    }
+}
@@ -53,6 +53,7 @@ private Q_SLOTS:
     
     void onCurrentIndexChanged(int index);
     void onImageReady();
+    void onThumbnailReady(const QString &fileName);
 
 private:
     void connectPlaybackSignals();
@@ -16,6 +16,7 @@
  */
 
 #include "nowplayingdelegate.h"
+#include "themecache.h"
 #include "trackmodel.h"
 #include <QPainter>
 #include <QApplication>
@@ -26,12 +27,8 @@ NowPlayingDelegate::NowPlayingDelegate(QObject *parent) :
 }
 
 void NowPlayingDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const {
-    if ((option.state) & (QStyle::State_Selected)) {
-        painter->drawImage(option.rect, QImage("/etc/hildon/theme/images/TouchListBackgroundPressed.png"));
-    }
-    else {
-        painter->drawImage(option.rect, QImage("/etc/hildon/theme/images/TouchListBackgroundNormal.png"));
-    }
+    painter->drawPixmap(option.rect.topLeft(), ThemeCache::listBackground((option.state) & (QStyle::State_Selected),
+                                                                          option.rect.size()));
 
     QRect textRect = option.rect;
     textRect.setLeft(textRect.left() + 8);
@@ -16,6 +16,7 @@
  */
 
 #include "nowplayingwindow.h"
+#include "coverart.h"
 #include "image.h"
 #include "nowplayingdelegate.h"
 #include "screen.h"
@@ -175,6 +176,7 @@ void NowPlayingWindow::connectPlaybackSignals() {
     connect(AudioPlayer::instance(), SIGNAL(seekableChanged(bool)), this, SLOT(onSeekableChanged(bool)));
     connect(AudioPlayer::instance(), SIGNAL(statusChanged(AudioPlayer::Status)),
             this, SLOT(onStatusChanged(AudioPlayer::Status)));
+    connect(CoverArt::instance(), SIGNAL(thumbnailReady(QString, QUrl)), this, SLOT(onThumbnailReady(QString, QUrl)));
     
     onCurrentIndexChanged(AudioPlayer::instance()->currentIndex());
     onDurationChanged(AudioPlayer::instance()->duration());
@@ -194,6 +196,8 @@ void NowPlayingWindow::disconnectPlaybackSignals() {
     disconnect(AudioPlayer::instance(), SIGNAL(seekableChanged(bool)), this, SLOT(onSeekableChanged(bool)));
     disconnect(AudioPlayer::instance(), SIGNAL(statusChanged(AudioPlayer::Status)),
                this, SLOT(onStatusChanged(AudioPlayer::Status)));
+    disconnect(CoverArt::instance(), SIGNAL(thumbnailReady(QString, QUrl)),
+               this, SLOT(onThumbnailReady(QString, QUrl)));
 }
 
 void NowPlayingWindow::removeTrack() {
@@ -347,3 +351,12 @@ void NowPlayingWindow::onScreenLockStateChanged(bool isLocked) {
         connectPlaybackSignals();
     }
 }
+
+void NowPlayingWindow::onThumbnailReady(const QString &fileName, const QUrl &url) {
+    if (MKTrack *track = AudioPlayer::instance()->currentTrack()) {
+        if ((track->largeThumbnailUrl().isEmpty()) && (Utils::isLocalFile(track->url()))
+            && (track->url().path() == fileName)) {
+            m_thumbnail->setSource(url);
+        }
+    }
+}
@@ -58,6 +58,7 @@ private Q_SLOTS:
     void onSeekableChanged(bool isSeekable);
     void onStatusChanged(AudioPlayer::Status status);
     void onScreenLockStateChanged(bool isLocked);
+    void onThumbnailReady(const QString &fileName, const QUrl &url);
 
 private:
     void connectPlaybackSignals();
@@ -17,8 +17,10 @@
 #include "playlistdelegate.h"
 #include "drawing.h"
 #include "imagecache.h"
+#include "themecache.h"
 #include <QPainter>
 #include <QApplication>
+#include <QPixmapCache>
 
 PlaylistDelegate::PlaylistDelegate(ImageCache *cache, int artistRole, int dateRole, int thumbnailRole, int titleRole,
                                    int trackCountRole, QObject *parent) :
@@ -28,31 +30,67 @@ PlaylistDelegate::PlaylistDelegate(ImageCache *cache, int artistRole, int dateRo
     m_dateRole(dateRole),
     m_thumbnailRole(thumbnailRole),
     m_titleRole(titleRole),
-    m_trackCountRole(trackCountRole)
+    m_trackCountRole(trackCountRole),
+    m_renderCacheEnabled(true)
 {
 }
 
+bool PlaylistDelegate::renderCacheEnabled() const {
+    return m_renderCacheEnabled;
+}
+
+void PlaylistDelegate::setRenderCacheEnabled(bool enabled) {
+    m_renderCacheEnabled = enabled;
+}
+
 void PlaylistDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const {
-    if ((option.state) & (QStyle::State_Selected)) {
-        painter->drawImage(option.rect, QImage("/etc/hildon/theme/images/TouchListBackgroundPressed.png"));
+    const bool pressed = (option.state) & (QStyle::State_Selected);
+    QPixmap image = m_cache->pixmap(index.data(m_thumbnailRole).toString(), QSize(64, 64));
+    
+    if (image.isNull()) {
+        image = ThemeCache::pixmap("/usr/share/icons/hicolor/64x64/hildon/mediaplayer_default_album.png");
     }
-    else {
-        painter->drawImage(option.rect, QImage("/etc/hildon/theme/images/TouchListBackgroundNormal.png"));
+    
+    if (!m_renderCacheEnabled) {
+        paintRow(painter, option.rect, index, pressed, image);
+        return;
     }
-   
-    QImage image = m_cache->image(index.data(m_thumbnailRole).toString(), QSize(64, 64));
     
-    if (image.isNull()) {
-        image = QImage("/usr/share/icons/hicolor/64x64/hildon/mediaplayer_default_album.png");
+    const QChar separator(0);
+    const QString key = QString("playlist") + separator + index.data(m_titleRole).toString()
+                        + separator + index.data(m_artistRole).toString()
+                        + separator + index.data(m_trackCountRole).toString()
+                        + separator + QString::number(image.cacheKey())
+                        + separator + QString::number(option.rect.width())
+                        + separator + QString::number(option.rect.height())
+                        + separator + QString::number(int(pressed)) + separator + painter->font().key();
+    QPixmap row;
+    
+    if (!QPixmapCache::find(key, &row)) {
+        row = QPixmap(option.rect.size());
+        row.fill(Qt::transparent);
+        QPainter rowPainter(&row);
+        rowPainter.setFont(painter->font());
+        rowPainter.setPen(painter->pen());
+        paintRow(&rowPainter, row.rect(), index, pressed, image);
+        rowPainter.end();
+        QPixmapCache::insert(key, row);
     }
     
-    QRect imageRect = option.rect;
+    painter->drawPixmap(option.rect.topLeft(), row);
+}
+
+void PlaylistDelegate::paintRow(QPainter *painter, const QRect &rect, const QModelIndex &index, bool pressed,
+                                const QPixmap &image) const {
+    painter->drawPixmap(rect.topLeft(), ThemeCache::listBackground(pressed, rect.size()));
+    
+    QRect imageRect = rect;
     imageRect.setLeft(imageRect.left() + 8);
     imageRect.setWidth(imageRect.height());
     
     drawCenteredImage(painter, imageRect, image);
     
-    QRect textRect = option.rect;
+    QRect textRect = rect;
     textRect.setLeft(imageRect.right() + 8);
     textRect.setRight(textRect.right() - 8);
     textRect.setTop(textRect.top() + 8);
@@ -29,16 +29,24 @@ public:
     explicit PlaylistDelegate(ImageCache *cache, int artistRole, int dateRole, int thumbnailRole, int titleRole,
                               int trackCountRole, QObject *parent = 0);
     
+    bool renderCacheEnabled() const;
+    void setRenderCacheEnabled(bool enabled);
+    
     void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
         
 private:
+    void paintRow(QPainter *painter, const QRect &rect, const QModelIndex &index, bool pressed,
+                  const QPixmap &image) const;
+    
     ImageCache *m_cache;
     
     int m_artistRole;
     int m_dateRole;
     int m_thumbnailRole;
     int m_titleRole;
-    int m_trackCountRole;    
+    int m_trackCountRole;
+    
+    bool m_renderCacheEnabled;
 };
 
 #endif // PLAYLISTDELEGATE_H
@@ -42,6 +42,7 @@ PluginArtistsWindow::PluginArtistsWindow(StackedWindow *parent) :
     m_view->setModel(m_model);
     m_view->setItemDelegate(new ArtistDelegate(m_cache, PluginArtistModel::NameRole, PluginArtistModel::ThumbnailUrlRole,
                                                m_view));
+    m_view->setImageCache(m_cache, PluginArtistModel::ThumbnailUrlRole);
 
     m_reloadAction->setEnabled(false);
     
@@ -44,6 +44,7 @@ PluginPlaylistsWindow::PluginPlaylistsWindow(StackedWindow *parent) :
                                                  PluginPlaylistModel::DateRole, PluginPlaylistModel::ThumbnailUrlRole,
                                                  PluginPlaylistModel::TitleRole, PluginPlaylistModel::TrackCountRole,
                                                  m_view));
+    m_view->setImageCache(m_cache, PluginPlaylistModel::ThumbnailUrlRole);
 
     m_reloadAction->setEnabled(false);
     
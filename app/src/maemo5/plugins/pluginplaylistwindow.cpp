@@ -125,6 +125,7 @@ void PluginPlaylistWindow::loadBaseUi() {
     
     m_view->setModel(m_model);
     m_view->setItemDelegate(m_delegate);
+    m_view->setImageCache(m_cache, PluginTrackModel::ThumbnailUrlRole);
     m_view->setContextMenuPolicy(Qt::CustomContextMenu);
     
     m_thumbnail->setFixedSize(320, 320);
@@ -214,12 +215,10 @@ void PluginPlaylistWindow::playPlaylist() {
         return;
     }
     
-    QList<MKTrack*> tracks;
+    QList<TrackRecord> tracks;
     
     for (int i = 0; i < m_model->rowCount(); i++) {
-        if (PluginTrack *track = m_model->get(i)) {
-            tracks << track;
-        }
+        tracks << m_model->record(i);
     }
     
     if (!tracks.isEmpty()) {
@@ -234,12 +233,10 @@ void PluginPlaylistWindow::queuePlaylist() {
         return;
     }
     
-    QList<MKTrack*> tracks;
+    QList<TrackRecord> tracks;
     
     for (int i = 0; i < m_model->rowCount(); i++) {
-        if (PluginTrack *track = m_model->get(i)) {
-            tracks << track;
-        }
+        tracks << m_model->record(i);
     }
     
     if (!tracks.isEmpty()) {
@@ -54,6 +54,7 @@ PluginTracksWindow::PluginTracksWindow(StackedWindow *parent) :
     
     m_view->setModel(m_model);
     m_view->setItemDelegate(m_delegate);
+    m_view->setImageCache(m_cache, PluginTrackModel::ThumbnailUrlRole);
     m_view->setContextMenuPolicy(Qt::CustomContextMenu);
 
     m_reloadAction->setEnabled(false);
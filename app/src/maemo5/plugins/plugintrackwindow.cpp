@@ -51,6 +51,7 @@ PluginTrackWindow::PluginTrackWindow(const QString &service, const QString &id,
     m_relatedModel(new PluginTrackModel(this)),
     m_commentModel(0),
     m_cache(new ImageCache),
+    m_commentCache(0),
     m_thumbnail(new Image(this)),
     m_avatar(new Image(this)),
     m_nowPlayingAction(new NowPlayingAction(this)),
@@ -93,6 +94,7 @@ PluginTrackWindow::PluginTrackWindow(PluginTrack *track, StackedWindow *parent)
     m_relatedModel(new PluginTrackModel(this)),
     m_commentModel(0),
     m_cache(new ImageCache),
+    m_commentCache(0),
     m_thumbnail(new Image(this)),
     m_avatar(new Image(this)),
     m_nowPlayingAction(new NowPlayingAction(this)),
@@ -136,6 +138,8 @@ PluginTrackWindow::PluginTrackWindow(PluginTrack *track, StackedWindow *parent)
 PluginTrackWindow::~PluginTrackWindow() {
     delete m_cache;
     m_cache = 0;
+    delete m_commentCache;
+    m_commentCache = 0;
 }
 
 void PluginTrackWindow::loadBaseUi() {
@@ -144,6 +148,7 @@ void PluginTrackWindow::loadBaseUi() {
     
     m_relatedView->setModel(m_relatedModel);
     m_relatedView->setItemDelegate(m_relatedDelegate);
+    m_relatedView->setImageCache(m_cache, PluginTrackModel::ThumbnailUrlRole);
     m_relatedView->setContextMenuPolicy(Qt::CustomContextMenu);
     
     m_thumbnail->setFixedSize(320, 320);
@@ -375,18 +380,23 @@ void PluginTrackWindow::showArtist(const QModelIndex &index) {
 void PluginTrackWindow::showComments() {
     if (!m_commentView) {
         m_commentView = new ListView(this);
-        m_commentDelegate = new CommentDelegate(m_cache, PluginCommentModel::ArtistRole, PluginCommentModel::BodyRole,
-                                                PluginCommentModel::DateRole, PluginCommentModel::ThumbnailUrlRole, this);
+        // A separate cache, so that scrolling either list does not cancel the thumbnails of the other
+        m_commentCache = new ImageCache;
+        m_commentDelegate = new CommentDelegate(m_commentCache, PluginCommentModel::ArtistRole,
+                                                PluginCommentModel::BodyRole, PluginCommentModel::DateRole,
+                                                PluginCommentModel::ThumbnailUrlRole, this);
         m_commentModel = new PluginCommentModel(this);
         m_commentModel->setService(m_track->service());
         m_commentView->setUniformItemSizes(false);
         m_commentView->setModel(m_commentModel);
         m_commentView->setItemDelegate(m_commentDelegate);
+        m_commentView->setImageCache(m_commentCache, PluginCommentModel::ThumbnailUrlRole, QSize(40, 40));
         m_noCommentsLabel = new QLabel(QString("<p align='center'; style='font-size: 40px; color: %1'>%2</p>")
                                       .arg(palette().color(QPalette::Mid).name()).arg(tr("No comments found")), this);
         m_stack->addWidget(m_commentView);
         m_stack->addWidget(m_noCommentsLabel);
         
+        connect(m_commentCache, SIGNAL(imageReady()), this, SLOT(onImageReady()));
         connect(m_commentDelegate, SIGNAL(thumbnailClicked(QModelIndex)), this, SLOT(showArtist(QModelIndex)));
         connect(m_commentModel, SIGNAL(statusChanged(ResourcesRequest::Status)),
                 this, SLOT(onCommentModelStatusChanged(ResourcesRequest::Status)));
@@ -90,6 +90,7 @@ private:
     PluginTrackModel *m_relatedModel;
     PluginCommentModel *m_commentModel;
     ImageCache *m_cache;
+    ImageCache *m_commentCache;
     
     Image *m_thumbnail;
     Image *m_avatar;
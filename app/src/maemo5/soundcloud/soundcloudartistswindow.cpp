@@ -43,6 +43,7 @@ SoundCloudArtistsWindow::SoundCloudArtistsWindow(StackedWindow *parent) :
     m_view->setModel(m_model);
     m_view->setItemDelegate(new ArtistDelegate(m_cache, SoundCloudArtistModel::NameRole,
                                                SoundCloudArtistModel::ThumbnailUrlRole, m_view));
+    m_view->setImageCache(m_cache, SoundCloudArtistModel::ThumbnailUrlRole);
     
     m_reloadAction->setEnabled(false);
     
@@ -45,6 +45,7 @@ SoundCloudPlaylistsWindow::SoundCloudPlaylistsWindow(StackedWindow *parent) :
                                                  SoundCloudPlaylistModel::ThumbnailUrlRole,
                                                  SoundCloudPlaylistModel::TitleRole,
                                                  SoundCloudPlaylistModel::TrackCountRole, m_view));
+    m_view->setImageCache(m_cache, SoundCloudPlaylistModel::ThumbnailUrlRole);
     m_reloadAction->setEnabled(false);
     
     m_label->hide();
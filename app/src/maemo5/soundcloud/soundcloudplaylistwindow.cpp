@@ -126,6 +126,7 @@ void SoundCloudPlaylistWindow::loadBaseUi() {
     
     m_view->setModel(m_model);
     m_view->setItemDelegate(m_delegate);
+    m_view->setImageCache(m_cache, SoundCloudTrackModel::ThumbnailUrlRole);
     m_view->setContextMenuPolicy(Qt::CustomContextMenu);
     
     m_thumbnail->setFixedSize(320, 320);
@@ -216,12 +217,10 @@ void SoundCloudPlaylistWindow::playPlaylist() {
         return;
     }
     
-    QList<MKTrack*> tracks;
+    QList<TrackRecord> tracks;
     
     for (int i = 0; i < m_model->rowCount(); i++) {
-        if (SoundCloudTrack *track = m_model->get(i)) {
-            tracks << track;
-        }
+        tracks << m_model->record(i);
     }
     
     if (!tracks.isEmpty()) {
@@ -236,12 +235,10 @@ void SoundCloudPlaylistWindow::queuePlaylist() {
         return;
     }
     
-    QList<MKTrack*> tracks;
+    QList<TrackRecord> tracks;
     
     for (int i = 0; i < m_model->rowCount(); i++) {
-        if (SoundCloudTrack *track = m_model->get(i)) {
-            tracks << track;
-        }
+        tracks << m_model->record(i);
     }
     
     if (!tracks.isEmpty()) {
@@ -57,6 +57,7 @@ SoundCloudTracksWindow::SoundCloudTracksWindow(StackedWindow *parent) :
     
     m_view->setModel(m_model);
     m_view->setItemDelegate(m_delegate);
+    m_view->setImageCache(m_cache, SoundCloudTrackModel::ThumbnailUrlRole);
     m_view->setContextMenuPolicy(Qt::CustomContextMenu);
 
     m_reloadAction->setEnabled(false);
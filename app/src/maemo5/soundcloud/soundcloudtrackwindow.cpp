@@ -54,6 +54,7 @@ SoundCloudTrackWindow::SoundCloudTrackWindow(const QString &id, StackedWindow *p
     m_relatedModel(new SoundCloudTrackModel(this)),
     m_commentModel(0),
     m_cache(new ImageCache),
+    m_commentCache(0),
     m_thumbnail(new Image(this)),
     m_avatar(new Image(this)),
     m_nowPlayingAction(new NowPlayingAction(this)),
@@ -99,6 +100,7 @@ SoundCloudTrackWindow::SoundCloudTrackWindow(SoundCloudTrack *track, StackedWind
     m_relatedModel(new SoundCloudTrackModel(this)),
     m_commentModel(0),
     m_cache(new ImageCache),
+    m_commentCache(0),
     m_thumbnail(new Image(this)),
     m_avatar(new Image(this)),
     m_nowPlayingAction(new NowPlayingAction(this)),
@@ -142,6 +144,8 @@ SoundCloudTrackWindow::SoundCloudTrackWindow(SoundCloudTrack *track, StackedWind
 SoundCloudTrackWindow::~SoundCloudTrackWindow() {
     delete m_cache;
     m_cache = 0;
+    delete m_commentCache;
+    m_commentCache = 0;
 }
 
 void SoundCloudTrackWindow::loadBaseUi() {
@@ -150,6 +154,7 @@ void SoundCloudTrackWindow::loadBaseUi() {
     
     m_relatedView->setModel(m_relatedModel);
     m_relatedView->setItemDelegate(m_relatedDelegate);
+    m_relatedView->setImageCache(m_cache, SoundCloudTrackModel::ThumbnailUrlRole);
     m_relatedView->setContextMenuPolicy(Qt::CustomContextMenu);
     
     m_thumbnail->setFixedSize(320, 320);
@@ -434,7 +439,9 @@ void SoundCloudTrackWindow::showArtist(const QModelIndex &index) {
 void SoundCloudTrackWindow::showComments() {
     if (!m_commentView) {
         m_commentView = new ListView(this);
-        m_commentDelegate = new CommentDelegate(m_cache, SoundCloudCommentModel::ArtistRole,
+        // A separate cache, so that scrolling either list does not cancel the thumbnails of the other
+        m_commentCache = new ImageCache;
+        m_commentDelegate = new CommentDelegate(m_commentCache, SoundCloudCommentModel::ArtistRole,
                                                 SoundCloudCommentModel::BodyRole,
                                                 SoundCloudCommentModel::DateRole,
                                                 SoundCloudCommentModel::ThumbnailUrlRole, this);
@@ -442,11 +449,13 @@ void SoundCloudTrackWindow::showComments() {
         m_commentView->setUniformItemSizes(false);
         m_commentView->setModel(m_commentModel);
         m_commentView->setItemDelegate(m_commentDelegate);
+        m_commentView->setImageCache(m_commentCache, SoundCloudCommentModel::ThumbnailUrlRole, QSize(40, 40));
         m_noCommentsLabel = new QLabel(QString("<p align='center'; style='font-size: 40px; color: %1'>%2</p>")
                                       .arg(palette().color(QPalette::Mid).name()).arg(tr("No comments found")), this);
         m_stack->addWidget(m_commentView);
         m_stack->addWidget(m_noCommentsLabel);
         
+        connect(m_commentCache, SIGNAL(imageReady()), this, SLOT(onImageReady()));
         connect(m_commentDelegate, SIGNAL(thumbnailClicked(QModelIndex)), this, SLOT(showArtist(QModelIndex)));
         connect(m_commentModel, SIGNAL(statusChanged(QSoundCloud::ResourcesRequest::Status)),
                 this, SLOT(onCommentModelStatusChanged(QSoundCloud::ResourcesRequest::Status)));
@@ -91,6 +91,7 @@ private:
     SoundCloudTrackModel *m_relatedModel;
     SoundCloudCommentModel *m_commentModel;
     ImageCache *m_cache;
+    ImageCache *m_commentCache;
     
     Image *m_thumbnail;
     Image *m_avatar;
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "themecache.h"
+#include <QImage>
+
+QHash<QString, QPixmap> ThemeCache::cache;
+
+QPixmap ThemeCache::pixmap(const QString &fileName, const QSize &size) {
+    const QString key = QString("%1|%2x%3").arg(fileName).arg(size.width()).arg(size.height());
+    QHash<QString, QPixmap>::const_iterator iterator = cache.constFind(key);
+    
+    if (iterator != cache.constEnd()) {
+        return iterator.value();
+    }
+    
+    QImage image(fileName);
+    
+    if ((!image.isNull()) && (size.isValid()) && (image.size() != size)) {
+        image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+    
+    // Converting to a pixmap uploads the image in the screen's native format
+    const QPixmap pixmap = QPixmap::fromImage(image);
+    cache.insert(key, pixmap);
+    return pixmap;
+}
+
+QPixmap ThemeCache::listBackground(bool pressed, const QSize &size) {
+    return pixmap(pressed ? "/etc/hildon/theme/images/TouchListBackgroundPressed.png"
+                          : "/etc/hildon/theme/images/TouchListBackgroundNormal.png", size);
+}
+
+void ThemeCache::clear() {
+    cache.clear();
+}
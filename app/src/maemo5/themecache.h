@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THEMECACHE_H
+#define THEMECACHE_H
+
+#include <QHash>
+#include <QPixmap>
+
+/*
+ * Loads theme assets and icons once, pre-scaled to the size at which they are drawn.
+ * Assets are held as pixmaps, so painting them needs no conversion or scaling.
+ */
+class ThemeCache
+{
+
+public:
+    static QPixmap pixmap(const QString &fileName, const QSize &size = QSize());
+    
+    static QPixmap listBackground(bool pressed, const QSize &size);
+    
+    static void clear();
+    
+private:
+    static QHash<QString, QPixmap> cache;
+};
+
+#endif // THEMECACHE_H
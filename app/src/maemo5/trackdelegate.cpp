@@ -17,9 +17,11 @@
 #include "trackdelegate.h"
 #include "drawing.h"
 #include "imagecache.h"
+#include "themecache.h"
 #include <QPainter>
 #include <QMouseEvent>
 #include <QApplication>
+#include <QPixmapCache>
 
 TrackDelegate::TrackDelegate(ImageCache *cache, int artistRole, int dateRole, int durationRole, int thumbnailRole,
                              int titleRole, QObject *parent) :
@@ -30,10 +32,19 @@ TrackDelegate::TrackDelegate(ImageCache *cache, int artistRole, int dateRole, in
     m_durationRole(durationRole),
     m_thumbnailRole(thumbnailRole),
     m_titleRole(titleRole),
-    m_pressedRow(-1)
+    m_pressedRow(-1),
+    m_renderCacheEnabled(true)
 {
 }
 
+bool TrackDelegate::renderCacheEnabled() const {
+    return m_renderCacheEnabled;
+}
+
+void TrackDelegate::setRenderCacheEnabled(bool enabled) {
+    m_renderCacheEnabled = enabled;
+}
+
 bool TrackDelegate::editorEvent(QEvent *event, QAbstractItemModel *, const QStyleOptionViewItem &option,
                                 const QModelIndex &index) {
 
@@ -71,26 +82,56 @@ bool TrackDelegate::editorEvent(QEvent *event, QAbstractItemModel *, const QStyl
 }
 
 void TrackDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const {
-    if (((option.state) & (QStyle::State_Selected))  && (m_pressedRow != index.row())) {
-        painter->drawImage(option.rect, QImage("/etc/hildon/theme/images/TouchListBackgroundPressed.png"));
+    const bool pressed = ((option.state) & (QStyle::State_Selected)) && (m_pressedRow != index.row());
+    QPixmap image = m_cache->pixmap(index.data(m_thumbnailRole).toString(), QSize(64, 64));
+    
+    if (image.isNull()) {
+        image = ThemeCache::pixmap("/usr/share/icons/hicolor/64x64/hildon/mediaplayer_default_album.png");
     }
-    else {
-        painter->drawImage(option.rect, QImage("/etc/hildon/theme/images/TouchListBackgroundNormal.png"));
+    
+    if (!m_renderCacheEnabled) {
+        paintRow(painter, option.rect, index, pressed, image);
+        return;
     }
-   
-    QImage image = m_cache->image(index.data(m_thumbnailRole).toString(), QSize(64, 64));
     
-    if (image.isNull()) {
-        image = QImage("/usr/share/icons/hicolor/64x64/hildon/mediaplayer_default_album.png");
+    // Rows are rendered once for each combination of data, size, state and thumbnail,
+    // so that kinetic scrolling only needs to blit the rendered pixmaps. The key is concatenated, since arg()
+    // would replace markers such as %1 in the data, and its fields are separated by a null character.
+    const QChar separator(0);
+    const QString key = QString("track") + separator + index.data(m_titleRole).toString()
+                        + separator + index.data(m_artistRole).toString()
+                        + separator + index.data(m_durationRole).toString()
+                        + separator + QString::number(image.cacheKey())
+                        + separator + QString::number(option.rect.width())
+                        + separator + QString::number(option.rect.height())
+                        + separator + QString::number(int(pressed)) + separator + painter->font().key();
+    QPixmap row;
+    
+    if (!QPixmapCache::find(key, &row)) {
+        row = QPixmap(option.rect.size());
+        row.fill(Qt::transparent);
+        QPainter rowPainter(&row);
+        rowPainter.setFont(painter->font());
+        rowPainter.setPen(painter->pen());
+        paintRow(&rowPainter, row.rect(), index, pressed, image);
+        rowPainter.end();
+        QPixmapCache::insert(key, row);
     }
     
-    QRect imageRect = option.rect;
+    painter->drawPixmap(option.rect.topLeft(), row);
+}
+
+void TrackDelegate::paintRow(QPainter *painter, const QRect &rect, const QModelIndex &index, bool pressed,
+                             const QPixmap &image) const {
+    painter->drawPixmap(rect.topLeft(), ThemeCache::listBackground(pressed, rect.size()));
+    
+    QRect imageRect = rect;
     imageRect.setLeft(imageRect.left() + 8);
     imageRect.setWidth(imageRect.height());
     
     drawCenteredImage(painter, imageRect, image);
     
-    QRect textRect = option.rect;
+    QRect textRect = rect;
     textRect.setLeft(imageRect.right() + 8);
     textRect.setRight(textRect.right() - 8);
     textRect.setTop(textRect.top() + 8);
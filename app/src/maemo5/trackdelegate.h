@@ -32,12 +32,18 @@ public:
     bool editorEvent(QEvent *event, QAbstractItemModel *, const QStyleOptionViewItem &option,
                      const QModelIndex &index);
     
+    bool renderCacheEnabled() const;
+    void setRenderCacheEnabled(bool enabled);
+    
     void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
     
 Q_SIGNALS:
     void thumbnailClicked(const QModelIndex &index);
     
 private:
+    void paintRow(QPainter *painter, const QRect &rect, const QModelIndex &index, bool pressed,
+                  const QPixmap &image) const;
+    
     ImageCache *m_cache;
     
     int m_artistRole;
@@ -47,6 +53,8 @@ private:
     int m_titleRole;
     
     int m_pressedRow;
+    
+    bool m_renderCacheEnabled;
 };
 
 #endif // TRACKDELEGATE_H
@@ -16,19 +16,45 @@
 
 #include "pluginartistmodel.h"
 #include "resources.h"
+#include "roletable.h"
+
+static const char* const ROLE_NAMES[] = {
+    "description",
+    "id",
+    "largeThumbnailUrl",
+    "name",
+    "service",
+    "thumbnailUrl",
+    0
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(RoleTable, roleTable, (PluginArtistModel::DescriptionRole, ROLE_NAMES))
+
+static QVariant artistData(const PluginArtist *artist, int role) {
+    switch (role) {
+    case PluginArtistModel::DescriptionRole:
+        return artist->description();
+    case PluginArtistModel::IdRole:
+        return artist->id();
+    case PluginArtistModel::LargeThumbnailUrlRole:
+        return artist->largeThumbnailUrl();
+    case PluginArtistModel::NameRole:
+        return artist->name();
+    case PluginArtistModel::ServiceRole:
+        return artist->service();
+    case PluginArtistModel::ThumbnailUrlRole:
+        return artist->thumbnailUrl();
+    default:
+        return QVariant();
+    }
+}
 
 PluginArtistModel::PluginArtistModel(QObject *parent) :
     QAbstractListModel(parent),
     m_request(new ResourcesRequest(this))
 {
-    m_roles[DescriptionRole] = "description";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[NameRole] = "name";
-    m_roles[ServiceRole] = "service";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
 #if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
+    setRoleNames(roleTable()->roleNames());
 #endif
     connect(m_request, SIGNAL(serviceChanged()), this, SIGNAL(serviceChanged()));
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
@@ -52,7 +78,7 @@ ResourcesRequest::Status PluginArtistModel::status() const {
 
 #if QT_VERSION >=0x050000
 QHash<int, QByteArray> PluginArtistModel::roleNames() const {
-    return m_roles;
+    return roleTable()->roleNames();
 }
 #endif
 
@@ -74,8 +100,8 @@ void PluginArtistModel::fetchMore(const QModelIndex &) {
 }
 
 QVariant PluginArtistModel::data(const QModelIndex &index, int role) const {
-    if (PluginArtist *artist = get(index.row())) {
-        return artist->property(m_roles[role]);
+    if (const PluginArtist *artist = get(index.row())) {
+        return artistData(artist, role);
     }
     
     return QVariant();
@@ -84,12 +110,9 @@ QVariant PluginArtistModel::data(const QModelIndex &index, int role) const {
 QMap<int, QVariant> PluginArtistModel::itemData(const QModelIndex &index) const {
     QMap<int, QVariant> map;
     
-    if (PluginArtist *artist = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = artist->property(iterator.value());
+    if ((index.row() >= 0) && (index.row() < rowCount())) {
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[role] = data(index, role);
         }
     }
     
@@ -97,19 +120,17 @@ QMap<int, QVariant> PluginArtistModel::itemData(const QModelIndex &index) const
 }
 
 QVariant PluginArtistModel::data(int row, const QByteArray &role) const {
-    if (PluginArtist *artist = get(row)) {
-        return artist->property(role);
-    }
-    
-    return QVariant();
+    return data(index(row), roleTable()->role(role));
 }
 
 QVariantMap PluginArtistModel::itemData(int row) const {
     QVariantMap map;
     
-    if (PluginArtist *artist = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = artist->property(role);
+    if ((row >= 0) && (row < rowCount())) {
+        const QModelIndex idx = index(row);
+        
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[roleTable()->name(role)] = data(idx, role);
         }
     }
     
@@ -96,8 +96,6 @@ private:
     QString m_next;
         
     QList<PluginArtist*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // PLUGINARTISTMODEL_H
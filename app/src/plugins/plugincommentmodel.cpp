@@ -16,20 +16,48 @@
 
 #include "plugincommentmodel.h"
 #include "resources.h"
+#include "roletable.h"
+
+static const char* const ROLE_NAMES[] = {
+    "artist",
+    "artistId",
+    "body",
+    "date",
+    "id",
+    "thumbnailUrl",
+    "trackId",
+    0
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(RoleTable, roleTable, (PluginCommentModel::ArtistRole, ROLE_NAMES))
+
+static QVariant commentData(const PluginComment *comment, int role) {
+    switch (role) {
+    case PluginCommentModel::ArtistRole:
+        return comment->artist();
+    case PluginCommentModel::ArtistIdRole:
+        return comment->artistId();
+    case PluginCommentModel::BodyRole:
+        return comment->body();
+    case PluginCommentModel::DateRole:
+        return comment->date();
+    case PluginCommentModel::IdRole:
+        return comment->id();
+    case PluginCommentModel::ThumbnailUrlRole:
+        return comment->thumbnailUrl();
+    case PluginCommentModel::TrackIdRole:
+        return comment->trackId();
+    default:
+        return QVariant();
+    }
+}
 
 PluginCommentModel::PluginCommentModel(QObject *parent) :
     QAbstractListModel(parent),
     m_request(new ResourcesRequest(this))
 {
-    m_roles[ArtistRole] = "artist";
-    m_roles[ArtistIdRole] = "artistId";
-    m_roles[BodyRole] = "body";
-    m_roles[DateRole] = "date";
-    m_roles[IdRole] = "id";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TrackIdRole] = "trackId";
 #if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
+    setRoleNames(roleTable()->roleNames());
 #endif
     connect(m_request, SIGNAL(serviceChanged()), this, SIGNAL(serviceChanged()));
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
@@ -53,7 +81,7 @@ ResourcesRequest::Status PluginCommentModel::status() const {
 
 #if QT_VERSION >=0x050000
 QHash<int, QByteArray> PluginCommentModel::roleNames() const {
-    return m_roles;
+    return roleTable()->roleNames();
 }
 #endif
 
@@ -75,8 +103,8 @@ void PluginCommentModel::fetchMore(const QModelIndex &) {
 }
 
 QVariant PluginCommentModel::data(const QModelIndex &index, int role) const {
-    if (PluginComment *comment = get(index.row())) {
-        return comment->property(m_roles[role]);
+    if (const PluginComment *comment = get(index.row())) {
+        return commentData(comment, role);
     }
     
     return QVariant();
@@ -85,12 +113,9 @@ QVariant PluginCommentModel::data(const QModelIndex &index, int role) const {
 QMap<int, QVariant> PluginCommentModel::itemData(const QModelIndex &index) const {
     QMap<int, QVariant> map;
     
-    if (PluginComment *comment = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = comment->property(iterator.value());
+    if ((index.row() >= 0) && (index.row() < rowCount())) {
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[role] = data(index, role);
         }
     }
     
@@ -98,19 +123,17 @@ QMap<int, QVariant> PluginCommentModel::itemData(const QModelIndex &index) const
 }
 
 QVariant PluginCommentModel::data(int row, const QByteArray &role) const {
-    if (PluginComment *comment = get(row)) {
-        return comment->property(role);
-    }
-    
-    return QVariant();
+    return data(index(row), roleTable()->role(role));
 }
 
 QVariantMap PluginCommentModel::itemData(int row) const {
     QVariantMap map;
     
-    if (PluginComment *comment = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = comment->property(role);
+    if ((row >= 0) && (row < rowCount())) {
+        const QModelIndex idx = index(row);
+        
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[roleTable()->name(role)] = data(idx, role);
         }
     }
     
@@ -97,8 +97,6 @@ private:
     QString m_next;
         
     QList<PluginComment*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // PLUGINCOMMENTMODEL_H
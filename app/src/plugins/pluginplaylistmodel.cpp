@@ -16,26 +16,66 @@
 
 #include "pluginplaylistmodel.h"
 #include "resources.h"
+#include "roletable.h"
+
+static const char* const ROLE_NAMES[] = {
+    "artist",
+    "artistId",
+    "date",
+    "description",
+    "duration",
+    "durationString",
+    "genre",
+    "id",
+    "largeThumbnailUrl",
+    "service",
+    "thumbnailUrl",
+    "title",
+    "trackCount",
+    0
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(RoleTable, roleTable, (PluginPlaylistModel::ArtistRole, ROLE_NAMES))
+
+static QVariant playlistData(const PluginPlaylist *playlist, int role) {
+    switch (role) {
+    case PluginPlaylistModel::ArtistRole:
+        return playlist->artist();
+    case PluginPlaylistModel::ArtistIdRole:
+        return playlist->artistId();
+    case PluginPlaylistModel::DateRole:
+        return playlist->date();
+    case PluginPlaylistModel::DescriptionRole:
+        return playlist->description();
+    case PluginPlaylistModel::DurationRole:
+        return playlist->duration();
+    case PluginPlaylistModel::DurationStringRole:
+        return playlist->durationString();
+    case PluginPlaylistModel::GenreRole:
+        return playlist->genre();
+    case PluginPlaylistModel::IdRole:
+        return playlist->id();
+    case PluginPlaylistModel::LargeThumbnailUrlRole:
+        return playlist->largeThumbnailUrl();
+    case PluginPlaylistModel::ServiceRole:
+        return playlist->service();
+    case PluginPlaylistModel::ThumbnailUrlRole:
+        return playlist->thumbnailUrl();
+    case PluginPlaylistModel::TitleRole:
+        return playlist->title();
+    case PluginPlaylistModel::TrackCountRole:
+        return playlist->trackCount();
+    default:
+        return QVariant();
+    }
+}
 
 PluginPlaylistModel::PluginPlaylistModel(QObject *parent) :
     QAbstractListModel(parent),
     m_request(new ResourcesRequest(this))
 {
-    m_roles[ArtistRole] = "artist";
-    m_roles[ArtistIdRole] = "artistId";
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[DurationRole] = "duration";
-    m_roles[DurationStringRole] = "durationString";
-    m_roles[GenreRole] = "genre";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[ServiceRole] = "service";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[TrackCountRole] = "trackCount";
 #if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
+    setRoleNames(roleTable()->roleNames());
 #endif
     connect(m_request, SIGNAL(serviceChanged()), this, SIGNAL(serviceChanged()));
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
@@ -59,7 +99,7 @@ ResourcesRequest::Status PluginPlaylistModel::status() const {
 
 #if QT_VERSION >=0x050000
 QHash<int, QByteArray> PluginPlaylistModel::roleNames() const {
-    return m_roles;
+    return roleTable()->roleNames();
 }
 #endif
 
@@ -81,8 +121,8 @@ void PluginPlaylistModel::fetchMore(const QModelIndex &) {
 }
 
 QVariant PluginPlaylistModel::data(const QModelIndex &index, int role) const {
-    if (PluginPlaylist *playlist = get(index.row())) {
-        return playlist->property(m_roles[role]);
+    if (const PluginPlaylist *playlist = get(index.row())) {
+        return playlistData(playlist, role);
     }
     
     return QVariant();
@@ -91,12 +131,9 @@ QVariant PluginPlaylistModel::data(const QModelIndex &index, int role) const {
 QMap<int, QVariant> PluginPlaylistModel::itemData(const QModelIndex &index) const {
     QMap<int, QVariant> map;
     
-    if (PluginPlaylist *playlist = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = playlist->property(iterator.value());
+    if ((index.row() >= 0) && (index.row() < rowCount())) {
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[role] = data(index, role);
         }
     }
     
@@ -104,19 +141,17 @@ QMap<int, QVariant> PluginPlaylistModel::itemData(const QModelIndex &index) cons
 }
 
 QVariant PluginPlaylistModel::data(int row, const QByteArray &role) const {
-    if (PluginPlaylist *playlist = get(row)) {
-        return playlist->property(role);
-    }
-    
-    return QVariant();
+    return data(index(row), roleTable()->role(role));
 }
 
 QVariantMap PluginPlaylistModel::itemData(int row) const {
     QVariantMap map;
     
-    if (PluginPlaylist *playlist = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = playlist->property(role);
+    if ((row >= 0) && (row < rowCount())) {
+        const QModelIndex idx = index(row);
+        
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[roleTable()->name(role)] = data(idx, role);
         }
     }
     
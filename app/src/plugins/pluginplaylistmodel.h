@@ -103,8 +103,6 @@ private:
     QString m_next;
         
     QList<PluginPlaylist*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // PLUGINPLAYLISTMODEL_H
@@ -46,6 +46,48 @@ PluginTrack::PluginTrack(PluginTrack *track, QObject *parent) :
 {
 }
 
+PluginTrack::PluginTrack(const TrackRecord &record, QObject *parent) :
+    MKTrack(record, parent),
+    m_request(new ResourcesRequest(this))
+{
+    connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
+}
+
+TrackRecord PluginTrack::toRecord(const QString &service, const QVariantMap &track) {
+    TrackRecord record;
+    record.setService(service);
+    record.setArtist(track.value("artist").toString());
+    record.setArtistId(track.value("artistId").toString());
+    record.setDate(track.value("date").toString());
+    record.setDescription(track.value("description").toString());
+    record.setDownloadable(track.value("downloadable", true).toBool());
+    record.setFormat(track.value("format").toString());
+    record.setGenre(track.value("genre").toString());
+    record.setId(track.value("id").toString());
+    record.setLargeThumbnailUrl(track.value("largeThumbnailUrl").toString());
+    record.setPlayCount(track.value("playCount").toLongLong());
+    record.setStreamUrl(track.value("streamUrl").toString());
+    record.setThumbnailUrl(track.value("thumbnailUrl").toString());
+    record.setTitle(track.value("title").toString());
+    record.setUrl(track.value("url").toString());
+    
+    if (track.value("duration").type() == QVariant::String) {
+        record.setDurationString(track.value("duration").toString());
+    }
+    else {
+        record.setDuration(track.value("duration").toLongLong());
+    }
+    
+    if (track.value("size").type() == QVariant::String) {
+        record.setSizeString(track.value("size").toString());
+    }
+    else {
+        record.setSize(track.value("size").toLongLong());
+    }
+    
+    return record;
+}
+
 QString PluginTrack::errorString() const {
     return m_request->errorString();
 }
@@ -66,35 +108,7 @@ void PluginTrack::loadTrack(const QString &service, const QString &id) {
 }
 
 void PluginTrack::loadTrack(const QString &service, const QVariantMap &track) {
-    setService(service);
-    setArtist(track.value("artist").toString());
-    setArtistId(track.value("artistId").toString());
-    setDate(track.value("date").toString());
-    setDescription(track.value("description").toString());
-    setDownloadable(track.value("downloadable", true).toBool());
-    setFormat(track.value("format").toString());
-    setGenre(track.value("genre").toString());
-    setId(track.value("id").toString());
-    setLargeThumbnailUrl(track.value("largeThumbnailUrl").toString());
-    setPlayCount(track.value("playCount").toLongLong());
-    setStreamUrl(track.value("streamUrl").toString());
-    setThumbnailUrl(track.value("thumbnailUrl").toString());
-    setTitle(track.value("title").toString());
-    setUrl(track.value("url").toString());
-        
-    if (track.value("duration").type() == QVariant::String) {
-        setDurationString(track.value("duration").toString());
-    }
-    else {
-        setDuration(track.value("duration").toLongLong());
-    }
-    
-    if (track.value("size").type() == QVariant::String) {
-        setSizeString(track.value("size").toString());
-    }
-    else {
-        setSize(track.value("size").toLongLong());
-    }
+    loadRecord(toRecord(service, track));
 }
 
 void PluginTrack::loadTrack(PluginTrack *track) {
@@ -32,6 +32,9 @@ public:
     explicit PluginTrack(const QString &service, const QString &id, QObject *parent = 0);
     explicit PluginTrack(const QString &service, const QVariantMap &track, QObject *parent = 0);
     explicit PluginTrack(PluginTrack *track, QObject *parent = 0);
+    explicit PluginTrack(const TrackRecord &record, QObject *parent = 0);
+    
+    static TrackRecord toRecord(const QString &service, const QVariantMap &track);
     
     QString errorString() const;
         
@@ -16,32 +16,87 @@
 
 #include "plugintrackmodel.h"
 #include "resources.h"
+#include "roletable.h"
+#include "trackrecordtask.h"
+#include <QThreadPool>
+
+static const char* const ROLE_NAMES[] = {
+    "artist",
+    "artistId",
+    "date",
+    "description",
+    "downloadable",
+    "duration",
+    "durationString",
+    "format",
+    "genre",
+    "id",
+    "largeThumbnailUrl",
+    "playCount",
+    "service",
+    "size",
+    "sizeString",
+    "streamUrl",
+    "thumbnailUrl",
+    "title",
+    "url",
+    0
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(RoleTable, roleTable, (PluginTrackModel::ArtistRole, ROLE_NAMES))
+
+template<class T>
+static QVariant trackData(const T &track, int role) {
+    switch (role) {
+    case PluginTrackModel::ArtistRole:
+        return track.artist();
+    case PluginTrackModel::ArtistIdRole:
+        return track.artistId();
+    case PluginTrackModel::DateRole:
+        return track.date();
+    case PluginTrackModel::DescriptionRole:
+        return track.description();
+    case PluginTrackModel::DownloadableRole:
+        return track.isDownloadable();
+    case PluginTrackModel::DurationRole:
+        return track.duration();
+    case PluginTrackModel::DurationStringRole:
+        return track.durationString();
+    case PluginTrackModel::FormatRole:
+        return track.format();
+    case PluginTrackModel::GenreRole:
+        return track.genre();
+    case PluginTrackModel::IdRole:
+        return track.id();
+    case PluginTrackModel::LargeThumbnailUrlRole:
+        return track.largeThumbnailUrl();
+    case PluginTrackModel::PlayCountRole:
+        return track.playCount();
+    case PluginTrackModel::ServiceRole:
+        return track.service();
+    case PluginTrackModel::SizeRole:
+        return track.size();
+    case PluginTrackModel::SizeStringRole:
+        return track.sizeString();
+    case PluginTrackModel::StreamUrlRole:
+        return track.streamUrl();
+    case PluginTrackModel::ThumbnailUrlRole:
+        return track.thumbnailUrl();
+    case PluginTrackModel::TitleRole:
+        return track.title();
+    case PluginTrackModel::UrlRole:
+        return track.url();
+    default:
+        return QVariant();
+    }
+}
 
 PluginTrackModel::PluginTrackModel(QObject *parent) :
     QAbstractListModel(parent),
     m_request(new ResourcesRequest(this))
 {
-    m_roles[ArtistRole] = "artist";
-    m_roles[ArtistIdRole] = "artistId";
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[DownloadableRole] = "downloadable";
-    m_roles[DurationRole] = "duration";
-    m_roles[DurationStringRole] = "durationString";
-    m_roles[FormatRole] = "format";
-    m_roles[GenreRole] = "genre";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[PlayCountRole] = "playCount";
-    m_roles[ServiceRole] = "service";
-    m_roles[SizeRole] = "size";
-    m_roles[SizeStringRole] = "sizeString";
-    m_roles[StreamUrlRole] = "streamUrl";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UrlRole] = "url";
 #if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
+    setRoleNames(roleTable()->roleNames());
 #endif
     connect(m_request, SIGNAL(serviceChanged()), this, SIGNAL(serviceChanged()));
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
@@ -60,17 +115,18 @@ QString PluginTrackModel::errorString() const {
 }
 
 ResourcesRequest::Status PluginTrackModel::status() const {
-    return m_request->status();
+    // The model is still loading until the records of the last page have been inserted
+    return m_task ? ResourcesRequest::Loading : m_request->status();
 }
 
 #if QT_VERSION >=0x050000
 QHash<int, QByteArray> PluginTrackModel::roleNames() const {
-    return m_roles;
+    return roleTable()->roleNames();
 }
 #endif
 
 int PluginTrackModel::rowCount(const QModelIndex &) const {
-    return m_items.size();
+    return m_records.size();
 }
 
 bool PluginTrackModel::canFetchMore(const QModelIndex &) const {
@@ -87,22 +143,25 @@ void PluginTrackModel::fetchMore(const QModelIndex &) {
 }
 
 QVariant PluginTrackModel::data(const QModelIndex &index, int role) const {
-    if (PluginTrack *track = get(index.row())) {
-        return track->property(m_roles[role]);
+    const int row = index.row();
+    
+    if ((row < 0) || (row >= rowCount())) {
+        return QVariant();
     }
     
-    return QVariant();
+    if (const PluginTrack *track = m_items.at(row)) {
+        return trackData(*track, role);
+    }
+    
+    return trackData(m_records.at(row), role);
 }
 
 QMap<int, QVariant> PluginTrackModel::itemData(const QModelIndex &index) const {
     QMap<int, QVariant> map;
     
-    if (PluginTrack *track = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = track->property(iterator.value());
+    if ((index.row() >= 0) && (index.row() < rowCount())) {
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[role] = data(index, role);
         }
     }
     
@@ -110,19 +169,17 @@ QMap<int, QVariant> PluginTrackModel::itemData(const QModelIndex &index) const {
 }
 
 QVariant PluginTrackModel::data(int row, const QByteArray &role) const {
-    if (PluginTrack *track = get(row)) {
-        return track->property(role);
-    }
-    
-    return QVariant();
+    return data(index(row), roleTable()->role(role));
 }
 
 QVariantMap PluginTrackModel::itemData(int row) const {
     QVariantMap map;
     
-    if (PluginTrack *track = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = track->property(role);
+    if ((row >= 0) && (row < rowCount())) {
+        const QModelIndex idx = index(row);
+        
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[roleTable()->name(role)] = data(idx, role);
         }
     }
     
@@ -130,15 +187,31 @@ QVariantMap PluginTrackModel::itemData(int row) const {
 }
 
 PluginTrack* PluginTrackModel::get(int row) const {
-    if ((row >= 0) && (row < m_items.size())) {
-        return m_items.at(row);
+    if ((row < 0) || (row >= rowCount())) {
+        return 0;
+    }
+    
+    if (!m_items.at(row)) {
+        m_items[row] = new PluginTrack(m_records.at(row), const_cast<PluginTrackModel*>(this));
+    }
+    
+    return m_items.at(row);
+}
+
+TrackRecord PluginTrackModel::record(int row) const {
+    if ((row < 0) || (row >= rowCount())) {
+        return TrackRecord();
     }
     
-    return 0;
+    if (PluginTrack *track = m_items.at(row)) {
+        return track->record();
+    }
+    
+    return m_records.at(row);
 }
 
 void PluginTrackModel::list(const QString &id) {
-    if (status() == ResourcesRequest::Loading) {
+    if (m_request->status() == ResourcesRequest::Loading) {
         return;
     }
     
@@ -150,7 +223,7 @@ void PluginTrackModel::list(const QString &id) {
 }
 
 void PluginTrackModel::search(const QString &query, const QString &order) {
-    if (status() == ResourcesRequest::Loading) {
+    if (m_request->status() == ResourcesRequest::Loading) {
         return;
     }
     
@@ -163,10 +236,14 @@ void PluginTrackModel::search(const QString &query, const QString &order) {
 }
 
 void PluginTrackModel::clear() {
-    if (!m_items.isEmpty()) {
+    // Discard the records of a page that is still being converted
+    m_task = 0;
+    
+    if (!m_records.isEmpty()) {
         beginResetModel();
         qDeleteAll(m_items);
         m_items.clear();
+        m_records.clear();
         m_next = QString();
         endResetModel();
         emit countChanged(rowCount());
@@ -174,7 +251,13 @@ void PluginTrackModel::clear() {
 }
 
 void PluginTrackModel::cancel() {
-    m_request->cancel();
+    if (m_task) {
+        m_task = 0;
+        emit statusChanged(status());
+    }
+    else {
+        m_request->cancel();
+    }
 }
 
 void PluginTrackModel::reload() {
@@ -190,16 +273,18 @@ void PluginTrackModel::reload() {
     emit statusChanged(status());
 }
 
-void PluginTrackModel::append(PluginTrack *track) {
-    beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
-    m_items << track;
+void PluginTrackModel::append(const TrackRecord &track) {
+    beginInsertRows(QModelIndex(), rowCount(), rowCount());
+    m_records << track;
+    m_items << 0;
     endInsertRows();
 }
 
-void PluginTrackModel::insert(int row, PluginTrack *track) {
-    if ((row >= 0) && (row < m_items.size())) {
+void PluginTrackModel::insert(int row, const TrackRecord &track) {
+    if ((row >= 0) && (row < rowCount())) {
         beginInsertRows(QModelIndex(), row, row);
-        m_items.insert(row, track);
+        m_records.insert(row, track);
+        m_items.insert(row, 0);
         endInsertRows();
     }
     else {
@@ -208,9 +293,14 @@ void PluginTrackModel::insert(int row, PluginTrack *track) {
 }
 
 void PluginTrackModel::remove(int row) {
-    if ((row >= 0) && (row < m_items.size())) {
+    if ((row >= 0) && (row < rowCount())) {
         beginRemoveRows(QModelIndex(), row, row);
-        m_items.takeAt(row)->deleteLater();
+        m_records.removeAt(row);
+        
+        if (PluginTrack *track = m_items.takeAt(row)) {
+            track->deleteLater();
+        }
+        
         endRemoveRows();
     }
 }
@@ -222,18 +312,40 @@ void PluginTrackModel::onRequestFinished() {
         if (!result.isEmpty()) {
             m_next = result.value("next").toString();
             QVariantList list = result.value("items").toList();
-
-            beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + list.size() - 1);
-    
-            foreach (QVariant item, list) {
-                m_items << new PluginTrack(service(), item.toMap(), this);
+            
+            if (!list.isEmpty()) {
+                // statusChanged() is emitted once the records have been inserted
+                m_task = new TrackRecordTask(service(), list, PluginTrack::toRecord);
+                connect(m_task, SIGNAL(recordsReady(QList<TrackRecord>)), this, SLOT(onRecordsReady(QList<TrackRecord>)));
+                connect(m_task, SIGNAL(finished()), this, SLOT(onRecordsFinished()));
+                QThreadPool::globalInstance()->start(m_task);
+                return;
             }
-
-            endInsertRows();
-            emit countChanged(rowCount());
-                
         }
     }
     
     emit statusChanged(status());
 }
+
+void PluginTrackModel::onRecordsReady(const QList<TrackRecord> &records) {
+    if (sender() != m_task.data()) {
+        return;
+    }
+    
+    beginInsertRows(QModelIndex(), rowCount(), rowCount() + records.size() - 1);
+    m_records << records;
+    
+    for (int i = 0; i < records.size(); i++) {
+        m_items << 0;
+    }
+    
+    endInsertRows();
+    emit countChanged(rowCount());
+}
+
+void PluginTrackModel::onRecordsFinished() {
+    if (sender() == m_task.data()) {
+        m_task = 0;
+        emit statusChanged(status());
+    }
+}
@@ -20,6 +20,9 @@
 #include "resourcesrequest.h"
 #include "plugintrack.h"
 #include <QAbstractListModel>
+#include <QPointer>
+
+class TrackRecordTask;
 
 class PluginTrackModel : public QAbstractListModel
 {
@@ -79,6 +82,8 @@ public:
     
     Q_INVOKABLE PluginTrack* get(int row) const;
     
+    TrackRecord record(int row) const;
+    
     Q_INVOKABLE void list(const QString &id = QString());
     Q_INVOKABLE void search(const QString &query, const QString &order);
 
@@ -88,12 +93,14 @@ public Q_SLOTS:
     void reload();
     
 private:    
-    void append(PluginTrack *track);
-    void insert(int row, PluginTrack *track);
+    void append(const TrackRecord &track);
+    void insert(int row, const TrackRecord &track);
     void remove(int row);
     
 private Q_SLOTS:
     void onRequestFinished();
+    void onRecordsReady(const QList<TrackRecord> &records);
+    void onRecordsFinished();
     
 Q_SIGNALS:
     void countChanged(int c);
@@ -108,9 +115,13 @@ private:
     QString m_order;
     QString m_next;
         
-    QList<PluginTrack*> m_items;
+    // Rows are held as records, and a track object is only created for a row when it is requested with get()
+    QList<TrackRecord> m_records;
+    mutable QList<PluginTrack*> m_items;
+    
+    QPointer<TrackRecordTask> m_task;
     
-    QHash<int, QByteArray> m_roles;
+    friend class tst_Bench_ModelData;
 };
     
 #endif // PLUGINTRACKMODEL_H
@@ -18,6 +18,7 @@
 #include "json.h"
 #include "resourcesplugins.h"
 #include <QProcess>
+#include <QThreadPool>
 #ifdef MUSIKLOUD_DEBUG
 #include <QDebug>
 #endif
@@ -25,6 +26,7 @@
 ResourcesRequest::ResourcesRequest(QObject *parent) :
     QObject(parent),
     m_process(new QProcess(this)),
+    m_exitCode(0),
     m_status(Null),
     m_error(NoError)
 {
@@ -164,14 +166,33 @@ void ResourcesRequest::start(const QString &program, const QStringList &args) {
 }
 
 void ResourcesRequest::cancel() {
-    m_process->kill();
+    if (m_parser) {
+        m_parser = 0;
+        setStatus(Canceled);
+        emit finished();
+    }
+    else {
+        m_process->kill();
+    }
 }
 
 void ResourcesRequest::onProcessFinished(int exitCode) {
-    bool ok;
-    setResult(QtJson::Json::parse(QString::fromUtf8(m_process->readAllStandardOutput()), ok));
+    // The status remains Loading until the response has been parsed
+    m_exitCode = exitCode;
+    m_parser = new ResourcesParserTask(m_process->readAllStandardOutput());
+    connect(m_parser, SIGNAL(finished(QVariant, bool)), this, SLOT(onResponseParsed(QVariant, bool)));
+    QThreadPool::globalInstance()->start(m_parser);
+}
+
+void ResourcesRequest::onResponseParsed(const QVariant &r, bool ok) {
+    if (sender() != m_parser.data()) {
+        return;
+    }
+    
+    m_parser = 0;
+    setResult(r);
         
-    if (exitCode == 0) {
+    if (m_exitCode == 0) {
         if (ok) {
             setStatus(Ready);
             setError(NoError);
@@ -211,3 +232,19 @@ void ResourcesRequest::onProcessError() {
     setErrorString(m_process->errorString());
     emit finished();
 }
+
+ResourcesParserTask::ResourcesParserTask(const QByteArray &response) :
+    QObject(),
+    QRunnable(),
+    m_response(response)
+{
+    // The task is deleted in the thread that created it, once finished() has been delivered
+    setAutoDelete(false);
+    connect(this, SIGNAL(finished(QVariant, bool)), this, SLOT(deleteLater()));
+}
+
+void ResourcesParserTask::run() {
+    bool ok;
+    const QVariant result = QtJson::Json::parse(QString::fromUtf8(m_response), ok);
+    emit finished(result, ok);
+}
@@ -18,9 +18,12 @@
 #define RESOURCESREQUEST_H
 
 #include <QObject>
+#include <QPointer>
+#include <QRunnable>
 #include <QString>
 #include <QVariant>
 
+class ResourcesParserTask;
 class QProcess;
 
 class ResourcesRequest : public QObject
@@ -87,6 +90,7 @@ private:
 private Q_SLOTS:
     void onProcessFinished(int exitCode);
     void onProcessError();
+    void onResponseParsed(const QVariant &r, bool ok);
     
 Q_SIGNALS:
     void serviceChanged();
@@ -95,6 +99,9 @@ Q_SIGNALS:
     
 private:
     QProcess *m_process;
+    
+    QPointer<ResourcesParserTask> m_parser;
+    int m_exitCode;
         
     QString m_service;
     
@@ -106,4 +113,24 @@ private:
     QString m_errorString;
 };
 
+/*
+ * Parses the JSON output of a plugin on the global thread pool. finished() is emitted from the pool thread,
+ * and the task deletes itself once it has been delivered.
+ */
+class ResourcesParserTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit ResourcesParserTask(const QByteArray &response);
+    
+    void run();
+
+Q_SIGNALS:
+    void finished(const QVariant &result, bool ok);
+
+private:
+    QByteArray m_response;
+};
+
 #endif // RESOURCESREQUEST_H
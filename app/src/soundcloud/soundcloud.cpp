@@ -16,9 +16,10 @@
 
 #include "soundcloud.h"
 #include "database.h"
+#include "soundcloudartist.h"
+#include "soundcloudtrack.h"
 #include <qsoundcloud/urls.h>
 #include <QSettings>
-#include <QSqlRecord>
 #if QT_VERSION >= 0x050000
 #include <QUrlQuery>
 #endif
@@ -31,7 +32,7 @@ static const QString CLIENT_SECRET("f83369b46fe992306a90ef579d57fac4");
 static const QString REDIRECT_URI("http://marxoft.co.uk/projects/musikloud2");
 static const QStringList SCOPES = QStringList() << QSoundCloud::NON_EXPIRING_SCOPE;
 
-SoundCloud::FollowingCache SoundCloud::followingCache;
+SoundCloud::CredentialsCache SoundCloud::credentialsCache;
 
 SoundCloud* SoundCloud::self = 0;
 
@@ -41,6 +42,11 @@ SoundCloud::SoundCloud(QObject *parent) :
     if (!self) {
         self = this;
     }
+    
+    connect(this, SIGNAL(artistFollowed(SoundCloudArtist*)), this, SLOT(onArtistUpdated(SoundCloudArtist*)));
+    connect(this, SIGNAL(artistUnfollowed(SoundCloudArtist*)), this, SLOT(onArtistUpdated(SoundCloudArtist*)));
+    connect(this, SIGNAL(trackFavourited(SoundCloudTrack*)), this, SLOT(onTrackUpdated(SoundCloudTrack*)));
+    connect(this, SIGNAL(trackUnfavourited(SoundCloudTrack*)), this, SLOT(onTrackUpdated(SoundCloudTrack*)));
 }
 
 SoundCloud::~SoundCloud() {
@@ -100,48 +106,69 @@ QUrl SoundCloud::authUrl() const {
     return url;
 }
 
+void SoundCloud::loadCredentials() {
+    if (credentialsCache.loaded) {
+        return;
+    }
+    
+    credentialsCache.userId = QSettings().value("SoundCloud/userId").toString();
+    credentialsCache.accessToken = QString();
+    credentialsCache.refreshToken = QString();
+    credentialsCache.scopes = QString();
+    
+    if (!credentialsCache.userId.isEmpty()) {
+        QSqlQuery query(getDatabase());
+        query.prepare("SELECT accessToken, refreshToken, scopes FROM soundcloudAccounts WHERE userId = ?");
+        query.addBindValue(credentialsCache.userId);
+        
+        if (!query.exec()) {
+            qDebug() << "SoundCloud::loadCredentials: database error:" << query.lastError().text();
+            return;
+        }
+        
+        if (query.next()) {
+            credentialsCache.accessToken = query.value(0).toString();
+            credentialsCache.refreshToken = query.value(1).toString();
+            credentialsCache.scopes = query.value(2).toString();
+        }
+    }
+    
+    credentialsCache.loaded = true;
+}
+
 QString SoundCloud::userId() const {
-    return QSettings().value("SoundCloud/userId").toString();
+    loadCredentials();
+    return credentialsCache.userId;
 }
 
 void SoundCloud::setUserId(const QString &id) {
     if (id != userId()) {
         QSettings().setValue("SoundCloud/userId", id);
-        followingCache.ids.clear();
-        followingCache.nextHref = QString();
-        followingCache.loaded = false;
+        credentialsCache.loaded = false;
         emit userIdChanged();
     }
 }
 
 QString SoundCloud::accessToken() const {
-    if (userId().isEmpty()) {
-        return QString();
-    }
-    
-    QSqlQuery query = getDatabase().exec(QString("SELECT accessToken FROM soundcloudAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "SoundCloud::accessToken: database error:" << query.lastError().text();
-        return QString();
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString();
-    }
-    
-    return QString();
+    loadCredentials();
+    return credentialsCache.accessToken;
 }
 
 void SoundCloud::setAccessToken(const QString &token) {
-    QSqlQuery query = getDatabase().exec(QString("UPDATE soundcloudAccounts SET accessToken = '%1' WHERE userId = '%2'")
-                                                .arg(token).arg(userId()));
+    if (token == accessToken()) {
+        return;
+    }
+    
+    QSqlQuery query(getDatabase());
+    query.prepare("UPDATE soundcloudAccounts SET accessToken = ? WHERE userId = ?");
+    query.addBindValue(token);
+    query.addBindValue(userId());
 
-    if (query.lastError().isValid()) {
+    if (!query.exec()) {
         qDebug() << "SoundCloud::setAccessToken: database error:" << query.lastError().text();
     }
     else {
+        credentialsCache.accessToken = token;
         emit accessTokenChanged();
     }
 #ifdef MUSIKLOUD_DEBUG
@@ -150,34 +177,26 @@ void SoundCloud::setAccessToken(const QString &token) {
 }
 
 QString SoundCloud::refreshToken() const {
-    if (userId().isEmpty()) {
-        return QString();
-    }
-    
-    QSqlQuery query = getDatabase().exec(QString("SELECT refreshToken FROM soundcloudAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "SoundCloud::refreshToken: database error:" << query.lastError().text();
-        return QString();
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString();
-    }
-    
-    return QString();
+    loadCredentials();
+    return credentialsCache.refreshToken;
 }
 
 void SoundCloud::setRefreshToken(const QString &token) {
-    QSqlQuery query = getDatabase().exec(QString("UPDATE soundcloudAccounts SET refreshToken = '%1' WHERE userId = '%2'")
-                                                .arg(token).arg(userId()));
+    if (token == refreshToken()) {
+        return;
+    }
+    
+    QSqlQuery query(getDatabase());
+    query.prepare("UPDATE soundcloudAccounts SET refreshToken = ? WHERE userId = ?");
+    query.addBindValue(token);
+    query.addBindValue(userId());
 
-    if (query.lastError().isValid()) {
+    if (!query.exec()) {
         qDebug() << "SoundCloud::setRefreshToken: database error:" << query.lastError().text();
     }
     else {
-        emit accessTokenChanged();
+        credentialsCache.refreshToken = token;
+        emit refreshTokenChanged();
     }
 #ifdef MUSIKLOUD_DEBUG
     qDebug() << "SoundCloud::setRefreshToken" << token;
@@ -241,23 +260,8 @@ void SoundCloud::setScopes(const QStringList &s) {
 }
 
 bool SoundCloud::hasScope(const QString &scope) const {
-    if (userId().isEmpty()) {
-        return false;
-    }
-    
-    QSqlQuery query = getDatabase().exec(QString("SELECT scopes FROM soundcloudAccounts WHERE userId = '%1'")
-                                                .arg(userId()));
-    
-    if (query.lastError().isValid()) {
-        qDebug() << "SoundCloud::hasScope: database error:" << query.lastError().text();
-        return false;
-    }
-    
-    if ((query.record().count() > 0) && (query.next())) {
-         return query.value(0).toString().contains(scope);
-    }
-    
-    return false;
+    loadCredentials();
+    return credentialsCache.scopes.contains(scope);
 }
 
 QString SoundCloud::nonexpiringScope() {
@@ -267,3 +271,43 @@ QString SoundCloud::nonexpiringScope() {
 QString SoundCloud::wildcardScope() {
     return QSoundCloud::WILDCARD_SCOPE;
 }
+
+void SoundCloud::addArtist(const QString &id, SoundCloudArtist *artist) {
+    if (!id.isEmpty()) {
+        m_artists.insert(id, artist);
+    }
+}
+
+void SoundCloud::removeArtist(const QString &id, SoundCloudArtist *artist) {
+    if (!id.isEmpty()) {
+        m_artists.remove(id, artist);
+    }
+}
+
+void SoundCloud::addTrack(const QString &id, SoundCloudTrack *track) {
+    if (!id.isEmpty()) {
+        m_tracks.insert(id, track);
+    }
+}
+
+void SoundCloud::removeTrack(const QString &id, SoundCloudTrack *track) {
+    if (!id.isEmpty()) {
+        m_tracks.remove(id, track);
+    }
+}
+
+void SoundCloud::onArtistUpdated(SoundCloudArtist *artist) {
+    foreach (SoundCloudArtist *a, m_artists.values(artist->id())) {
+        if (a != artist) {
+            a->loadArtist(artist);
+        }
+    }
+}
+
+void SoundCloud::onTrackUpdated(SoundCloudTrack *track) {
+    foreach (SoundCloudTrack *t, m_tracks.values(track->id())) {
+        if (t != track) {
+            t->loadTrack(track);
+        }
+    }
+}
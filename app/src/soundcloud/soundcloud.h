@@ -18,6 +18,7 @@
 #define SOUNDCLOUD_H
 
 #include <QObject>
+#include <QMultiHash>
 #include <QStringList>
 #include <QVariantMap>
 #include <QUrl>
@@ -102,22 +103,38 @@ Q_SIGNALS:
     void trackFavourited(SoundCloudTrack *track);
     void trackUnfavourited(SoundCloudTrack *track);    
 
+private Q_SLOTS:
+    void onArtistUpdated(SoundCloudArtist *artist);
+    void onTrackUpdated(SoundCloudTrack *track);
+
 private:
-    struct FollowingCache {
-        QStringList ids;
-        QString nextHref;
-        QVariantMap filters;
+    // The credentials of the active account, read from the database once and written through by the setters
+    struct CredentialsCache {
+        QString userId;
+        QString accessToken;
+        QString refreshToken;
+        QString scopes;
         bool loaded;
-
-        FollowingCache() :
+        
+        CredentialsCache() :
             loaded(false)
         {
-            filters["limit"] = 200;
-            filters["linked_partitioning"] = true;
         }
     };
     
-    static FollowingCache followingCache;
+    static void loadCredentials();
+    
+    // Live artists and tracks by id, so that an update is delivered only to the objects for that id
+    void addArtist(const QString &id, SoundCloudArtist *artist);
+    void removeArtist(const QString &id, SoundCloudArtist *artist);
+    
+    void addTrack(const QString &id, SoundCloudTrack *track);
+    void removeTrack(const QString &id, SoundCloudTrack *track);
+    
+    QMultiHash<QString, SoundCloudArtist*> m_artists;
+    QMultiHash<QString, SoundCloudTrack*> m_tracks;
+    
+    static CredentialsCache credentialsCache;
     static SoundCloud *self;
     
     friend class SoundCloudArtist;
@@ -18,6 +18,7 @@
 #include "definitions.h"
 #include "resources.h"
 #include "soundcloud.h"
+#include "soundcloudsync.h"
 #ifdef MUSIKLOUD_DEBUG
 #include <QDebug>
 #endif
@@ -32,10 +33,8 @@ SoundCloudArtist::SoundCloudArtist(QObject *parent) :
     m_trackCount(0)
 {
     setService(Resources::SOUNDCLOUD);
-    connect(SoundCloud::instance(), SIGNAL(artistFollowed(SoundCloudArtist*)),
-            this, SLOT(onArtistUpdated(SoundCloudArtist*)));
-    connect(SoundCloud::instance(), SIGNAL(artistUnfollowed(SoundCloudArtist*)),
-            this, SLOT(onArtistUpdated(SoundCloudArtist*)));
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+    onIdChanged();
 }
 
 SoundCloudArtist::SoundCloudArtist(const QString &id, QObject *parent) :
@@ -49,10 +48,8 @@ SoundCloudArtist::SoundCloudArtist(const QString &id, QObject *parent) :
 {
     setService(Resources::SOUNDCLOUD);
     loadArtist(id);
-    connect(SoundCloud::instance(), SIGNAL(artistFollowed(SoundCloudArtist*)),
-            this, SLOT(onArtistUpdated(SoundCloudArtist*)));
-    connect(SoundCloud::instance(), SIGNAL(artistUnfollowed(SoundCloudArtist*)),
-            this, SLOT(onArtistUpdated(SoundCloudArtist*)));
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+    onIdChanged();
 }
 
 SoundCloudArtist::SoundCloudArtist(const QVariantMap &artist, QObject *parent) :
@@ -66,10 +63,8 @@ SoundCloudArtist::SoundCloudArtist(const QVariantMap &artist, QObject *parent) :
 {
     setService(Resources::SOUNDCLOUD);
     loadArtist(artist);
-    connect(SoundCloud::instance(), SIGNAL(artistFollowed(SoundCloudArtist*)),
-            this, SLOT(onArtistUpdated(SoundCloudArtist*)));
-    connect(SoundCloud::instance(), SIGNAL(artistUnfollowed(SoundCloudArtist*)),
-            this, SLOT(onArtistUpdated(SoundCloudArtist*)));
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+    onIdChanged();
 }
 
 SoundCloudArtist::SoundCloudArtist(SoundCloudArtist *artist, QObject *parent) :
@@ -83,10 +78,14 @@ SoundCloudArtist::SoundCloudArtist(SoundCloudArtist *artist, QObject *parent) :
     m_websiteTitle(artist->websiteTitle()),
     m_websiteUrl(artist->websiteUrl())
 {
-    connect(SoundCloud::instance(), SIGNAL(artistFollowed(SoundCloudArtist*)),
-            this, SLOT(onArtistUpdated(SoundCloudArtist*)));
-    connect(SoundCloud::instance(), SIGNAL(artistUnfollowed(SoundCloudArtist*)),
-            this, SLOT(onArtistUpdated(SoundCloudArtist*)));
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+    onIdChanged();
+}
+
+SoundCloudArtist::~SoundCloudArtist() {
+    if (SoundCloud *soundcloud = SoundCloud::instance()) {
+        soundcloud->removeArtist(m_registeredId, this);
+    }
 }
 
 QString SoundCloudArtist::errorString() const {
@@ -222,34 +221,20 @@ void SoundCloudArtist::loadArtist(SoundCloudArtist *artist) {
 }
 
 void SoundCloudArtist::checkIfFollowed() {
-    if (SoundCloud::followingCache.ids.contains(id())) {
-        setFollowed(true);
-        return;
-    }
+    SoundCloudSync *sync = SoundCloudSync::instance();
     
-    if (status() == QSoundCloud::ResourcesRequest::Loading) {
+    if (!sync) {
         return;
     }
     
-    if ((SoundCloud::followingCache.loaded) && (SoundCloud::followingCache.nextHref.isEmpty())) {
-#ifdef MUSIKLOUD_DEBUG
-        qDebug() << "SoundCloudArtist::checkIfFollowed" << id() << "not found";
-#endif
-        setFollowed(false);
+    if (sync->isFollowingsLoaded()) {
+        disconnect(sync, SIGNAL(followingsLoaded()), this, SLOT(checkIfFollowed()));
+        setFollowed(sync->isFollowed(id()));
         return;
     }
     
-    initRequest();
-    
-    if (SoundCloud::followingCache.nextHref.isEmpty()) {
-        m_request->get("/me/followings", SoundCloud::followingCache.filters);
-    }
-    else {
-        m_request->get(SoundCloud::followingCache.nextHref);
-    }
-    
-    connect(m_request, SIGNAL(finished()), this, SLOT(onFollowCheckRequestFinished()));
-    emit statusChanged(status());
+    connect(sync, SIGNAL(followingsLoaded()), this, SLOT(checkIfFollowed()), Qt::UniqueConnection);
+    sync->sync();
 }
 
 void SoundCloudArtist::follow() {
@@ -296,35 +281,10 @@ void SoundCloudArtist::onArtistRequestFinished() {
     emit statusChanged(status());
 }
 
-void SoundCloudArtist::onFollowCheckRequestFinished() {
-    if (m_request->status() == QSoundCloud::ResourcesRequest::Ready) {
-        QVariantMap result = m_request->result().toMap();
-        QVariantList list = result.value("collection").toList();
-        SoundCloud::followingCache.nextHref = result.value("next_href").toString().section('/', -1);
-        SoundCloud::followingCache.loaded = true;
-
-        foreach (QVariant item, list) {
-            QVariantMap map = item.toMap();
-            SoundCloud::followingCache.ids.append(map.value("id").toString());
-        }
-#ifdef MUSIKLOUD_DEBUG
-        qDebug() << "SoundCloudArtist::onFollowCheckRequestFinished OK" << SoundCloud::followingCache.ids;
-#endif
-        disconnect(m_request, SIGNAL(finished()), this, SLOT(onArtistRequestFinished()));
-        emit statusChanged(status());
-        checkIfFollowed();
-        return;
-    }
-    
-    disconnect(m_request, SIGNAL(finished()), this, SLOT(onArtistRequestFinished()));
-    emit statusChanged(status());
-}
-
 void SoundCloudArtist::onFollowRequestFinished() {
     if (m_request->status() == QSoundCloud::ResourcesRequest::Ready) {
         setFollowed(true);
         setFollowersCount(followersCount() + 1);
-        SoundCloud::followingCache.ids.append(id());
         emit SoundCloud::instance()->artistFollowed(this);
 #ifdef MUSIKLOUD_DEBUG
         qDebug() << "SoundCloudArtist::onFollowRequestFinished OK" << id();
@@ -339,7 +299,6 @@ void SoundCloudArtist::onUnfollowRequestFinished() {
     if (m_request->status() == QSoundCloud::ResourcesRequest::Ready) {
         setFollowed(false);
         setFollowersCount(followersCount() - 1);
-        SoundCloud::followingCache.ids.removeOne(id());
         emit SoundCloud::instance()->artistUnfollowed(this);
 #ifdef MUSIKLOUD_DEBUG
         qDebug() << "SoundCloudArtist::onUnfollowRequestFinished OK" << id();
@@ -350,8 +309,10 @@ void SoundCloudArtist::onUnfollowRequestFinished() {
     emit statusChanged(status());
 }
 
-void SoundCloudArtist::onArtistUpdated(SoundCloudArtist *artist) {
-    if ((artist->id() == id()) && (artist != this)) {
-        loadArtist(artist);
+void SoundCloudArtist::onIdChanged() {
+    if (SoundCloud *soundcloud = SoundCloud::instance()) {
+        soundcloud->removeArtist(m_registeredId, this);
+        m_registeredId = id();
+        soundcloud->addArtist(m_registeredId, this);
     }
 }
@@ -39,6 +39,7 @@ public:
     explicit SoundCloudArtist(const QString &id, QObject *parent = 0);
     explicit SoundCloudArtist(const QVariantMap &artist, QObject *parent = 0);
     explicit SoundCloudArtist(SoundCloudArtist *artist, QObject *parent = 0);
+    ~SoundCloudArtist();
         
     QString errorString() const;
     
@@ -82,10 +83,9 @@ private:
         
 private Q_SLOTS:
     void onArtistRequestFinished();
-    void onFollowCheckRequestFinished();
     void onFollowRequestFinished();
     void onUnfollowRequestFinished();
-    void onArtistUpdated(SoundCloudArtist *artist);
+    void onIdChanged();
     
 Q_SIGNALS:
     void followedChanged();
@@ -115,6 +115,8 @@ private:
     
     QString m_websiteTitle;
     QUrl m_websiteUrl;
+    
+    QString m_registeredId;
 };
     
 #endif // SOUNDCLOUDARTIST_H
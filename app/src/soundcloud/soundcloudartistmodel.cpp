@@ -15,30 +15,68 @@
  */
 
 #include "soundcloudartistmodel.h"
+#include "roletable.h"
 #include "soundcloud.h"
 #include <qsoundcloud/urls.h>
 #ifdef MUSIKLOUD_DEBUG
 #include <QDebug>
 #endif
 
+static const char* const ROLE_NAMES[] = {
+    "description",
+    "followed",
+    "followersCount",
+    "id",
+    "largeThumbnailUrl",
+    "name",
+    "online",
+    "playlistCount",
+    "thumbnailUrl",
+    "trackCount",
+    "websiteTitle",
+    "websiteUrl",
+    0
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(RoleTable, roleTable, (SoundCloudArtistModel::DescriptionRole, ROLE_NAMES))
+
+static QVariant artistData(const SoundCloudArtist *artist, int role) {
+    switch (role) {
+    case SoundCloudArtistModel::DescriptionRole:
+        return artist->description();
+    case SoundCloudArtistModel::FollowedRole:
+        return artist->isFollowed();
+    case SoundCloudArtistModel::FollowersCountRole:
+        return artist->followersCount();
+    case SoundCloudArtistModel::IdRole:
+        return artist->id();
+    case SoundCloudArtistModel::LargeThumbnailUrlRole:
+        return artist->largeThumbnailUrl();
+    case SoundCloudArtistModel::NameRole:
+        return artist->name();
+    case SoundCloudArtistModel::OnlineRole:
+        return artist->isOnline();
+    case SoundCloudArtistModel::PlaylistCountRole:
+        return artist->playlistCount();
+    case SoundCloudArtistModel::ThumbnailUrlRole:
+        return artist->thumbnailUrl();
+    case SoundCloudArtistModel::TrackCountRole:
+        return artist->trackCount();
+    case SoundCloudArtistModel::WebsiteTitleRole:
+        return artist->websiteTitle();
+    case SoundCloudArtistModel::WebsiteUrlRole:
+        return artist->websiteUrl();
+    default:
+        return QVariant();
+    }
+}
+
 SoundCloudArtistModel::SoundCloudArtistModel(QObject *parent) :
     QAbstractListModel(parent),
     m_request(new QSoundCloud::ResourcesRequest(this))
 {
-    m_roles[DescriptionRole] = "description";
-    m_roles[FollowedRole] = "followed";
-    m_roles[FollowersCountRole] = "followersCount";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[NameRole] = "name";
-    m_roles[OnlineRole] = "online";
-    m_roles[PlaylistCountRole] = "playlistCount";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TrackCountRole] = "trackCount";
-    m_roles[WebsiteTitleRole] = "websiteTitle";
-    m_roles[WebsiteUrlRole] = "websiteUrl";
 #if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
+    setRoleNames(roleTable()->roleNames());
 #endif
     m_request->setClientId(SoundCloud::instance()->clientId());
     m_request->setClientSecret(SoundCloud::instance()->clientSecret());
@@ -60,7 +98,7 @@ QSoundCloud::ResourcesRequest::Status SoundCloudArtistModel::status() const {
 
 #if QT_VERSION >=0x050000
 QHash<int, QByteArray> SoundCloudArtistModel::roleNames() const {
-    return m_roles;
+    return roleTable()->roleNames();
 }
 #endif
 
@@ -82,8 +120,8 @@ void SoundCloudArtistModel::fetchMore(const QModelIndex &) {
 }
 
 QVariant SoundCloudArtistModel::data(const QModelIndex &index, int role) const {
-    if (SoundCloudArtist *artist = get(index.row())) {
-        return artist->property(m_roles[role]);
+    if (const SoundCloudArtist *artist = get(index.row())) {
+        return artistData(artist, role);
     }
     
     return QVariant();
@@ -92,12 +130,9 @@ QVariant SoundCloudArtistModel::data(const QModelIndex &index, int role) const {
 QMap<int, QVariant> SoundCloudArtistModel::itemData(const QModelIndex &index) const {
     QMap<int, QVariant> map;
     
-    if (SoundCloudArtist *artist = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = artist->property(iterator.value());
+    if ((index.row() >= 0) && (index.row() < rowCount())) {
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[role] = data(index, role);
         }
     }
     
@@ -105,19 +140,17 @@ QMap<int, QVariant> SoundCloudArtistModel::itemData(const QModelIndex &index) co
 }
 
 QVariant SoundCloudArtistModel::data(int row, const QByteArray &role) const {
-    if (SoundCloudArtist *artist = get(row)) {
-        return artist->property(role);
-    }
-    
-    return QVariant();
+    return data(index(row), roleTable()->role(role));
 }
 
 QVariantMap SoundCloudArtistModel::itemData(int row) const {
     QVariantMap map;
     
-    if (SoundCloudArtist *artist = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = artist->property(role);
+    if ((row >= 0) && (row < rowCount())) {
+        const QModelIndex idx = index(row);
+        
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[roleTable()->name(role)] = data(idx, role);
         }
     }
     
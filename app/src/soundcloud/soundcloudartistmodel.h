@@ -97,8 +97,6 @@ private:
     QString m_nextHref;
         
     QList<SoundCloudArtist*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // SOUNDCLOUDARTISTMODEL_H
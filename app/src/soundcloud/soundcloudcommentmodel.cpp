@@ -15,25 +15,53 @@
  */
 
 #include "soundcloudcommentmodel.h"
+#include "roletable.h"
 #include "soundcloud.h"
 #include <qsoundcloud/urls.h>
 #ifdef MUSIKLOUD_DEBUG
 #include <QDebug>
 #endif
 
+static const char* const ROLE_NAMES[] = {
+    "artist",
+    "artistId",
+    "body",
+    "date",
+    "id",
+    "thumbnailUrl",
+    "trackId",
+    0
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(RoleTable, roleTable, (SoundCloudCommentModel::ArtistRole, ROLE_NAMES))
+
+static QVariant commentData(const SoundCloudComment *comment, int role) {
+    switch (role) {
+    case SoundCloudCommentModel::ArtistRole:
+        return comment->artist();
+    case SoundCloudCommentModel::ArtistIdRole:
+        return comment->artistId();
+    case SoundCloudCommentModel::BodyRole:
+        return comment->body();
+    case SoundCloudCommentModel::DateRole:
+        return comment->date();
+    case SoundCloudCommentModel::IdRole:
+        return comment->id();
+    case SoundCloudCommentModel::ThumbnailUrlRole:
+        return comment->thumbnailUrl();
+    case SoundCloudCommentModel::TrackIdRole:
+        return comment->trackId();
+    default:
+        return QVariant();
+    }
+}
+
 SoundCloudCommentModel::SoundCloudCommentModel(QObject *parent) :
     QAbstractListModel(parent),
     m_request(new QSoundCloud::ResourcesRequest(this))
 {
-    m_roles[ArtistRole] = "artist";
-    m_roles[ArtistIdRole] = "artistId";
-    m_roles[BodyRole] = "body";
-    m_roles[DateRole] = "date";
-    m_roles[IdRole] = "id";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TrackIdRole] = "trackId";
 #if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
+    setRoleNames(roleTable()->roleNames());
 #endif
     m_request->setClientId(SoundCloud::instance()->clientId());
     m_request->setClientSecret(SoundCloud::instance()->clientSecret());
@@ -57,7 +85,7 @@ QSoundCloud::ResourcesRequest::Status SoundCloudCommentModel::status() const {
 
 #if QT_VERSION >=0x050000
 QHash<int, QByteArray> SoundCloudCommentModel::roleNames() const {
-    return m_roles;
+    return roleTable()->roleNames();
 }
 #endif
 
@@ -79,8 +107,8 @@ void SoundCloudCommentModel::fetchMore(const QModelIndex &) {
 }
 
 QVariant SoundCloudCommentModel::data(const QModelIndex &index, int role) const {
-    if (SoundCloudComment *user = get(index.row())) {
-        return user->property(m_roles[role]);
+    if (const SoundCloudComment *comment = get(index.row())) {
+        return commentData(comment, role);
     }
     
     return QVariant();
@@ -89,12 +117,9 @@ QVariant SoundCloudCommentModel::data(const QModelIndex &index, int role) const
 QMap<int, QVariant> SoundCloudCommentModel::itemData(const QModelIndex &index) const {
     QMap<int, QVariant> map;
     
-    if (SoundCloudComment *user = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = user->property(iterator.value());
+    if ((index.row() >= 0) && (index.row() < rowCount())) {
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[role] = data(index, role);
         }
     }
     
@@ -102,19 +127,17 @@ QMap<int, QVariant> SoundCloudCommentModel::itemData(const QModelIndex &index) c
 }
 
 QVariant SoundCloudCommentModel::data(int row, const QByteArray &role) const {
-    if (SoundCloudComment *user = get(row)) {
-        return user->property(role);
-    }
-    
-    return QVariant();
+    return data(index(row), roleTable()->role(role));
 }
 
 QVariantMap SoundCloudCommentModel::itemData(int row) const {
     QVariantMap map;
     
-    if (SoundCloudComment *user = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = user->property(role);
+    if ((row >= 0) && (row < rowCount())) {
+        const QModelIndex idx = index(row);
+        
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[roleTable()->name(role)] = data(idx, role);
         }
     }
     
@@ -91,8 +91,6 @@ private:
     QString m_nextHref;
         
     QList<SoundCloudComment*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // SOUNDCLOUDCOMMENTMODEL_H
@@ -15,28 +15,68 @@
  */
 
 #include "soundcloudplaylistmodel.h"
+#include "roletable.h"
 #include "soundcloud.h"
 #include <qsoundcloud/urls.h>
 
+static const char* const ROLE_NAMES[] = {
+    "artist",
+    "artistId",
+    "date",
+    "description",
+    "duration",
+    "durationString",
+    "genre",
+    "id",
+    "largeThumbnailUrl",
+    "sharing",
+    "thumbnailUrl",
+    "title",
+    "trackCount",
+    0
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(RoleTable, roleTable, (SoundCloudPlaylistModel::ArtistRole, ROLE_NAMES))
+
+static QVariant playlistData(const SoundCloudPlaylist *playlist, int role) {
+    switch (role) {
+    case SoundCloudPlaylistModel::ArtistRole:
+        return playlist->artist();
+    case SoundCloudPlaylistModel::ArtistIdRole:
+        return playlist->artistId();
+    case SoundCloudPlaylistModel::DateRole:
+        return playlist->date();
+    case SoundCloudPlaylistModel::DescriptionRole:
+        return playlist->description();
+    case SoundCloudPlaylistModel::DurationRole:
+        return playlist->duration();
+    case SoundCloudPlaylistModel::DurationStringRole:
+        return playlist->durationString();
+    case SoundCloudPlaylistModel::GenreRole:
+        return playlist->genre();
+    case SoundCloudPlaylistModel::IdRole:
+        return playlist->id();
+    case SoundCloudPlaylistModel::LargeThumbnailUrlRole:
+        return playlist->largeThumbnailUrl();
+    case SoundCloudPlaylistModel::SharingRole:
+        return playlist->sharing();
+    case SoundCloudPlaylistModel::ThumbnailUrlRole:
+        return playlist->thumbnailUrl();
+    case SoundCloudPlaylistModel::TitleRole:
+        return playlist->title();
+    case SoundCloudPlaylistModel::TrackCountRole:
+        return playlist->trackCount();
+    default:
+        return QVariant();
+    }
+}
+
 SoundCloudPlaylistModel::SoundCloudPlaylistModel(QObject *parent) :
     QAbstractListModel(parent),
     m_request(new QSoundCloud::ResourcesRequest(this))
 {
-    m_roles[ArtistRole] = "artist";
-    m_roles[ArtistIdRole] = "artistId";
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[DurationRole] = "duration";
-    m_roles[DurationStringRole] = "durationString";
-    m_roles[GenreRole] = "genre";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[SharingRole] = "sharing";
-    m_roles[TitleRole] = "title";
-    m_roles[TrackCountRole] = "trackCount";
 #if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
+    setRoleNames(roleTable()->roleNames());
 #endif
     m_request->setClientId(SoundCloud::instance()->clientId());
     m_request->setClientSecret(SoundCloud::instance()->clientSecret());
@@ -58,7 +98,7 @@ QSoundCloud::ResourcesRequest::Status SoundCloudPlaylistModel::status() const {
 
 #if QT_VERSION >=0x050000
 QHash<int, QByteArray> SoundCloudPlaylistModel::roleNames() const {
-    return m_roles;
+    return roleTable()->roleNames();
 }
 #endif
 
@@ -80,8 +120,8 @@ void SoundCloudPlaylistModel::fetchMore(const QModelIndex &) {
 }
 
 QVariant SoundCloudPlaylistModel::data(const QModelIndex &index, int role) const {
-    if (SoundCloudPlaylist *playlist = get(index.row())) {
-        return playlist->property(m_roles[role]);
+    if (const SoundCloudPlaylist *playlist = get(index.row())) {
+        return playlistData(playlist, role);
     }
     
     return QVariant();
@@ -90,12 +130,9 @@ QVariant SoundCloudPlaylistModel::data(const QModelIndex &index, int role) const
 QMap<int, QVariant> SoundCloudPlaylistModel::itemData(const QModelIndex &index) const {
     QMap<int, QVariant> map;
     
-    if (SoundCloudPlaylist *playlist = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = playlist->property(iterator.value());
+    if ((index.row() >= 0) && (index.row() < rowCount())) {
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[role] = data(index, role);
         }
     }
     
@@ -103,19 +140,17 @@ QMap<int, QVariant> SoundCloudPlaylistModel::itemData(const QModelIndex &index)
 }
 
 QVariant SoundCloudPlaylistModel::data(int row, const QByteArray &role) const {
-    if (SoundCloudPlaylist *playlist = get(row)) {
-        return playlist->property(role);
-    }
-    
-    return QVariant();
+    return data(index(row), roleTable()->role(role));
 }
 
 QVariantMap SoundCloudPlaylistModel::itemData(int row) const {
     QVariantMap map;
     
-    if (SoundCloudPlaylist *playlist = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = playlist->property(role);
+    if ((row >= 0) && (row < rowCount())) {
+        const QModelIndex idx = index(row);
+        
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[roleTable()->name(role)] = data(idx, role);
         }
     }
     
@@ -95,8 +95,6 @@ private:
     QString m_nextHref;
         
     QList<SoundCloudPlaylist*> m_items;
-    
-    QHash<int, QByteArray> m_roles;
 };
     
 #endif // SOUNDCLOUDPLAYLISTMODEL_H
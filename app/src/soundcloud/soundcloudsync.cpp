@@ -0,0 +1,388 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "soundcloudsync.h"
+#include "database.h"
+#include "soundcloud.h"
+#include "soundcloudartist.h"
+#include "soundcloudtrack.h"
+#include <qsoundcloud/resourcesrequest.h>
+#include <qsoundcloud/urls.h>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QSettings>
+#ifdef MUSIKLOUD_DEBUG
+#include <QDebug>
+#endif
+
+// Seconds after which the sets are pulled again, so that changes made with other clients are picked up
+static const int SYNC_INTERVAL = 60 * 60;
+
+SoundCloudSync* SoundCloudSync::self = 0;
+
+SoundCloudSync::SoundCloudSync(QObject *parent) :
+    QObject(parent),
+    m_request(0),
+    m_set(Followings),
+    m_loaded(false),
+    m_syncing(false),
+    m_stored(false)
+{
+    if (!self) {
+        self = this;
+    }
+    
+    m_idsLoaded[Followings] = false;
+    m_idsLoaded[Favourites] = false;
+    m_filters["limit"] = 200;
+    m_filters["linked_partitioning"] = true;
+    
+    connect(SoundCloud::instance(), SIGNAL(userIdChanged()), this, SLOT(onUserIdChanged()));
+    connect(SoundCloud::instance(), SIGNAL(artistFollowed(SoundCloudArtist*)),
+            this, SLOT(onArtistFollowed(SoundCloudArtist*)));
+    connect(SoundCloud::instance(), SIGNAL(artistUnfollowed(SoundCloudArtist*)),
+            this, SLOT(onArtistUnfollowed(SoundCloudArtist*)));
+    connect(SoundCloud::instance(), SIGNAL(trackFavourited(SoundCloudTrack*)),
+            this, SLOT(onTrackFavourited(SoundCloudTrack*)));
+    connect(SoundCloud::instance(), SIGNAL(trackUnfavourited(SoundCloudTrack*)),
+            this, SLOT(onTrackUnfavourited(SoundCloudTrack*)));
+}
+
+SoundCloudSync::~SoundCloudSync() {
+    if (self == this) {
+        self = 0;
+    }
+}
+
+SoundCloudSync* SoundCloudSync::instance() {
+    return self;
+}
+
+bool SoundCloudSync::isFollowingsLoaded() const {
+    QMutexLocker locker(&m_mutex);
+    return m_idsLoaded[Followings];
+}
+
+bool SoundCloudSync::isFavouritesLoaded() const {
+    QMutexLocker locker(&m_mutex);
+    return m_idsLoaded[Favourites];
+}
+
+bool SoundCloudSync::isFollowed(const QString &artistId) const {
+    QMutexLocker locker(&m_mutex);
+    return m_ids[Followings].contains(artistId);
+}
+
+bool SoundCloudSync::isFavourite(const QString &trackId) const {
+    QMutexLocker locker(&m_mutex);
+    return m_ids[Favourites].contains(trackId);
+}
+
+bool SoundCloudSync::isSyncing() const {
+    return m_syncing;
+}
+
+void SoundCloudSync::setSyncing(bool s) {
+    if (s != isSyncing()) {
+        m_syncing = s;
+        emit syncingChanged(s);
+    }
+}
+
+void SoundCloudSync::sync() {
+    if (isSyncing()) {
+        return;
+    }
+    
+    const QString userId = SoundCloud::instance()->userId();
+    
+    if (userId.isEmpty()) {
+        return;
+    }
+    
+    if ((!m_loaded) || (userId != m_userId)) {
+        load(userId);
+    }
+    
+    const QDateTime lastSync = QSettings().value("SoundCloud/lastSync/" + userId).toDateTime();
+    
+    if ((lastSync.isValid()) && (lastSync.secsTo(QDateTime::currentDateTime()) < SYNC_INTERVAL)) {
+        return;
+    }
+    
+    if (m_request) {
+        m_request->deleteLater();
+    }
+    
+    // The account may have changed since the last sync, so each sync uses a new request
+    m_request = new QSoundCloud::ResourcesRequest(this);
+    m_request->setClientId(SoundCloud::instance()->clientId());
+    m_request->setClientSecret(SoundCloud::instance()->clientSecret());
+    m_request->setAccessToken(SoundCloud::instance()->accessToken());
+    m_request->setRefreshToken(SoundCloud::instance()->refreshToken());
+    connect(m_request, SIGNAL(accessTokenChanged(QString)), SoundCloud::instance(), SLOT(setAccessToken(QString)));
+    connect(m_request, SIGNAL(refreshTokenChanged(QString)), SoundCloud::instance(), SLOT(setRefreshToken(QString)));
+    connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
+    
+    m_pulled.clear();
+    m_set = Followings;
+    m_stored = true;
+    setSyncing(true);
+    m_request->get("/me/followings", m_filters);
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "SoundCloudSync::sync" << userId << "last sync:" << lastSync;
+#endif
+}
+
+QString SoundCloudSync::tableName(Set set) {
+    return set == Followings ? "soundcloudFollowings" : "soundcloudFavourites";
+}
+
+QString SoundCloudSync::columnName(Set set) {
+    return set == Followings ? "artistId" : "trackId";
+}
+
+QSet<QString> SoundCloudSync::read(Set set, bool *ok) const {
+    QSet<QString> ids;
+    QSqlQuery query(getDatabase());
+    query.prepare(QString("SELECT %1 FROM %2 WHERE userId = ?").arg(columnName(set)).arg(tableName(set)));
+    query.addBindValue(m_userId);
+    *ok = query.exec();
+    
+    if (!*ok) {
+        qDebug() << "SoundCloudSync::read: database error:" << query.lastError().text();
+        return ids;
+    }
+    
+    while (query.next()) {
+        ids << query.value(0).toString();
+    }
+    
+    return ids;
+}
+
+bool SoundCloudSync::write(Set set, const QSet<QString> &added, const QSet<QString> &removed) const {
+    if ((added.isEmpty()) && (removed.isEmpty())) {
+        return true;
+    }
+    
+    QSqlDatabase db = getDatabase();
+    db.transaction();
+    QSqlQuery query(db);
+    
+    if (!added.isEmpty()) {
+        query.prepare(QString("INSERT OR IGNORE INTO %1 (userId, %2) VALUES (?, ?)").arg(tableName(set))
+                                                                                    .arg(columnName(set)));
+        
+        foreach (const QString &id, added) {
+            query.addBindValue(m_userId);
+            query.addBindValue(id);
+            
+            if (!query.exec()) {
+                qDebug() << "SoundCloudSync::write: database error:" << query.lastError().text();
+                db.rollback();
+                return false;
+            }
+        }
+    }
+    
+    if (!removed.isEmpty()) {
+        query.prepare(QString("DELETE FROM %1 WHERE userId = ? AND %2 = ?").arg(tableName(set)).arg(columnName(set)));
+        
+        foreach (const QString &id, removed) {
+            query.addBindValue(m_userId);
+            query.addBindValue(id);
+            
+            if (!query.exec()) {
+                qDebug() << "SoundCloudSync::write: database error:" << query.lastError().text();
+                db.rollback();
+                return false;
+            }
+        }
+    }
+    
+    db.commit();
+    return true;
+}
+
+void SoundCloudSync::load(const QString &userId) {
+    m_userId = userId;
+    m_loaded = true;
+    // The stored sets are only complete if a sync of this account has finished before
+    const bool synced = QSettings().contains("SoundCloud/lastSync/" + userId);
+    bool followingsOk = false;
+    bool favouritesOk = false;
+    const QSet<QString> followings = read(Followings, &followingsOk);
+    const QSet<QString> favourites = read(Favourites, &favouritesOk);
+    
+    QMutexLocker locker(&m_mutex);
+    m_ids[Followings] = followings;
+    m_ids[Favourites] = favourites;
+    m_idsLoaded[Followings] = (synced) && (followingsOk);
+    m_idsLoaded[Favourites] = (synced) && (favouritesOk);
+    locker.unlock();
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "SoundCloudSync::load" << userId << followings.size() << "followings" << favourites.size()
+             << "favourites";
+#endif
+    if (isFollowingsLoaded()) {
+        emit followingsLoaded();
+    }
+    
+    if (isFavouritesLoaded()) {
+        emit favouritesLoaded();
+    }
+}
+
+void SoundCloudSync::update(Set set, const QString &id, bool member) {
+    if ((!m_loaded) || (id.isEmpty())) {
+        return;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    
+    if (member) {
+        m_ids[set].insert(id);
+    }
+    else {
+        m_ids[set].remove(id);
+    }
+    
+    locker.unlock();
+    
+    // Pages of the set being pulled may have been fetched before the change was made
+    if ((isSyncing()) && (set == m_set)) {
+        if (member) {
+            m_pulled.insert(id);
+        }
+        else {
+            m_pulled.remove(id);
+        }
+    }
+    
+    const QSet<QString> ids = QSet<QString>() << id;
+    
+    if (member) {
+        write(set, ids, QSet<QString>());
+    }
+    else {
+        write(set, QSet<QString>(), ids);
+    }
+}
+
+void SoundCloudSync::finishSet() {
+    m_mutex.lock();
+    const QSet<QString> ids = m_ids[m_set];
+    m_mutex.unlock();
+    
+    if (!write(m_set, m_pulled - ids, ids - m_pulled)) {
+        m_stored = false;
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "SoundCloudSync::finishSet" << tableName(m_set) << (m_pulled - ids).size() << "added"
+             << (ids - m_pulled).size() << "removed";
+#endif
+    m_mutex.lock();
+    m_ids[m_set] = m_pulled;
+    m_idsLoaded[m_set] = true;
+    m_mutex.unlock();
+    m_pulled.clear();
+    
+    if (m_set == Followings) {
+        emit followingsLoaded();
+    }
+    else {
+        emit favouritesLoaded();
+    }
+}
+
+void SoundCloudSync::onUserIdChanged() {
+    if (m_request) {
+        m_request->cancel();
+        m_request->deleteLater();
+        m_request = 0;
+    }
+    
+    m_loaded = false;
+    m_pulled.clear();
+    setSyncing(false);
+    
+    QMutexLocker locker(&m_mutex);
+    m_ids[Followings].clear();
+    m_ids[Favourites].clear();
+    m_idsLoaded[Followings] = false;
+    m_idsLoaded[Favourites] = false;
+    locker.unlock();
+    sync();
+}
+
+void SoundCloudSync::onArtistFollowed(SoundCloudArtist *artist) {
+    update(Followings, artist->id(), true);
+}
+
+void SoundCloudSync::onArtistUnfollowed(SoundCloudArtist *artist) {
+    update(Followings, artist->id(), false);
+}
+
+void SoundCloudSync::onTrackFavourited(SoundCloudTrack *track) {
+    update(Favourites, track->id(), true);
+}
+
+void SoundCloudSync::onTrackUnfavourited(SoundCloudTrack *track) {
+    update(Favourites, track->id(), false);
+}
+
+void SoundCloudSync::onRequestFinished() {
+    if (sender() != m_request) {
+        return;
+    }
+    
+    if (m_request->status() != QSoundCloud::ResourcesRequest::Ready) {
+#ifdef MUSIKLOUD_DEBUG
+        qDebug() << "SoundCloudSync::onRequestFinished: sync failed" << m_request->errorString();
+#endif
+        m_pulled.clear();
+        setSyncing(false);
+        return;
+    }
+    
+    const QVariantMap result = m_request->result().toMap();
+    
+    foreach (const QVariant &item, result.value("collection").toList()) {
+        m_pulled.insert(item.toMap().value("id").toString());
+    }
+    
+    const QString nextHref = result.value("next_href").toString().section(QSoundCloud::API_URL, -1);
+    
+    if (!nextHref.isEmpty()) {
+        m_request->get(nextHref);
+        return;
+    }
+    
+    finishSet();
+    
+    if (m_set == Followings) {
+        m_set = Favourites;
+        m_request->get("/me/favorites", m_filters);
+        return;
+    }
+    
+    if (m_stored) {
+        QSettings().setValue("SoundCloud/lastSync/" + m_userId, QDateTime::currentDateTime());
+    }
+    
+    setSyncing(false);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SOUNDCLOUDSYNC_H
+#define SOUNDCLOUDSYNC_H
+
+#include <QObject>
+#include <QMutex>
+#include <QSet>
+#include <QVariantMap>
+
+namespace QSoundCloud {
+    class ResourcesRequest;
+}
+
+class SoundCloudArtist;
+class SoundCloudTrack;
+
+/*
+ * Mirrors the followings and favourites of the active SoundCloud account. The ids are stored in the
+ * soundcloudFollowings and soundcloudFavourites tables and held in hashed sets, so that isFollowed() and
+ * isFavourite() are answered without a request. The lookups may be called from any thread.
+ *
+ * sync() pulls both sets from SoundCloud when the last sync is older than an hour, and writes only the ids that
+ * were added or removed since. Follows and favourites made in the application are applied as they happen.
+ */
+class SoundCloudSync : public QObject
+{
+    Q_OBJECT
+    
+    Q_PROPERTY(bool syncing READ isSyncing NOTIFY syncingChanged)
+
+public:
+    explicit SoundCloudSync(QObject *parent = 0);
+    ~SoundCloudSync();
+    
+    static SoundCloudSync* instance();
+    
+    bool isFollowingsLoaded() const;
+    bool isFavouritesLoaded() const;
+    
+    Q_INVOKABLE bool isFollowed(const QString &artistId) const;
+    Q_INVOKABLE bool isFavourite(const QString &trackId) const;
+    
+    bool isSyncing() const;
+
+public Q_SLOTS:
+    void sync();
+
+private Q_SLOTS:
+    void onUserIdChanged();
+    
+    void onArtistFollowed(SoundCloudArtist *artist);
+    void onArtistUnfollowed(SoundCloudArtist *artist);
+    void onTrackFavourited(SoundCloudTrack *track);
+    void onTrackUnfavourited(SoundCloudTrack *track);
+    
+    void onRequestFinished();
+
+Q_SIGNALS:
+    void followingsLoaded();
+    void favouritesLoaded();
+    void syncingChanged(bool s);
+
+private:
+    enum Set {
+        Followings = 0,
+        Favourites
+    };
+    
+    static QString tableName(Set set);
+    static QString columnName(Set set);
+    
+    QSet<QString> read(Set set, bool *ok) const;
+    bool write(Set set, const QSet<QString> &added, const QSet<QString> &removed) const;
+    
+    void load(const QString &userId);
+    void update(Set set, const QString &id, bool member);
+    void finishSet();
+    
+    void setSyncing(bool s);
+    
+    static SoundCloudSync *self;
+    
+    QSoundCloud::ResourcesRequest *m_request;
+    
+    QVariantMap m_filters;
+    
+    QString m_userId;
+    
+    mutable QMutex m_mutex;
+    
+    QSet<QString> m_ids[2];
+    bool m_idsLoaded[2];
+    
+    QSet<QString> m_pulled;
+    Set m_set;
+    
+    bool m_loaded;
+    bool m_syncing;
+    bool m_stored;
+};
+
+#endif // SOUNDCLOUDSYNC_H
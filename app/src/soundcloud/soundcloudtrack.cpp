@@ -18,6 +18,7 @@
 #include "definitions.h"
 #include "resources.h"
 #include "soundcloud.h"
+#include "soundcloudsync.h"
 #include "utils.h"
 #include <QDateTime>
 #ifdef MUSIKLOUD_DEBUG
@@ -33,10 +34,8 @@ SoundCloudTrack::SoundCloudTrack(QObject *parent) :
     m_streamable(true)
 {
     setService(Resources::SOUNDCLOUD);
-    connect(SoundCloud::instance(), SIGNAL(trackFavourited(SoundCloudTrack*)),
-            this, SLOT(onTrackUpdated(SoundCloudTrack*)));
-    connect(SoundCloud::instance(), SIGNAL(trackUnfavourited(SoundCloudTrack*)),
-            this, SLOT(onTrackUpdated(SoundCloudTrack*)));
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+    onIdChanged();
 }
 
 SoundCloudTrack::SoundCloudTrack(const QString &id, QObject *parent) :
@@ -49,10 +48,8 @@ SoundCloudTrack::SoundCloudTrack(const QString &id, QObject *parent) :
 {
     setService(Resources::SOUNDCLOUD);
     loadTrack(id);
-    connect(SoundCloud::instance(), SIGNAL(trackFavourited(SoundCloudTrack*)),
-            this, SLOT(onTrackUpdated(SoundCloudTrack*)));
-    connect(SoundCloud::instance(), SIGNAL(trackUnfavourited(SoundCloudTrack*)),
-            this, SLOT(onTrackUpdated(SoundCloudTrack*)));
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+    onIdChanged();
 }
 
 SoundCloudTrack::SoundCloudTrack(const QVariantMap &track, QObject *parent) :
@@ -65,10 +62,8 @@ SoundCloudTrack::SoundCloudTrack(const QVariantMap &track, QObject *parent) :
 {
     setService(Resources::SOUNDCLOUD);
     loadTrack(track);
-    connect(SoundCloud::instance(), SIGNAL(trackFavourited(SoundCloudTrack*)),
-            this, SLOT(onTrackUpdated(SoundCloudTrack*)));
-    connect(SoundCloud::instance(), SIGNAL(trackUnfavourited(SoundCloudTrack*)),
-            this, SLOT(onTrackUpdated(SoundCloudTrack*)));
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+    onIdChanged();
 }
 
 SoundCloudTrack::SoundCloudTrack(SoundCloudTrack *track, QObject *parent) :
@@ -81,10 +76,65 @@ SoundCloudTrack::SoundCloudTrack(SoundCloudTrack *track, QObject *parent) :
     m_streamable(track->isStreamable()),
     m_waveformUrl(track->waveformUrl())
 {
-    connect(SoundCloud::instance(), SIGNAL(trackFavourited(SoundCloudTrack*)),
-            this, SLOT(onTrackUpdated(SoundCloudTrack*)));
-    connect(SoundCloud::instance(), SIGNAL(trackUnfavourited(SoundCloudTrack*)),
-            this, SLOT(onTrackUpdated(SoundCloudTrack*)));
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+    onIdChanged();
+}
+
+SoundCloudTrack::SoundCloudTrack(const TrackRecord &record, QObject *parent) :
+    MKTrack(record, parent),
+    m_request(0),
+    m_commentable(record.isCommentable()),
+    m_favourite(record.isFavourite()),
+    m_favouriteCount(record.favouriteCount()),
+    m_sharing(record.sharing()),
+    m_streamable(record.isStreamable()),
+    m_waveformUrl(record.waveformUrl())
+{
+    connect(this, SIGNAL(idChanged()), this, SLOT(onIdChanged()));
+    onIdChanged();
+}
+
+SoundCloudTrack::~SoundCloudTrack() {
+    if (SoundCloud *soundcloud = SoundCloud::instance()) {
+        soundcloud->removeTrack(m_registeredId, this);
+    }
+}
+
+// Results that are not requested with the account's token have no user_favorite value
+static bool isSyncedFavourite(const QString &id) {
+    const SoundCloudSync *sync = SoundCloudSync::instance();
+    return (sync) && (sync->isFavourite(id));
+}
+
+TrackRecord SoundCloudTrack::toRecord(const QVariantMap &track) {
+    const QVariantMap user = track.value("user").toMap();
+    const QString thumbnail = track.value("artwork_url").toString();
+    TrackRecord record;
+    record.setArtist(user.value("username").toString());
+    record.setArtistId(user.value("id").toString());
+    record.setCommentable(track.value("commentable").toBool());
+    record.setDate(QDateTime::fromString(track.value("created_at").toString(),
+                                         "yyyy/MM/dd HH:mm:ss +0000").toString("dd MMM yyyy"));
+    record.setDescription(track.value("description").toString());
+    record.setDownloadable(track.value("downloadable").toBool());
+    record.setDuration(track.value("duration").toLongLong());
+    record.setFavourite(track.contains("user_favorite") ? track.value("user_favorite").toBool()
+                                                        : isSyncedFavourite(track.value("id").toString()));
+    record.setFavouriteCount(track.value("favoritings_count").toLongLong());
+    record.setFormat(track.value("original_format").toString().toUpper());
+    record.setGenre(track.value("genre").toString());
+    record.setId(track.value("id").toString());
+    record.setLargeThumbnailUrl(QString("%1-t%2x%2.jpg").arg(thumbnail.left(thumbnail.lastIndexOf('-')))
+                                                       .arg(LARGE_THUMBNAIL_SIZE));
+    record.setPlayCount(track.value("playback_count").toLongLong());
+    record.setService(Resources::SOUNDCLOUD);
+    record.setSize(track.value("original_content_size").toLongLong());
+    record.setStreamable(track.value("streamable").toBool());
+    record.setThumbnailUrl(thumbnail);
+    record.setTitle(track.value("title").toString());
+    record.setUrl(track.value("permalink_url").toString());
+    record.setWaveformUrl(track.value("waveform_url").toString());
+    return record;
 }
 
 bool SoundCloudTrack::isCommentable() const {
@@ -181,31 +231,19 @@ void SoundCloudTrack::loadTrack(const QString &id) {
     emit statusChanged(status());
 }
 
+TrackRecord SoundCloudTrack::record() const {
+    TrackRecord record = MKTrack::record();
+    record.setCommentable(isCommentable());
+    record.setFavourite(isFavourite());
+    record.setFavouriteCount(favouriteCount());
+    record.setSharing(sharing());
+    record.setStreamable(isStreamable());
+    record.setWaveformUrl(waveformUrl());
+    return record;
+}
+
 void SoundCloudTrack::loadTrack(const QVariantMap &track) {
-    QVariantMap user = track.value("user").toMap();
-    const QString thumbnail = track.value("artwork_url").toString();
-    
-    setArtist(user.value("username").toString());
-    setArtistId(user.value("id").toString());
-    setCommentable(track.value("commentable").toBool());
-    setDate(QDateTime::fromString(track.value("created_at").toString(),
-                                  "yyyy/MM/dd HH:mm:ss +0000").toString("dd MMM yyyy"));
-    setDescription(track.value("description").toString());
-    setDownloadable(track.value("downloadable").toBool());
-    setDuration(track.value("duration").toLongLong());
-    setFavourite(track.value("user_favorite").toBool());
-    setFavouriteCount(track.value("favoritings_count").toLongLong());
-    setFormat(track.value("original_format").toString().toUpper());
-    setGenre(track.value("genre").toString());
-    setId(track.value("id").toString());
-    setLargeThumbnailUrl(QString("%1-t%2x%2.jpg").arg(thumbnail.left(thumbnail.lastIndexOf('-'))).arg(LARGE_THUMBNAIL_SIZE));
-    setPlayCount(track.value("playback_count").toLongLong());
-    setSize(track.value("original_content_size").toLongLong());
-    setStreamable(track.value("streamable").toBool());
-    setThumbnailUrl(thumbnail);
-    setTitle(track.value("title").toString());
-    setUrl(track.value("permalink_url").toString());
-    setWaveformUrl(track.value("waveform_url").toString());
+    loadRecord(toRecord(track));
 }
 
 void SoundCloudTrack::loadTrack(SoundCloudTrack *track) {
@@ -245,6 +283,15 @@ void SoundCloudTrack::unfavourite() {
 #endif
 }
 
+void SoundCloudTrack::loadRecord(const TrackRecord &record) {
+    MKTrack::loadRecord(record);
+    setCommentable(record.isCommentable());
+    setFavourite(record.isFavourite());
+    setFavouriteCount(record.favouriteCount());
+    setStreamable(record.isStreamable());
+    setWaveformUrl(record.waveformUrl());
+}
+
 void SoundCloudTrack::initRequest() {
     if (!m_request) {
         m_request = new QSoundCloud::ResourcesRequest(this);
@@ -295,8 +342,10 @@ void SoundCloudTrack::onUnfavouriteRequestFinished() {
     emit statusChanged(status());
 }
 
-void SoundCloudTrack::onTrackUpdated(SoundCloudTrack *track) {
-    if ((track->id() == id()) && (track != this)) {
-        loadTrack(track);
+void SoundCloudTrack::onIdChanged() {
+    if (SoundCloud *soundcloud = SoundCloud::instance()) {
+        soundcloud->removeTrack(m_registeredId, this);
+        m_registeredId = id();
+        soundcloud->addTrack(m_registeredId, this);
     }
 }
@@ -38,6 +38,10 @@ public:
     explicit SoundCloudTrack(const QString &id, QObject *parent = 0);
     explicit SoundCloudTrack(const QVariantMap &track, QObject *parent = 0);
     explicit SoundCloudTrack(SoundCloudTrack *track, QObject *parent = 0);
+    explicit SoundCloudTrack(const TrackRecord &record, QObject *parent = 0);
+    ~SoundCloudTrack();
+    
+    static TrackRecord toRecord(const QVariantMap &track);
     
     bool isCommentable() const;
         
@@ -54,6 +58,8 @@ public:
     
     QUrl waveformUrl() const;
     
+    TrackRecord record() const;
+    
     Q_INVOKABLE void loadTrack(const QString &id);
     Q_INVOKABLE void loadTrack(const QVariantMap &track);
     Q_INVOKABLE void loadTrack(SoundCloudTrack *track);
@@ -65,6 +71,8 @@ public Q_SLOTS:
 private:
     void initRequest();
     
+    void loadRecord(const TrackRecord &record);
+    
     void setCommentable(bool c);
     
     void setFavourite(bool f);
@@ -80,7 +88,7 @@ private Q_SLOTS:
     void onTrackRequestFinished();
     void onFavouriteRequestFinished();
     void onUnfavouriteRequestFinished();
-    void onTrackUpdated(SoundCloudTrack *track);
+    void onIdChanged();
     
 Q_SIGNALS:
     void commentableChanged();
@@ -109,6 +117,8 @@ private:
     bool m_streamable;
     
     QUrl m_waveformUrl;
+    
+    QString m_registeredId;
 };
 
 #endif // SOUNDCLOUDTRACK_H
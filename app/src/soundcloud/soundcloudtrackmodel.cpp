@@ -15,40 +15,108 @@
  */
 
 #include "soundcloudtrackmodel.h"
+#include "resources.h"
+#include "roletable.h"
 #include "soundcloud.h"
+#include "trackrecordtask.h"
 #include <qsoundcloud/urls.h>
+#include <QThreadPool>
+#include <algorithm>
 #ifdef MUSIKLOUD_DEBUG
 #include <QDebug>
 #endif
 
+static const char* const ROLE_NAMES[] = {
+    "artist",
+    "artistId",
+    "commentable",
+    "date",
+    "description",
+    "downloadable",
+    "duration",
+    "durationString",
+    "favourited",
+    "favouriteCount",
+    "genre",
+    "id",
+    "largeThumbnailUrl",
+    "playCount",
+    "sharing",
+    "size",
+    "sizeString",
+    "streamable",
+    "thumbnailUrl",
+    "title",
+    "url",
+    "waveformUrl",
+    0
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(RoleTable, roleTable, (SoundCloudTrackModel::ArtistRole, ROLE_NAMES))
+
+static TrackRecord trackRecord(const QString &, const QVariantMap &track) {
+    return SoundCloudTrack::toRecord(track);
+}
+
+template<class T>
+static QVariant trackData(const T &track, int role) {
+    switch (role) {
+    case SoundCloudTrackModel::ArtistRole:
+        return track.artist();
+    case SoundCloudTrackModel::ArtistIdRole:
+        return track.artistId();
+    case SoundCloudTrackModel::CommentableRole:
+        return track.isCommentable();
+    case SoundCloudTrackModel::DateRole:
+        return track.date();
+    case SoundCloudTrackModel::DescriptionRole:
+        return track.description();
+    case SoundCloudTrackModel::DownloadableRole:
+        return track.isDownloadable();
+    case SoundCloudTrackModel::DurationRole:
+        return track.duration();
+    case SoundCloudTrackModel::DurationStringRole:
+        return track.durationString();
+    case SoundCloudTrackModel::FavouriteRole:
+        return track.isFavourite();
+    case SoundCloudTrackModel::FavouriteCountRole:
+        return track.favouriteCount();
+    case SoundCloudTrackModel::GenreRole:
+        return track.genre();
+    case SoundCloudTrackModel::IdRole:
+        return track.id();
+    case SoundCloudTrackModel::LargeThumbnailUrlRole:
+        return track.largeThumbnailUrl();
+    case SoundCloudTrackModel::PlayCountRole:
+        return track.playCount();
+    case SoundCloudTrackModel::SharingRole:
+        return track.sharing();
+    case SoundCloudTrackModel::SizeRole:
+        return track.size();
+    case SoundCloudTrackModel::SizeStringRole:
+        return track.sizeString();
+    case SoundCloudTrackModel::StreamableRole:
+        return track.isStreamable();
+    case SoundCloudTrackModel::ThumbnailUrlRole:
+        return track.thumbnailUrl();
+    case SoundCloudTrackModel::TitleRole:
+        return track.title();
+    case SoundCloudTrackModel::UrlRole:
+        return track.url();
+    case SoundCloudTrackModel::WaveformUrlRole:
+        return track.waveformUrl();
+    default:
+        return QVariant();
+    }
+}
+
 SoundCloudTrackModel::SoundCloudTrackModel(QObject *parent) :
     QAbstractListModel(parent),
-    m_request(new QSoundCloud::ResourcesRequest(this))
+    m_request(new QSoundCloud::ResourcesRequest(this)),
+    m_rowsIndexed(true)
 {
-    m_roles[ArtistRole] = "artist";
-    m_roles[ArtistIdRole] = "artistId";
-    m_roles[CommentableRole] = "commentable";
-    m_roles[DateRole] = "date";
-    m_roles[DescriptionRole] = "description";
-    m_roles[DownloadableRole] = "downloadable";
-    m_roles[DurationRole] = "duration";
-    m_roles[DurationStringRole] = "durationString";
-    m_roles[FavouriteRole] = "favourited";
-    m_roles[FavouriteCountRole] = "favouriteCount";
-    m_roles[GenreRole] = "genre";
-    m_roles[IdRole] = "id";
-    m_roles[LargeThumbnailUrlRole] = "largeThumbnailUrl";
-    m_roles[PlayCountRole] = "playCount";
-    m_roles[SharingRole] = "sharing";
-    m_roles[SizeRole] = "size";
-    m_roles[SizeStringRole] = "sizeString";
-    m_roles[StreamableRole] = "streamable";
-    m_roles[ThumbnailUrlRole] = "thumbnailUrl";
-    m_roles[TitleRole] = "title";
-    m_roles[UrlRole] = "url";
-    m_roles[WaveformUrlRole] = "waveformUrl";
 #if QT_VERSION < 0x050000
-    setRoleNames(m_roles);
+    setRoleNames(roleTable()->roleNames());
 #endif
     m_request->setClientId(SoundCloud::instance()->clientId());
     m_request->setClientSecret(SoundCloud::instance()->clientSecret());
@@ -58,6 +126,10 @@ SoundCloudTrackModel::SoundCloudTrackModel(QObject *parent) :
     connect(m_request, SIGNAL(accessTokenChanged(QString)), SoundCloud::instance(), SLOT(setAccessToken(QString)));
     connect(m_request, SIGNAL(refreshTokenChanged(QString)), SoundCloud::instance(), SLOT(setRefreshToken(QString)));
     connect(m_request, SIGNAL(finished()), this, SLOT(onRequestFinished()));
+    connect(SoundCloud::instance(), SIGNAL(trackFavourited(SoundCloudTrack*)),
+            this, SLOT(onTrackUpdated(SoundCloudTrack*)));
+    connect(SoundCloud::instance(), SIGNAL(trackUnfavourited(SoundCloudTrack*)),
+            this, SLOT(onTrackUpdated(SoundCloudTrack*)));
 }
 
 QString SoundCloudTrackModel::errorString() const {
@@ -65,17 +137,18 @@ QString SoundCloudTrackModel::errorString() const {
 }
 
 QSoundCloud::ResourcesRequest::Status SoundCloudTrackModel::status() const {
-    return m_request->status();
+    // The model is still loading until the records of the last page have been inserted
+    return m_task ? QSoundCloud::ResourcesRequest::Loading : m_request->status();
 }
 
 #if QT_VERSION >=0x050000
 QHash<int, QByteArray> SoundCloudTrackModel::roleNames() const {
-    return m_roles;
+    return roleTable()->roleNames();
 }
 #endif
 
 int SoundCloudTrackModel::rowCount(const QModelIndex &) const {
-    return m_items.size();
+    return m_records.size();
 }
 
 bool SoundCloudTrackModel::canFetchMore(const QModelIndex &) const {
@@ -92,22 +165,25 @@ void SoundCloudTrackModel::fetchMore(const QModelIndex &) {
 }
 
 QVariant SoundCloudTrackModel::data(const QModelIndex &index, int role) const {
-    if (SoundCloudTrack *track = get(index.row())) {
-        return track->property(m_roles[role]);
+    const int row = index.row();
+    
+    if ((row < 0) || (row >= rowCount())) {
+        return QVariant();
     }
     
-    return QVariant();
+    if (const SoundCloudTrack *track = m_items.at(row)) {
+        return trackData(*track, role);
+    }
+    
+    return trackData(m_records.at(row), role);
 }
 
 QMap<int, QVariant> SoundCloudTrackModel::itemData(const QModelIndex &index) const {
     QMap<int, QVariant> map;
     
-    if (SoundCloudTrack *track = get(index.row())) {
-        QHashIterator<int, QByteArray> iterator(m_roles);
-        
-        while (iterator.hasNext()) {
-            iterator.next();
-            map[iterator.key()] = track->property(iterator.value());
+    if ((index.row() >= 0) && (index.row() < rowCount())) {
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[role] = data(index, role);
         }
     }
     
@@ -115,19 +191,17 @@ QMap<int, QVariant> SoundCloudTrackModel::itemData(const QModelIndex &index) con
 }
 
 QVariant SoundCloudTrackModel::data(int row, const QByteArray &role) const {
-    if (SoundCloudTrack *track = get(row)) {
-        return track->property(role);
-    }
-    
-    return QVariant();
+    return data(index(row), roleTable()->role(role));
 }
 
 QVariantMap SoundCloudTrackModel::itemData(int row) const {
     QVariantMap map;
     
-    if (SoundCloudTrack *track = get(row)) {
-        foreach (QByteArray role, m_roles.values()) {
-            map[role] = track->property(role);
+    if ((row >= 0) && (row < rowCount())) {
+        const QModelIndex idx = index(row);
+        
+        for (int role = roleTable()->firstRole(); role <= roleTable()->lastRole(); role++) {
+            map[roleTable()->name(role)] = data(idx, role);
         }
     }
     
@@ -135,15 +209,31 @@ QVariantMap SoundCloudTrackModel::itemData(int row) const {
 }
 
 SoundCloudTrack* SoundCloudTrackModel::get(int row) const {
-    if ((row >= 0) && (row < m_items.size())) {
-        return m_items.at(row);
+    if ((row < 0) || (row >= rowCount())) {
+        return 0;
+    }
+    
+    if (!m_items.at(row)) {
+        m_items[row] = new SoundCloudTrack(m_records.at(row), const_cast<SoundCloudTrackModel*>(this));
     }
     
-    return 0;
+    return m_items.at(row);
+}
+
+TrackRecord SoundCloudTrackModel::record(int row) const {
+    if ((row < 0) || (row >= rowCount())) {
+        return TrackRecord();
+    }
+    
+    if (SoundCloudTrack *track = m_items.at(row)) {
+        return track->record();
+    }
+    
+    return m_records.at(row);
 }
 
 void SoundCloudTrackModel::get(const QString &resourcePath, const QVariantMap &filters) {
-    if (status() == QSoundCloud::ResourcesRequest::Loading) {
+    if (m_request->status() == QSoundCloud::ResourcesRequest::Loading) {
         return;
     }
     
@@ -158,7 +248,10 @@ void SoundCloudTrackModel::get(const QString &resourcePath, const QVariantMap &f
     m_request->get(m_resourcePath, m_filters);
     emit statusChanged(status());
     
-    disconnect(SoundCloud::instance(), 0, this, 0);
+    disconnect(SoundCloud::instance(), SIGNAL(trackFavourited(SoundCloudTrack*)),
+               this, SLOT(onTrackFavourited(SoundCloudTrack*)));
+    disconnect(SoundCloud::instance(), SIGNAL(trackUnfavourited(SoundCloudTrack*)),
+               this, SLOT(onTrackUnfavourited(SoundCloudTrack*)));
         
     if (resourcePath == "/me/favorites") {
         connect(SoundCloud::instance(), SIGNAL(trackFavourited(SoundCloudTrack*)),
@@ -169,10 +262,16 @@ void SoundCloudTrackModel::get(const QString &resourcePath, const QVariantMap &f
 }
 
 void SoundCloudTrackModel::clear() {
-    if (!m_items.isEmpty()) {
+    // Discard the records of a page that is still being converted
+    m_task = 0;
+    
+    if (!m_records.isEmpty()) {
         beginResetModel();
         qDeleteAll(m_items);
         m_items.clear();
+        m_records.clear();
+        m_rows.clear();
+        m_rowsIndexed = true;
         m_nextHref = QString();
         endResetModel();
         emit countChanged(rowCount());
@@ -180,7 +279,13 @@ void SoundCloudTrackModel::clear() {
 }
 
 void SoundCloudTrackModel::cancel() {
-    m_request->cancel();
+    if (m_task) {
+        m_task = 0;
+        emit statusChanged(status());
+    }
+    else {
+        m_request->cancel();
+    }
 }
 
 void SoundCloudTrackModel::reload() {
@@ -189,16 +294,24 @@ void SoundCloudTrackModel::reload() {
     emit statusChanged(status());
 }
 
-void SoundCloudTrackModel::append(SoundCloudTrack *track) {
-    beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
-    m_items << track;
+void SoundCloudTrackModel::append(const TrackRecord &track) {
+    beginInsertRows(QModelIndex(), rowCount(), rowCount());
+    
+    if (m_rowsIndexed) {
+        m_rows.insert(track.id(), rowCount());
+    }
+    
+    m_records << track;
+    m_items << 0;
     endInsertRows();
 }
 
-void SoundCloudTrackModel::insert(int row, SoundCloudTrack *track) {
-    if ((row >= 0) && (row < m_items.size())) {
+void SoundCloudTrackModel::insert(int row, const TrackRecord &track) {
+    if ((row >= 0) && (row < rowCount())) {
         beginInsertRows(QModelIndex(), row, row);
-        m_items.insert(row, track);
+        m_records.insert(row, track);
+        m_items.insert(row, 0);
+        m_rowsIndexed = false;
         endInsertRows();
     }
     else {
@@ -207,13 +320,33 @@ void SoundCloudTrackModel::insert(int row, SoundCloudTrack *track) {
 }
 
 void SoundCloudTrackModel::remove(int row) {
-    if ((row >= 0) && (row < m_items.size())) {
+    if ((row >= 0) && (row < rowCount())) {
         beginRemoveRows(QModelIndex(), row, row);
-        m_items.takeAt(row)->deleteLater();
+        m_records.removeAt(row);
+        m_rowsIndexed = false;
+        
+        if (SoundCloudTrack *track = m_items.takeAt(row)) {
+            track->deleteLater();
+        }
+        
         endRemoveRows();
     }
 }
 
+QList<int> SoundCloudTrackModel::rows(const QString &id) const {
+    if (!m_rowsIndexed) {
+        m_rows.clear();
+        
+        for (int i = 0; i < m_records.size(); i++) {
+            m_rows.insert(m_records.at(i).id(), i);
+        }
+        
+        m_rowsIndexed = true;
+    }
+    
+    return m_rows.values(id);
+}
+
 void SoundCloudTrackModel::onRequestFinished() {
     if (m_request->status() == QSoundCloud::ResourcesRequest::Ready) {
         QVariantMap result = m_request->result().toMap();
@@ -221,35 +354,75 @@ void SoundCloudTrackModel::onRequestFinished() {
         if (!result.isEmpty()) {
             m_nextHref = result.value("next_href").toString().section(QSoundCloud::API_URL, -1);
             QVariantList list = result.value(m_resourcePath.contains("/playlists/") ? "tracks" : "collection").toList();
-
-            beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + list.size() - 1);
-    
-            foreach (QVariant item, list) {
-                m_items << new SoundCloudTrack(item.toMap(), this);
+            
+            if (!list.isEmpty()) {
+                // statusChanged() is emitted once the records have been inserted
+                m_task = new TrackRecordTask(Resources::SOUNDCLOUD, list, trackRecord);
+                connect(m_task, SIGNAL(recordsReady(QList<TrackRecord>)), this, SLOT(onRecordsReady(QList<TrackRecord>)));
+                connect(m_task, SIGNAL(finished()), this, SLOT(onRecordsFinished()));
+                QThreadPool::globalInstance()->start(m_task);
+                return;
             }
-
-            endInsertRows();
-            emit countChanged(rowCount());
         }
     }
     
     emit statusChanged(status());
 }
 
+void SoundCloudTrackModel::onRecordsReady(const QList<TrackRecord> &records) {
+    if (sender() != m_task.data()) {
+        return;
+    }
+    
+    beginInsertRows(QModelIndex(), rowCount(), rowCount() + records.size() - 1);
+    
+    for (int i = 0; i < records.size(); i++) {
+        if (m_rowsIndexed) {
+            m_rows.insert(records.at(i).id(), rowCount() + i);
+        }
+        
+        m_items << 0;
+    }
+    
+    m_records << records;
+    
+    endInsertRows();
+    emit countChanged(rowCount());
+}
+
+void SoundCloudTrackModel::onRecordsFinished() {
+    if (sender() == m_task.data()) {
+        m_task = 0;
+        emit statusChanged(status());
+    }
+}
+
 void SoundCloudTrackModel::onTrackFavourited(SoundCloudTrack *track) {
-    insert(0, new SoundCloudTrack(track, this));
+    insert(0, track->record());
 #ifdef MUSIKLOUD_DEBUG
     qDebug() << "SoundCloudTrackModel::onTrackFavourited" << track->id();
 #endif
 }
 
 void SoundCloudTrackModel::onTrackUnfavourited(SoundCloudTrack *track) {
-    QModelIndexList list = match(index(0), IdRole, track->id(), 1, Qt::MatchExactly);
+    const QList<int> list = rows(track->id());
     
     if (!list.isEmpty()) {
-        remove(list.first().row());
+        remove(*std::min_element(list.constBegin(), list.constEnd()));
     }
 #ifdef MUSIKLOUD_DEBUG
     qDebug() << "SoundCloudTrackModel::onTrackUnfavourited" << track->id();
 #endif
 }
+
+void SoundCloudTrackModel::onTrackUpdated(SoundCloudTrack *track) {
+    // Track objects update themselves, so only the rows that are still records are updated here
+    foreach (int i, rows(track->id())) {
+        if (!m_items.at(i)) {
+            m_records[i].setFavourite(track->isFavourite());
+            m_records[i].setFavouriteCount(track->favouriteCount());
+            const QModelIndex idx = index(i);
+            emit dataChanged(idx, idx);
+        }
+    }
+}
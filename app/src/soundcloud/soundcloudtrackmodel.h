@@ -19,8 +19,11 @@
 
 #include "soundcloudtrack.h"
 #include <QAbstractListModel>
+#include <QMultiHash>
+#include <QPointer>
 
 class SoundCloudPlaylist;
+class TrackRecordTask;
 
 class SoundCloudTrackModel : public QAbstractListModel
 {
@@ -79,6 +82,8 @@ public:
     
     Q_INVOKABLE SoundCloudTrack* get(int row) const;
     
+    TrackRecord record(int row) const;
+    
     Q_INVOKABLE void get(const QString &resourcePath, const QVariantMap &filters = QVariantMap());
 
 public Q_SLOTS:
@@ -87,14 +92,19 @@ public Q_SLOTS:
     void reload();
     
 private:
-    void append(SoundCloudTrack *track);
-    void insert(int row, SoundCloudTrack *track);
+    void append(const TrackRecord &track);
+    void insert(int row, const TrackRecord &track);
     void remove(int row);
     
+    QList<int> rows(const QString &id) const;
+    
 private Q_SLOTS:
     void onRequestFinished();
+    void onRecordsReady(const QList<TrackRecord> &records);
+    void onRecordsFinished();
     void onTrackFavourited(SoundCloudTrack *track);
     void onTrackUnfavourited(SoundCloudTrack *track);
+    void onTrackUpdated(SoundCloudTrack *track);
     
 Q_SIGNALS:
     void countChanged(int c);
@@ -107,9 +117,19 @@ private:
     QVariantMap m_filters;
     QString m_nextHref;
         
-    QList<SoundCloudTrack*> m_items;
+    // Rows are held as records, and a track object is only created for a row when it is requested with get()
+    QList<TrackRecord> m_records;
+    mutable QList<SoundCloudTrack*> m_items;
+    
+    // The rows of each track id, so that an update only visits the rows of its track. The index is extended as
+    // rows are appended, and rebuilt when it is next used after a row has been inserted or removed.
+    mutable QMultiHash<QString, int> m_rows;
+    mutable bool m_rowsIndexed;
+    
+    QPointer<TrackRecordTask> m_task;
     
-    QHash<int, QByteArray> m_roles;
+    friend class tst_Bench_ModelData;
+    friend class tst_Bench_SoundCloudRegistry;
 };
     
 #endif // SOUNDCLOUDTRACKMODEL_H
@@ -9,3 +9,8 @@ contains(MEEGO_EDITION,harmattan) {
     app.depends += \
         ../qsoundcloud/src
 }
+
+contains(CONFIG,tests) {
+    SUBDIRS += \
+        tests
+}
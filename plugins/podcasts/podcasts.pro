@@ -1,13 +1,17 @@
 TEMPLATE = app
 TARGET = musikloud2-podcasts
-QT += network xml
+QT += network sql xml
 QT -= gui
 
 HEADERS += \
+    src/episodeindex.h \
+    src/feedcache.h \
     src/json.h \
     src/rss.h
     
 SOURCES += \
+    src/episodeindex.cpp \
+    src/feedcache.cpp \
     src/json.cpp \
     src/main.cpp \
     src/rss.cpp
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "episodeindex.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QHash>
+#include <QRegExp>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#ifdef MUSIKLOUD_DEBUG
+#include <QDebug>
+#endif
+
+static const QString CONNECTION_NAME("episodes");
+
+static const int TITLE_WEIGHT = 5;
+static const int DESCRIPTION_WEIGHT = 1;
+
+struct EpisodeMatch {
+    qint64 id;
+    qint64 timestamp;
+    int score;
+};
+
+bool matchGreaterThan(const EpisodeMatch &one, const EpisodeMatch &two) {
+    if (one.score != two.score) {
+        return one.score > two.score;
+    }
+
+    if (one.timestamp != two.timestamp) {
+        return one.timestamp > two.timestamp;
+    }
+
+    return one.id > two.id;
+}
+
+EpisodeIndex::EpisodeIndex(const QString &path) :
+    m_db(QSqlDatabase::addDatabase("QSQLITE", CONNECTION_NAME))
+{
+    QDir().mkpath(path);
+    m_db.setDatabaseName(path + "episodes.db");
+
+    if (!m_db.open()) {
+#ifdef MUSIKLOUD_DEBUG
+        qDebug() << "EpisodeIndex: Cannot open database:" << m_db.lastError().text();
+#endif
+        return;
+    }
+
+    QSqlQuery query(m_db);
+    query.exec("CREATE TABLE IF NOT EXISTS episodes (id INTEGER PRIMARY KEY, feed TEXT, timestamp INTEGER, \
+    data BLOB)");
+    query.exec("CREATE INDEX IF NOT EXISTS episodesFeed ON episodes (feed)");
+    query.exec("CREATE INDEX IF NOT EXISTS episodesTimestamp ON episodes (timestamp)");
+
+    // Virtual tables do not support IF NOT EXISTS in older versions of SQLite
+    if (!m_db.tables().contains("episodesText")) {
+        query.exec("CREATE VIRTUAL TABLE episodesText USING fts3(title, description)");
+    }
+#ifdef MUSIKLOUD_DEBUG
+    if (query.lastError().isValid()) {
+        qDebug() << "EpisodeIndex: Database error:" << query.lastError().text();
+    }
+#endif
+}
+
+EpisodeIndex::~EpisodeIndex() {
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(CONNECTION_NAME);
+}
+
+bool EpisodeIndex::isOpen() const {
+    return m_db.isOpen();
+}
+
+QStringList EpisodeIndex::feeds() const {
+    QStringList list;
+
+    if (!isOpen()) {
+        return list;
+    }
+
+    QSqlQuery query(m_db);
+    query.exec("SELECT DISTINCT feed FROM episodes");
+
+    while (query.next()) {
+        list << query.value(0).toString();
+    }
+
+    return list;
+}
+
+bool EpisodeIndex::contains(const QString &feed) const {
+    if (!isOpen()) {
+        return false;
+    }
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT 1 FROM episodes WHERE feed = ? LIMIT 1");
+    query.addBindValue(feed);
+    return (query.exec()) && (query.next());
+}
+
+bool EpisodeIndex::update(const QString &feed, const QVariantList &items) {
+    if (!isOpen()) {
+        return false;
+    }
+
+    m_db.transaction();
+    bool ok = removeEpisodes(feed);
+
+    QSqlQuery episodeQuery(m_db);
+    episodeQuery.prepare("INSERT INTO episodes (feed, timestamp, data) VALUES (?, ?, ?)");
+    QSqlQuery textQuery(m_db);
+    textQuery.prepare("INSERT INTO episodesText (docid, title, description) VALUES (?, ?, ?)");
+
+    for (int i = 0; (ok) && (i < items.size()); i++) {
+        const QVariantMap item = items.at(i).toMap();
+        const QDateTime dt = item.value("_dt").toDateTime();
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_4_7);
+        stream << items.at(i);
+
+        episodeQuery.addBindValue(feed);
+        episodeQuery.addBindValue(dt.isValid() ? dt.toMSecsSinceEpoch() : 0);
+        episodeQuery.addBindValue(data);
+        ok = episodeQuery.exec();
+
+        if (ok) {
+            textQuery.addBindValue(episodeQuery.lastInsertId());
+            textQuery.addBindValue(item.value("title"));
+            textQuery.addBindValue(item.value("description"));
+            ok = textQuery.exec();
+        }
+    }
+
+    if (ok) {
+        return m_db.commit();
+    }
+#ifdef MUSIKLOUD_DEBUG
+    qDebug() << "EpisodeIndex::update: Database error:" << m_db.lastError().text();
+#endif
+    m_db.rollback();
+    return false;
+}
+
+bool EpisodeIndex::remove(const QString &feed) {
+    if (!isOpen()) {
+        return false;
+    }
+
+    m_db.transaction();
+
+    if (removeEpisodes(feed)) {
+        return m_db.commit();
+    }
+
+    m_db.rollback();
+    return false;
+}
+
+bool EpisodeIndex::removeEpisodes(const QString &feed) {
+    QSqlQuery query(m_db);
+    query.prepare("DELETE FROM episodesText WHERE docid IN (SELECT id FROM episodes WHERE feed = ?)");
+    query.addBindValue(feed);
+
+    if (!query.exec()) {
+        return false;
+    }
+
+    query.prepare("DELETE FROM episodes WHERE feed = ?");
+    query.addBindValue(feed);
+    return query.exec();
+}
+
+QVariantList EpisodeIndex::search(const QString &query, const QString &order, int offset, int limit,
+                                  bool &more) const {
+    more = false;
+    const QString match = matchExpression(query);
+
+    if ((!isOpen()) || (match.isEmpty())) {
+        return QVariantList();
+    }
+
+    QSqlQuery sql(m_db);
+    QList<qint64> ids;
+
+    if (order == "date") {
+        sql.prepare("SELECT episodes.id FROM episodesText JOIN episodes ON episodes.id = episodesText.docid \
+        WHERE episodesText MATCH ? ORDER BY episodes.timestamp DESC, episodes.id DESC LIMIT ? OFFSET ?");
+        sql.addBindValue(match);
+        sql.addBindValue(limit + 1);
+        sql.addBindValue(offset);
+        sql.exec();
+
+        while (sql.next()) {
+            ids << sql.value(0).toLongLong();
+        }
+
+        if (ids.size() > limit) {
+            more = true;
+            ids.removeLast();
+        }
+
+        return items(ids);
+    }
+
+    // Rank by relevance, weighting matches in the title above those in the description
+    sql.prepare("SELECT episodes.id, episodes.timestamp, offsets(episodesText) FROM episodesText \
+    JOIN episodes ON episodes.id = episodesText.docid WHERE episodesText MATCH ?");
+    sql.addBindValue(match);
+    sql.exec();
+
+    QList<EpisodeMatch> matches;
+
+    while (sql.next()) {
+        EpisodeMatch episode;
+        episode.id = sql.value(0).toLongLong();
+        episode.timestamp = sql.value(1).toLongLong();
+        episode.score = 0;
+
+        // Each match is described by four integers: column, term, byte offset and size
+        const QStringList offsets = sql.value(2).toString().split(' ', QString::SkipEmptyParts);
+
+        for (int i = 0; i < offsets.size(); i += 4) {
+            episode.score += (offsets.at(i) == "0" ? TITLE_WEIGHT : DESCRIPTION_WEIGHT);
+        }
+
+        matches << episode;
+    }
+
+    qSort(matches.begin(), matches.end(), matchGreaterThan);
+
+    for (int i = offset; (i < matches.size()) && (i < offset + limit); i++) {
+        ids << matches.at(i).id;
+    }
+
+    more = (matches.size() > offset + limit);
+    return items(ids);
+}
+
+QString EpisodeIndex::matchExpression(const QString &query) {
+    QStringList terms = query.split(QRegExp("\\W+"), QString::SkipEmptyParts);
+
+    for (int i = 0; i < terms.size(); i++) {
+        terms[i].append('*');
+    }
+
+    return terms.join(" ");
+}
+
+QVariantList EpisodeIndex::items(const QList<qint64> &ids) const {
+    if (ids.isEmpty()) {
+        return QVariantList();
+    }
+
+    QStringList values;
+
+    foreach (qint64 id, ids) {
+        values << QString::number(id);
+    }
+
+    QSqlQuery query(m_db);
+    query.exec(QString("SELECT id, data FROM episodes WHERE id IN (%1)").arg(values.join(",")));
+    QHash<qint64, QVariant> episodes;
+
+    while (query.next()) {
+        QByteArray data = query.value(1).toByteArray();
+        QDataStream stream(&data, QIODevice::ReadOnly);
+        stream.setVersion(QDataStream::Qt_4_7);
+        QVariant item;
+        stream >> item;
+        episodes[query.value(0).toLongLong()] = item;
+    }
+
+    QVariantList results;
+
+    foreach (qint64 id, ids) {
+        if (episodes.contains(id)) {
+            results << episodes.value(id);
+        }
+    }
+
+    return results;
+}
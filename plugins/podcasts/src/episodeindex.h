@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EPISODEINDEX_H
+#define EPISODEINDEX_H
+
+#include <QSqlDatabase>
+#include <QStringList>
+#include <QVariantList>
+
+class EpisodeIndex
+{
+
+public:
+    explicit EpisodeIndex(const QString &path);
+    ~EpisodeIndex();
+
+    bool isOpen() const;
+
+    QStringList feeds() const;
+    bool contains(const QString &feed) const;
+    bool update(const QString &feed, const QVariantList &items);
+    bool remove(const QString &feed);
+
+    QVariantList search(const QString &query, const QString &order, int offset, int limit, bool &more) const;
+
+private:
+    static QString matchExpression(const QString &query);
+
+    bool removeEpisodes(const QString &feed);
+
+    QVariantList items(const QList<qint64> &ids) const;
+
+    QSqlDatabase m_db;
+};
+
+#endif // EPISODEINDEX_H
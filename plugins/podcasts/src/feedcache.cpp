@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "feedcache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+
+static const quint32 CACHE_MAGIC = 0x4d4b5043; // "MKPC"
+static const quint32 CACHE_VERSION = 1;
+
+FeedCache::FeedCache() :
+    m_path(QFileInfo(QSettings("MusiKloud2", "MusiKloud2").fileName()).path() + "/podcasts/")
+{
+}
+
+QString FeedCache::path() const {
+    return m_path;
+}
+
+QString FeedCache::fileName(const QString &url) const {
+    return m_path + QCryptographicHash::hash(url.toUtf8(), QCryptographicHash::Md5).toHex() + ".feed";
+}
+
+bool FeedCache::load(const QString &url, CachedFeed &feed) const {
+    QFile file(fileName(url));
+
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_7);
+    quint32 magic;
+    quint32 version;
+    QString cachedUrl;
+    stream >> magic >> version;
+
+    if ((magic != CACHE_MAGIC) || (version != CACHE_VERSION)) {
+        return false;
+    }
+
+    stream >> cachedUrl >> feed.etag >> feed.lastModified >> feed.items;
+
+    if ((stream.status() != QDataStream::Ok) || (cachedUrl != url)) {
+        feed = CachedFeed();
+        return false;
+    }
+
+    return true;
+}
+
+bool FeedCache::save(const QString &url, const CachedFeed &feed) const {
+    if (!QDir().mkpath(m_path)) {
+        return false;
+    }
+
+    // Write to a temporary file first, so that an interrupted write never leaves a truncated cache entry
+    const QString name = fileName(url);
+    QFile file(name + ".tmp");
+
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_7);
+    stream << CACHE_MAGIC << CACHE_VERSION << url << feed.etag << feed.lastModified << feed.items;
+    file.close();
+
+    if (stream.status() != QDataStream::Ok) {
+        file.remove();
+        return false;
+    }
+
+    QFile::remove(name);
+    return file.rename(name);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FEEDCACHE_H
+#define FEEDCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVariantList>
+
+struct CachedFeed {
+    QByteArray etag;
+    QByteArray lastModified;
+    QVariantList items;
+};
+
+class FeedCache
+{
+
+public:
+    FeedCache();
+
+    QString path() const;
+
+    bool load(const QString &url, CachedFeed &feed) const;
+    bool save(const QString &url, const CachedFeed &feed) const;
+
+private:
+    QString fileName(const QString &url) const;
+
+    QString m_path;
+};
+
+#endif // FEEDCACHE_H
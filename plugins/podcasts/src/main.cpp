@@ -57,7 +57,18 @@ int main(int argc, char *argv[]) {
             }
         }
         
-        if (id.isEmpty()) {
+        int page = 0;
+        QString url = id;
+        QString query;
+        QString order;
+        
+        if (Rss::parseSearchToken(id, page, query, order)) {
+            return rss.searchTracks(query, order, page) ? 0 : 1;
+        }
+        
+        Rss::parsePageToken(id, page, url);
+        
+        if (url.isEmpty()) {
             QStringList urls = QSettings("MusiKloud2", "MusiKloud2").value("Podcasts/feeds").toString().remove(' ').split(',');
             
             if (urls.isEmpty()) {
@@ -65,12 +76,30 @@ int main(int argc, char *argv[]) {
                 return 1;
             }
             else {
-                rss.listTracks(urls);
+                rss.listTracks(urls, page);
             }
         }
         else {
-            rss.listTracks(id);
+            rss.listTracks(url, page);
+        }
+    }
+    else if (method == "search") {
+        QString query;
+        QString order;
+
+        if ((i = args.indexOf("-q") + 1) > 0) {
+            if (i < args.size()) {
+                query = args.at(i);
+            }
         }
+        
+        if ((i = args.indexOf("-o") + 1) > 0) {
+            if (i < args.size()) {
+                order = args.at(i);
+            }
+        }
+        
+        return rss.searchTracks(query, order) ? 0 : 1;
     }
     else {
         std::cout << qPrintable(QString("{\"error\": \"%1\"}").arg(QObject::tr("Method '%1' is not supported")
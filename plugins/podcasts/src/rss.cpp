@@ -23,24 +23,48 @@
 #include <QDomElement>
 #include <QDomNodeList>
 #include <QDateTime>
+#include <QVector>
+#include <algorithm>
 #include <iostream>
 
 static const int MAX_REDIRECTS = 8;
+static const int MAX_RESULTS = 20;
 
-bool dateGreaterThan(QVariant &one, QVariant &two) {
-    return one.toMap().value("_dt").toDateTime() > two.toMap().value("_dt").toDateTime();
+struct MergeCursor {
+    int feed;
+    int index;
+    qint64 timestamp;
+};
+
+bool itemGreaterThan(const RssItem &one, const RssItem &two) {
+    return one.timestamp > two.timestamp;
+}
+
+// Heap ordering for the k-way merge: newest item first, ties broken by feed order so that pages are stable
+bool cursorLessThan(const MergeCursor &one, const MergeCursor &two) {
+    if (one.timestamp == two.timestamp) {
+        return one.feed > two.feed;
+    }
+    
+    return one.timestamp < two.timestamp;
 }
 
 Rss::Rss(QObject *parent) :
     QObject(parent),
     m_nam(new QNetworkAccessManager(this)),
+    m_index(m_cache.path()),
+    m_feedCached(false),
+    m_page(0),
     m_redirects(0)
 {
     connect(m_nam, SIGNAL(finished(QNetworkReply*)), this, SLOT(parseTracks(QNetworkReply*)));
 }
 
-void Rss::listTracks(const QStringList &urls) {
+void Rss::listTracks(const QStringList &urls, int page) {
+    m_id = QString();
     m_urls = urls;
+    m_page = qMax(0, page);
+    m_feeds.clear();
     
     if (m_urls.isEmpty()) {
         std::cout << qPrintable(QString("{\"error\": \"%1\"}").arg(tr("No feed URLs specified")));
@@ -48,17 +72,117 @@ void Rss::listTracks(const QStringList &urls) {
         return;
     }
     
-    listTracks(m_urls.takeFirst());
+    // Drop episodes of feeds that are no longer subscribed to from the search index
+    foreach (const QString &feed, m_index.feeds()) {
+        if (!m_urls.contains(feed)) {
+            m_index.remove(feed);
+        }
+    }
+    
+    fetchFeed(m_urls.takeFirst());
+}
+
+void Rss::listTracks(const QString &url, int page) {
+    m_id = url;
+    m_urls.clear();
+    m_page = qMax(0, page);
+    m_feeds.clear();
+    fetchFeed(url);
+}
+
+bool Rss::searchTracks(const QString &query, const QString &order, int page) {
+    if (!m_index.isOpen()) {
+        std::cout << qPrintable(QString("{\"error\": \"%1\"}").arg(tr("Unable to open episode index")));
+        return false;
+    }
+    
+    page = qMax(0, page);
+    bool more;
+    QVariantMap result;
+    result["items"] = m_index.search(query, order, page * MAX_RESULTS, MAX_RESULTS, more);
+    
+    if (more) {
+        result["next"] = searchToken(page + 1, query, order);
+    }
+    
+    std::cout << QtJson::Json::serialize(result).constData();
+    return true;
+}
+
+QString Rss::pageToken(int page, const QString &url) {
+    return url.isEmpty() ? QString("page:%1").arg(page) : QString("page:%1:%2").arg(page).arg(url);
+}
+
+bool Rss::parsePageToken(const QString &token, int &page, QString &url) {
+    if (!token.startsWith("page:")) {
+        return false;
+    }
+    
+    bool ok;
+    const int p = token.section(':', 1, 1).toInt(&ok);
+    
+    if (!ok) {
+        return false;
+    }
+    
+    page = p;
+    url = token.section(':', 2);
+    return true;
+}
+
+QString Rss::searchToken(int page, const QString &query, const QString &order) {
+    return QString("search:%1:%2:%3").arg(page).arg(order).arg(query);
+}
+
+bool Rss::parseSearchToken(const QString &token, int &page, QString &query, QString &order) {
+    if (!token.startsWith("search:")) {
+        return false;
+    }
+    
+    bool ok;
+    const int p = token.section(':', 1, 1).toInt(&ok);
+    
+    if (!ok) {
+        return false;
+    }
+    
+    page = p;
+    order = token.section(':', 2, 2);
+    query = token.section(':', 3);
+    return true;
 }
 
-void Rss::listTracks(const QString &url) {    
+void Rss::fetchFeed(const QString &url) {    
     m_redirects = 0;
-    m_nam->get(QNetworkRequest(url));
+    m_url = url;
+    m_feed = CachedFeed();
+    m_feedCached = m_cache.load(url, m_feed);
+    
+    QNetworkRequest request(url);
+    setConditionalHeaders(request);
+    m_nam->get(request);
 }
 
 void Rss::followRedirect(const QUrl &url) {
     m_redirects++;
-    m_nam->get(QNetworkRequest(url));
+    
+    QNetworkRequest request(url);
+    setConditionalHeaders(request);
+    m_nam->get(request);
+}
+
+void Rss::setConditionalHeaders(QNetworkRequest &request) const {
+    if (!m_feedCached) {
+        return;
+    }
+    
+    if (!m_feed.etag.isEmpty()) {
+        request.setRawHeader("If-None-Match", m_feed.etag);
+    }
+    
+    if (!m_feed.lastModified.isEmpty()) {
+        request.setRawHeader("If-Modified-Since", m_feed.lastModified);
+    }
 }
 
 void Rss::parseTracks(QNetworkReply *reply) {
@@ -92,6 +216,19 @@ void Rss::parseTracks(QNetworkReply *reply) {
         return;
     }
     
+    if ((m_feedCached) && (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304)) {
+        // Feed is unchanged, so re-use the items parsed when it was last fetched
+        reply->deleteLater();
+        addFeed(m_feed.items);
+        
+        if (!m_index.contains(m_url)) {
+            m_index.update(m_url, m_feed.items);
+        }
+        
+        fetchNextFeed();
+        return;
+    }
+    
     QDomDocument doc;    
     
     if (!doc.setContent(reply->readAll(), true)) {
@@ -107,6 +244,10 @@ void Rss::parseTracks(QNetworkReply *reply) {
     QString thumbnailUrl = channelElem.firstChildElement("image").attribute("href");
     QString genre = channelElem.firstChildElement("category").attribute("text");
     
+    CachedFeed feed;
+    feed.etag = reply->rawHeader("ETag");
+    feed.lastModified = reply->rawHeader("Last-Modified");
+    
     for (int i = 0; i < items.size(); i++) {
         QDomElement item = items.at(i).toElement();
         QDateTime dt = QDateTime::fromString(item.firstChildElement("pubDate").text().section(' ', 0, -2),
@@ -127,24 +268,106 @@ void Rss::parseTracks(QNetworkReply *reply) {
         result["thumbnailUrl"] = thumbnailUrl;
         result["title"] = item.firstChildElement("title").text();
         result["url"] = item.firstChildElement("link").text();
-        m_results << result;
+        feed.items << result;
     }
     
-    reply->deleteLater();
+    addFeed(feed.items);
+    m_index.update(m_url, feed.items);
+    
+    if ((!feed.etag.isEmpty()) || (!feed.lastModified.isEmpty())) {
+        m_cache.save(m_url, feed);
+    }
     
+    reply->deleteLater();
+    fetchNextFeed();
+}
+
+void Rss::fetchNextFeed() {
     if (m_urls.isEmpty()) {
         printResult();
     }
     else {
-        listTracks(m_urls.takeFirst());
+        fetchFeed(m_urls.takeFirst());
     }
 }
 
+void Rss::addFeed(const QVariantList &items) {
+    if (items.isEmpty()) {
+        return;
+    }
+    
+    RssFeed feed;
+    feed.reserve(items.size());
+    bool sorted = true;
+    
+    foreach (const QVariant &item, items) {
+        const QDateTime dt = item.toMap().value("_dt").toDateTime();
+        RssItem rssItem;
+        rssItem.timestamp = dt.isValid() ? dt.toMSecsSinceEpoch() : 0;
+        rssItem.data = item;
+        
+        if ((sorted) && (!feed.isEmpty()) && (rssItem.timestamp > feed.last().timestamp)) {
+            sorted = false;
+        }
+        
+        feed << rssItem;
+    }
+    
+    if (!sorted) {
+        qStableSort(feed.begin(), feed.end(), itemGreaterThan);
+    }
+    
+    m_feeds << feed;
+}
+
 void Rss::printResult() {
-    if (!m_results.isEmpty()) {
-        qSort(m_results.begin(), m_results.end(), dateGreaterThan);
+    // Each feed is already in date order, so merge them only as far as the end of the requested page
+    QVector<MergeCursor> heap;
+    heap.reserve(m_feeds.size());
+    
+    for (int i = 0; i < m_feeds.size(); i++) {
+        MergeCursor cursor;
+        cursor.feed = i;
+        cursor.index = 0;
+        cursor.timestamp = m_feeds.at(i).first().timestamp;
+        heap << cursor;
+    }
+    
+    std::make_heap(heap.begin(), heap.end(), cursorLessThan);
+    
+    const int start = m_page * MAX_RESULTS;
+    const int end = start + MAX_RESULTS;
+    int position = 0;
+    QVariantList items;
+    
+    while ((!heap.isEmpty()) && (position < end)) {
+        std::pop_heap(heap.begin(), heap.end(), cursorLessThan);
+        MergeCursor &cursor = heap.last();
+        const RssFeed &feed = m_feeds.at(cursor.feed);
+        
+        if (position >= start) {
+            items << feed.at(cursor.index).data;
+        }
+        
+        position++;
+        cursor.index++;
+        
+        if (cursor.index < feed.size()) {
+            cursor.timestamp = feed.at(cursor.index).timestamp;
+            std::push_heap(heap.begin(), heap.end(), cursorLessThan);
+        }
+        else {
+            heap.pop_back();
+        }
+    }
+    
+    QVariantMap result;
+    result["items"] = items;
+    
+    if (!heap.isEmpty()) {
+        result["next"] = pageToken(m_page + 1, m_id);
     }
     
-    std::cout << QByteArray("{\"items\": " + QtJson::Json::serialize(m_results) + "}").constData();
+    std::cout << QtJson::Json::serialize(result).constData();
     QCoreApplication::quit();
 }
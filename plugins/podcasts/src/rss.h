@@ -17,14 +17,24 @@
 #ifndef RSS_H
 #define RSS_H
 
+#include "episodeindex.h"
+#include "feedcache.h"
 #include <QObject>
 #include <QStringList>
 #include <QVariantList>
 
 class QNetworkAccessManager;
 class QNetworkReply;
+class QNetworkRequest;
 class QUrl;
 
+struct RssItem {
+    qint64 timestamp;
+    QVariant data;
+};
+
+typedef QList<RssItem> RssFeed;
+
 class Rss : public QObject
 {
     Q_OBJECT
@@ -32,12 +42,26 @@ class Rss : public QObject
 public:
     explicit Rss(QObject *parent = 0);
     
-    void listTracks(const QStringList &urls);    
-    void listTracks(const QString &url);
+    void listTracks(const QStringList &urls, int page = 0);    
+    void listTracks(const QString &url, int page = 0);
+    
+    bool searchTracks(const QString &query, const QString &order, int page = 0);
+    
+    static QString pageToken(int page, const QString &url = QString());
+    static bool parsePageToken(const QString &token, int &page, QString &url);
+    
+    static QString searchToken(int page, const QString &query, const QString &order);
+    static bool parseSearchToken(const QString &token, int &page, QString &query, QString &order);
     
 private:
+    void fetchFeed(const QString &url);
+    void fetchNextFeed();
     void followRedirect(const QUrl &url);
     
+    void addFeed(const QVariantList &items);
+    
+    void setConditionalHeaders(QNetworkRequest &request) const;
+    
 private Q_SLOTS:
     void parseTracks(QNetworkReply *reply);
     void printResult();
@@ -45,8 +69,16 @@ private Q_SLOTS:
 private:
     QNetworkAccessManager *m_nam;
     
+    FeedCache m_cache;
+    EpisodeIndex m_index;
+    CachedFeed m_feed;
+    bool m_feedCached;
+    
+    QString m_id;
+    QString m_url;
     QStringList m_urls;
-    QVariantList m_results;
+    QList<RssFeed> m_feeds;
+    int m_page;
     int m_redirects;
 };
     
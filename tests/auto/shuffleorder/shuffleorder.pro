@@ -0,0 +1,15 @@
+include(../../tests.pri)
+
+TARGET = tst_shuffleorder
+
+QT -= gui
+
+INCLUDEPATH += \
+    $$APP_SRC/audioplayer
+
+HEADERS += \
+    $$APP_SRC/audioplayer/shuffleorder.h
+
+SOURCES += \
+    $$APP_SRC/audioplayer/shuffleorder.cpp \
+    tst_shuffleorder.cpp
@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shuffleorder.h"
+#include <QtTest>
+#include <stdlib.h>
+
+#if QT_VERSION < 0x050000
+Q_DECLARE_METATYPE(QVector<int>)
+#endif
+
+static const int BENCHMARK_COUNT = 100000;
+
+/*
+ * A plain list model of the queue and its shuffle order, holding an id for each entry.
+ *
+ * The order of newly appended entries is random, so it is taken from the shuffle order under test. Removing an
+ * entry erases it from both lists, so later entries are renumbered the way the queue renumbers them.
+ */
+class NaiveOrder
+{
+
+public:
+    NaiveOrder() :
+        m_nextId(0)
+    {
+    }
+    
+    int count() const {
+        return m_queue.size();
+    }
+    
+    void append(int n, const QVector<int> &order) {
+        for (int i = 0; i < n; i++) {
+            m_queue.append(m_nextId++);
+        }
+        
+        for (int position = m_shuffled.size(); position < order.size(); position++) {
+            m_shuffled.append(m_queue.at(order.at(position)));
+        }
+    }
+    
+    void remove(int index) {
+        m_shuffled.removeOne(m_queue.takeAt(index));
+    }
+    
+    int idAtIndex(int index) const {
+        return m_queue.at(index);
+    }
+    
+    int idAtPosition(int position) const {
+        return m_shuffled.at(position);
+    }
+    
+private:
+    QList<int> m_queue;
+    QList<int> m_shuffled;
+    
+    int m_nextId;
+};
+
+static bool isPermutation(const QVector<int> &order) {
+    QVector<bool> seen(order.size(), false);
+    
+    foreach (int index, order) {
+        if ((index < 0) || (index >= order.size()) || (seen.at(index))) {
+            return false;
+        }
+        
+        seen[index] = true;
+    }
+    
+    return true;
+}
+
+// Checks that both orders hold the same entries in the same queue and shuffle positions
+static bool matches(const ShuffleOrder &shuffle, const NaiveOrder &naive) {
+    const QVector<int> order = shuffle.order();
+    
+    if ((shuffle.count() != naive.count()) || (order.size() != naive.count()) || (!isPermutation(order))) {
+        return false;
+    }
+    
+    for (int position = 0; position < order.size(); position++) {
+        const int index = order.at(position);
+        
+        if ((shuffle.position(index) != position) || (naive.idAtIndex(index) != naive.idAtPosition(position))) {
+            return false;
+        }
+    }
+    
+    return (shuffle.indexAt(-1) == -1) && (shuffle.indexAt(order.size()) == -1) && (shuffle.position(-1) == -1)
+           && (shuffle.position(order.size()) == -1);
+}
+
+class tst_ShuffleOrder : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    
+    void append();
+    void remove_data();
+    void remove();
+    void removeOutOfRange();
+    void compact();
+    void setOrder();
+    void setInvalidOrder_data();
+    void setInvalidOrder();
+    void clear();
+    
+    void benchmarkAppend();
+    void benchmarkLookup();
+    void benchmarkRemove();
+};
+
+void tst_ShuffleOrder::initTestCase() {
+    // ShuffleOrder uses std::random_shuffle(), which draws from rand(), so seeding it fixes the shuffled orders
+    srand(1);
+}
+
+void tst_ShuffleOrder::append() {
+    ShuffleOrder shuffle;
+    NaiveOrder naive;
+    QVERIFY(shuffle.isEmpty());
+    QVERIFY(shuffle.order().isEmpty());
+    
+    shuffle.append(10);
+    QCOMPARE(shuffle.count(), 10);
+    naive.append(10, shuffle.order());
+    QVERIFY(matches(shuffle, naive));
+    
+    // Appended entries are played after the existing ones, whose positions are unchanged
+    const QVector<int> previous = shuffle.order();
+    shuffle.append(5);
+    const QVector<int> order = shuffle.order();
+    QCOMPARE(order.mid(0, previous.size()), previous);
+    
+    for (int position = previous.size(); position < order.size(); position++) {
+        QVERIFY(order.at(position) >= previous.size());
+    }
+    
+    naive.append(5, order);
+    QVERIFY(matches(shuffle, naive));
+    
+    shuffle.append(0);
+    shuffle.append(-1);
+    QCOMPARE(shuffle.order(), order);
+}
+
+void tst_ShuffleOrder::remove_data() {
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("removals");
+    QTest::addColumn<bool>("appends");
+    
+    QTest::newRow("single entry") << 1 << 1 << false;
+    QTest::newRow("half") << 100 << 50 << false;
+    QTest::newRow("all") << 100 << 100 << false;
+    QTest::newRow("interleaved appends") << 100 << 150 << true;
+}
+
+void tst_ShuffleOrder::remove() {
+    QFETCH(int, count);
+    QFETCH(int, removals);
+    QFETCH(bool, appends);
+    
+    ShuffleOrder shuffle;
+    NaiveOrder naive;
+    shuffle.append(count);
+    naive.append(count, shuffle.order());
+    
+    for (int i = 0; i < removals; i++) {
+        if ((appends) && (i % 3 == 0)) {
+            const int n = qrand() % 5;
+            shuffle.append(n);
+            naive.append(n, shuffle.order());
+        }
+        
+        if (shuffle.isEmpty()) {
+            break;
+        }
+        
+        const int index = qrand() % shuffle.count();
+        shuffle.remove(index);
+        naive.remove(index);
+        QVERIFY(matches(shuffle, naive));
+    }
+}
+
+void tst_ShuffleOrder::removeOutOfRange() {
+    ShuffleOrder shuffle;
+    shuffle.remove(0);
+    QVERIFY(shuffle.isEmpty());
+    
+    shuffle.append(5);
+    const QVector<int> order = shuffle.order();
+    shuffle.remove(-1);
+    shuffle.remove(5);
+    QCOMPARE(shuffle.count(), 5);
+    QCOMPARE(shuffle.order(), order);
+}
+
+void tst_ShuffleOrder::compact() {
+    // Removed entries are discarded once there are at least 1024 of them and they outnumber the remaining ones,
+    // which happens here at the 1501st removal
+    const int count = 3000;
+    
+    ShuffleOrder shuffle;
+    NaiveOrder naive;
+    shuffle.append(count);
+    naive.append(count, shuffle.order());
+    
+    for (int i = 1; i <= count - 100; i++) {
+        const int index = qrand() % shuffle.count();
+        shuffle.remove(index);
+        naive.remove(index);
+        
+        if ((i % 25 == 0) || (qAbs(i - 1501) <= 2)) {
+            QVERIFY(matches(shuffle, naive));
+        }
+    }
+    
+    QVERIFY(matches(shuffle, naive));
+    
+    // Entries appended after compaction follow the remaining ones
+    shuffle.append(50);
+    naive.append(50, shuffle.order());
+    QVERIFY(matches(shuffle, naive));
+    
+    while (!shuffle.isEmpty()) {
+        shuffle.remove(0);
+        naive.remove(0);
+    }
+    
+    QVERIFY(matches(shuffle, naive));
+    QVERIFY(shuffle.order().isEmpty());
+}
+
+void tst_ShuffleOrder::setOrder() {
+    ShuffleOrder shuffle;
+    shuffle.append(10);
+    
+    const QVector<int> order = QVector<int>() << 2 << 0 << 3 << 1;
+    QVERIFY(shuffle.setOrder(order));
+    QCOMPARE(shuffle.count(), 4);
+    QCOMPARE(shuffle.order(), order);
+    QCOMPARE(shuffle.indexAt(0), 2);
+    QCOMPARE(shuffle.position(2), 0);
+    QCOMPARE(shuffle.position(1), 3);
+    
+    // The remaining entries keep their positions and later queue indexes are renumbered
+    shuffle.remove(0);
+    QCOMPARE(shuffle.order(), QVector<int>() << 1 << 2 << 0);
+    
+    shuffle.append(2);
+    const QVector<int> appended = shuffle.order();
+    QCOMPARE(appended.mid(0, 3), QVector<int>() << 1 << 2 << 0);
+    QVERIFY(isPermutation(appended));
+    
+    QVERIFY(shuffle.setOrder(QVector<int>()));
+    QVERIFY(shuffle.isEmpty());
+}
+
+void tst_ShuffleOrder::setInvalidOrder_data() {
+    QTest::addColumn< QVector<int> >("order");
+    
+    QTest::newRow("duplicate index") << (QVector<int>() << 0 << 1 << 1);
+    QTest::newRow("index out of range") << (QVector<int>() << 0 << 3 << 1);
+    QTest::newRow("negative index") << (QVector<int>() << 0 << -1 << 1);
+}
+
+void tst_ShuffleOrder::setInvalidOrder() {
+    QFETCH(QVector<int>, order);
+    
+    ShuffleOrder shuffle;
+    shuffle.append(5);
+    QVERIFY(!shuffle.setOrder(order));
+    QVERIFY(shuffle.isEmpty());
+    QVERIFY(shuffle.order().isEmpty());
+    QCOMPARE(shuffle.indexAt(0), -1);
+    
+    shuffle.append(3);
+    QVERIFY(isPermutation(shuffle.order()));
+}
+
+void tst_ShuffleOrder::clear() {
+    ShuffleOrder shuffle;
+    shuffle.append(10);
+    shuffle.remove(3);
+    shuffle.clear();
+    QVERIFY(shuffle.isEmpty());
+    QVERIFY(shuffle.order().isEmpty());
+    
+    shuffle.append(4);
+    QCOMPARE(shuffle.count(), 4);
+    QVERIFY(isPermutation(shuffle.order()));
+}
+
+void tst_ShuffleOrder::benchmarkAppend() {
+    QBENCHMARK {
+        ShuffleOrder shuffle;
+        shuffle.append(BENCHMARK_COUNT);
+    }
+}
+
+void tst_ShuffleOrder::benchmarkLookup() {
+    ShuffleOrder shuffle;
+    shuffle.append(BENCHMARK_COUNT);
+    qint64 sum = 0;
+    
+    QBENCHMARK {
+        for (int i = 0; i < BENCHMARK_COUNT; i++) {
+            sum += shuffle.position(i) + shuffle.indexAt(i);
+        }
+    }
+    
+    QVERIFY(sum > 0);
+}
+
+void tst_ShuffleOrder::benchmarkRemove() {
+    // Includes appending the entries, and the compactions triggered by removing them
+    QBENCHMARK {
+        ShuffleOrder shuffle;
+        shuffle.append(BENCHMARK_COUNT);
+        
+        while (!shuffle.isEmpty()) {
+            shuffle.remove(qrand() % shuffle.count());
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_ShuffleOrder)
+#include "tst_shuffleorder.moc"
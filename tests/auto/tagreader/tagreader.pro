@@ -0,0 +1,17 @@
+include(../../tests.pri)
+
+TARGET = tst_tagreader
+
+QT -= gui
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
+
+INCLUDEPATH += \
+    $$APP_SRC/base
+
+HEADERS += \
+    $$APP_SRC/base/tagreader.h
+
+SOURCES += \
+    $$APP_SRC/base/tagreader.cpp \
+    tst_tagreader.cpp
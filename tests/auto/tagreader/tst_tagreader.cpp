@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tagreader.h"
+#include <QtTest>
+
+/*
+ * The fixtures in data/ are minimal files holding only the tags and stream headers that TagReader reads:
+ *
+ * id3v1.mp3: ten 128kbps MPEG frames followed by an ID3v1 tag.
+ * id3v23.mp3: an ID3v2.3 tag with a UTF-16 title and a "(n)" genre, and a Xing header giving 1000 frames.
+ * id3v24.mp3: an ID3v2.4 tag with UTF-8 values, synchsafe frame sizes, a TLEN frame and a front cover.
+ * flac.flac: a STREAMINFO block of 441000 samples at 44.1kHz and a VORBIS_COMMENT block.
+ * vorbis.ogg: Vorbis identification and comment headers, and a last page at granule position 220500.
+ * opus.opus: Opus identification and comment headers with a pre-skip of 312, and a last page at 144312.
+ * mp4.m4a: a movie header of 7500 units at 1000 per second, and iTunes metadata items with a cover.
+ */
+static QString fixture(const QString &fileName) {
+    return QString(SRCDIR) + "data/" + fileName;
+}
+
+// The image data of the embedded covers
+static QByteArray coverData() {
+    QByteArray data("\x89PNG\r\n\x1a\n", 8);
+    
+    for (int i = 0; i < 192; i++) {
+        data.append(char(i));
+    }
+    
+    return data;
+}
+
+class tst_TagReader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void read_data();
+    void read();
+    void picture_data();
+    void picture();
+    void fileInfo();
+    void missingFile();
+    
+    void benchmarkRead_data();
+    void benchmarkRead();
+};
+
+void tst_TagReader::read_data() {
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QString>("title");
+    QTest::addColumn<QString>("artist");
+    QTest::addColumn<QString>("genre");
+    QTest::addColumn<qint64>("duration");
+    
+    QTest::newRow("ID3v1") << "id3v1.mp3" << "ID3v1 Title" << "ID3v1 Artist" << "Rock" << qint64(260);
+    QTest::newRow("ID3v2.3") << "id3v23.mp3" << "ID3v2.3 Title" << "ID3v2.3 Artist" << "Rock" << qint64(26122);
+    QTest::newRow("ID3v2.4") << "id3v24.mp3" << QString::fromUtf8("ID3v2.4 T\xc3\xaftle") << "ID3v2.4 Artist"
+                             << "Rock" << qint64(183000);
+    QTest::newRow("FLAC") << "flac.flac" << "FLAC Title" << "FLAC Artist" << "Rock" << qint64(10000);
+    QTest::newRow("Ogg Vorbis") << "vorbis.ogg" << "Vorbis Title" << "Vorbis Artist" << QString() << qint64(5000);
+    QTest::newRow("Ogg Opus") << "opus.opus" << "Opus Title" << "Opus Artist" << QString() << qint64(3000);
+    QTest::newRow("MP4") << "mp4.m4a" << "MP4 Title" << "MP4 Artist" << "Rock" << qint64(7500);
+}
+
+void tst_TagReader::read() {
+    QFETCH(QString, fileName);
+    QFETCH(QString, title);
+    QFETCH(QString, artist);
+    QFETCH(QString, genre);
+    QFETCH(qint64, duration);
+    
+    const QVariantMap tags = TagReader::read(fixture(fileName));
+    QCOMPARE(tags.value("title").toString(), title);
+    QCOMPARE(tags.value("artist").toString(), artist);
+    QCOMPARE(tags.value("genre").toString(), genre);
+    QCOMPARE(tags.value("duration").toLongLong(), duration);
+    QVERIFY(!tags.contains("picture"));
+}
+
+void tst_TagReader::picture_data() {
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QByteArray>("picture");
+    
+    QTest::newRow("ID3v2.3") << "id3v23.mp3" << QByteArray();
+    QTest::newRow("ID3v2.4") << "id3v24.mp3" << coverData();
+    QTest::newRow("MP4") << "mp4.m4a" << coverData();
+}
+
+void tst_TagReader::picture() {
+    QFETCH(QString, fileName);
+    QFETCH(QByteArray, picture);
+    
+    const QVariantMap tags = TagReader::read(fixture(fileName), true);
+    QCOMPARE(tags.value("picture").toByteArray(), picture);
+    QVERIFY(!tags.value("title").toString().isEmpty());
+}
+
+void tst_TagReader::fileInfo() {
+    const QFileInfo info(fixture("id3v24.mp3"));
+    const QVariantMap tags = TagReader::read(info.absoluteFilePath());
+    QCOMPARE(tags.value("size").toLongLong(), info.size());
+    QCOMPARE(tags.value("lastModified").toDateTime(), info.lastModified());
+}
+
+void tst_TagReader::missingFile() {
+    QVERIFY(TagReader::read(fixture("missing.mp3")).isEmpty());
+}
+
+void tst_TagReader::benchmarkRead_data() {
+    read_data();
+}
+
+void tst_TagReader::benchmarkRead() {
+    // Each iteration reads one file, so the files read per second are the inverse of the reported time
+    QFETCH(QString, fileName);
+    const QString path = fixture(fileName);
+    
+    QBENCHMARK {
+        TagReader::read(path);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_TagReader)
+#include "tst_tagreader.moc"
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "plugintrackmodel.h"
+#include "soundcloud.h"
+#include "soundcloudtrackmodel.h"
+#include "trackmodel.h"
+#include <QtTest>
+
+static const int ROW_COUNT = 1000;
+
+static QList<TrackRecord> createRecords(const QString &service) {
+    QList<TrackRecord> records;
+    
+    for (int i = 0; i < ROW_COUNT; i++) {
+        const QString id = QString::number(i);
+        TrackRecord record;
+        record.setArtist("Artist " + QString::number(i % 50));
+        record.setArtistId("artist" + QString::number(i % 50));
+        record.setDate("2015-06-01");
+        record.setDescription("Description of track " + id);
+        record.setDuration((i + 1) * 1000);
+        record.setFavouriteCount(i % 10);
+        record.setFormat("mp3");
+        record.setGenre("Rock");
+        record.setId(id);
+        record.setLargeThumbnailUrl(QUrl("http://example.com/tracks/" + id + "/large.jpg"));
+        record.setPlayCount(i);
+        record.setService(service);
+        record.setSharing("public");
+        record.setSize((i + 1) * 1024);
+        record.setStreamUrl(QUrl("http://example.com/tracks/" + id + "/stream"));
+        record.setThumbnailUrl(QUrl("http://example.com/tracks/" + id + "/small.jpg"));
+        record.setTitle("Title " + id);
+        record.setUrl(QUrl("http://example.com/tracks/" + id));
+        record.setWaveformUrl(QUrl("http://example.com/tracks/" + id + "/waveform.png"));
+        records << record;
+    }
+    
+    return records;
+}
+
+static QList<int> roles(const QAbstractItemModel *model) {
+    QList<int> list = model->roleNames().keys();
+    qSort(list);
+    return list;
+}
+
+/*
+ * Reads every role of every row of the track models of the application. Each model is populated twice: once
+ * with rows that are only records, as they are when a page of results is loaded, and once with a track object
+ * created for every row by get(), as it was for each row before the models held records.
+ */
+class tst_Bench_ModelData : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    
+    void sameValues_data();
+    void sameValues();
+    
+    void data_data();
+    void data();
+
+private:
+    SoundCloud *m_soundcloud;
+    
+    // Pairs of models with the same rows, the first holding records and the second holding track objects
+    QList<QAbstractListModel*> m_models;
+};
+
+void tst_Bench_ModelData::initTestCase() {
+    // SoundCloud tracks and models connect to SoundCloud::instance(), so it must exist before they are created
+    m_soundcloud = new SoundCloud;
+    
+    for (int i = 0; i < 2; i++) {
+        TrackModel *model = new TrackModel;
+        model->append(createRecords("soundcloud"));
+        m_models << model;
+    }
+    
+    for (int i = 0; i < 2; i++) {
+        SoundCloudTrackModel *model = new SoundCloudTrackModel;
+        
+        foreach (const TrackRecord &record, createRecords("soundcloud")) {
+            model->append(record);
+        }
+        
+        m_models << model;
+    }
+    
+    for (int i = 0; i < 2; i++) {
+        PluginTrackModel *model = new PluginTrackModel;
+        
+        foreach (const TrackRecord &record, createRecords("example")) {
+            model->append(record);
+        }
+        
+        m_models << model;
+    }
+    
+    for (int row = 0; row < ROW_COUNT; row++) {
+        QVERIFY(qobject_cast<TrackModel*>(m_models.at(1))->get(row));
+        QVERIFY(qobject_cast<SoundCloudTrackModel*>(m_models.at(3))->get(row));
+        QVERIFY(qobject_cast<PluginTrackModel*>(m_models.at(5))->get(row));
+    }
+}
+
+void tst_Bench_ModelData::cleanupTestCase() {
+    qDeleteAll(m_models);
+    m_models.clear();
+    delete m_soundcloud;
+}
+
+void tst_Bench_ModelData::sameValues_data() {
+    QTest::addColumn<int>("model");
+    
+    QTest::newRow("TrackModel") << 0;
+    QTest::newRow("SoundCloudTrackModel") << 2;
+    QTest::newRow("PluginTrackModel") << 4;
+}
+
+void tst_Bench_ModelData::sameValues() {
+    // The values must be the same whether they are read from records or track objects
+    QFETCH(int, model);
+    const QAbstractListModel *records = m_models.at(model);
+    const QAbstractListModel *objects = m_models.at(model + 1);
+    QCOMPARE(records->rowCount(), ROW_COUNT);
+    QCOMPARE(objects->rowCount(), ROW_COUNT);
+    
+    foreach (int role, roles(records)) {
+        for (int row = 0; row < ROW_COUNT; row++) {
+            const QVariant value = records->data(records->index(row), role);
+            QVERIFY(value.isValid());
+            QCOMPARE(objects->data(objects->index(row), role), value);
+        }
+    }
+}
+
+void tst_Bench_ModelData::data_data() {
+    QTest::addColumn<int>("model");
+    
+    QTest::newRow("TrackModel, records") << 0;
+    QTest::newRow("TrackModel, track objects") << 1;
+    QTest::newRow("SoundCloudTrackModel, records") << 2;
+    QTest::newRow("SoundCloudTrackModel, track objects") << 3;
+    QTest::newRow("PluginTrackModel, records") << 4;
+    QTest::newRow("PluginTrackModel, track objects") << 5;
+}
+
+void tst_Bench_ModelData::data() {
+    // Each iteration reads every role of every row, as a view does when all of the rows are painted
+    QFETCH(int, model);
+    const QAbstractListModel *listModel = m_models.at(model);
+    const QList<int> modelRoles = roles(listModel);
+    int valid = 0;
+    
+    QBENCHMARK {
+        for (int row = 0; row < ROW_COUNT; row++) {
+            const QModelIndex index = listModel->index(row);
+            
+            foreach (int role, modelRoles) {
+                if (listModel->data(index, role).isValid()) {
+                    valid++;
+                }
+            }
+        }
+    }
+    
+    QVERIFY(valid > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_Bench_ModelData)
+#include "tst_bench_modeldata.moc"
@@ -0,0 +1,55 @@
+include(../../tests.pri)
+
+TARGET = tst_bench_soundcloudregistry
+
+QT += network sql
+
+INCLUDEPATH += \
+    $$APP_SRC/base \
+    $$APP_SRC/soundcloud
+
+HEADERS += \
+    $$APP_SRC/base/artist.h \
+    $$APP_SRC/base/roletable.h \
+    $$APP_SRC/base/track.h \
+    $$APP_SRC/base/trackrecord.h \
+    $$APP_SRC/base/trackrecordtask.h \
+    $$APP_SRC/base/utils.h \
+    $$APP_SRC/soundcloud/soundcloud.h \
+    $$APP_SRC/soundcloud/soundcloudartist.h \
+    $$APP_SRC/soundcloud/soundcloudsync.h \
+    $$APP_SRC/soundcloud/soundcloudtrack.h \
+    $$APP_SRC/soundcloud/soundcloudtrackmodel.h
+
+SOURCES += \
+    $$APP_SRC/base/artist.cpp \
+    $$APP_SRC/base/roletable.cpp \
+    $$APP_SRC/base/track.cpp \
+    $$APP_SRC/base/trackrecord.cpp \
+    $$APP_SRC/base/trackrecordtask.cpp \
+    $$APP_SRC/base/utils.cpp \
+    $$APP_SRC/soundcloud/soundcloud.cpp \
+    $$APP_SRC/soundcloud/soundcloudartist.cpp \
+    $$APP_SRC/soundcloud/soundcloudsync.cpp \
+    $$APP_SRC/soundcloud/soundcloudtrack.cpp \
+    $$APP_SRC/soundcloud/soundcloudtrackmodel.cpp \
+    stubs.cpp \
+    tst_bench_soundcloudregistry.cpp
+
+maemo5 {
+    LIBS += -L/usr/lib -lqsoundcloud
+    CONFIG += link_prl
+    PKGCONFIG += libqsoundcloud
+    
+    INCLUDEPATH += $$APP_SRC/maemo5
+} else:contains(MEEGO_EDITION,harmattan) {
+    LIBS += -L$$PWD/../../../../qsoundcloud/lib -lqsoundcloud
+    
+    INCLUDEPATH += $$APP_SRC/harmattan
+} else:unix {
+    LIBS += -L/usr/lib -lqsoundcloud
+    CONFIG += link_prl
+    PKGCONFIG += libqsoundcloud
+    
+    INCLUDEPATH += $$APP_SRC/desktop-qml
+}
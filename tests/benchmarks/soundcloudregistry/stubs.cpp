@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "coverart.h"
+#include "resources.h"
+
+// utils.cpp refers to CoverArt::thumbnailUrl(), which none of the benchmarked code calls
+QUrl CoverArt::thumbnailUrl(const QString &) {
+    return QUrl();
+}
+
+// The SoundCloud objects and models set their service, which is the only part of resources.cpp that they use
+const QString Resources::SOUNDCLOUD("soundcloud");
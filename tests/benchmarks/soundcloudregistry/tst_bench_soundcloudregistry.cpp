@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2015 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "soundcloud.h"
+#include "soundcloudtrack.h"
+#include "soundcloudtrackmodel.h"
+#include <QtTest>
+
+static TrackRecord trackRecord(const QString &id, bool favourite) {
+    TrackRecord record;
+    record.setId(id);
+    record.setTitle("Track " + id);
+    record.setFavourite(favourite);
+    return record;
+}
+
+/*
+ * Delivers updates the way tracks did before they were registered by id: every track is connected to the
+ * signal and compares its own id with that of the updated track.
+ */
+class BroadcastReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    BroadcastReceiver(SoundCloud *soundcloud, SoundCloudTrack *track) :
+        QObject(track),
+        m_track(track)
+    {
+        connect(soundcloud, SIGNAL(trackFavourited(SoundCloudTrack*)), this, SLOT(onTrackUpdated(SoundCloudTrack*)));
+    }
+
+private Q_SLOTS:
+    void onTrackUpdated(SoundCloudTrack *track) {
+        if ((track->id() == m_track->id()) && (track != m_track)) {
+            m_track->loadTrack(track);
+        }
+    }
+
+private:
+    SoundCloudTrack *m_track;
+};
+
+/*
+ * Updates its rows the way the track models did before they indexed their rows by id: every row is compared
+ * with the id of the updated track.
+ */
+class ScanningModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScanningModel(SoundCloud *soundcloud, const QList<TrackRecord> &records, QObject *parent) :
+        QObject(parent),
+        m_records(records)
+    {
+        connect(soundcloud, SIGNAL(trackFavourited(SoundCloudTrack*)), this, SLOT(onTrackUpdated(SoundCloudTrack*)));
+    }
+    
+    bool isFavourite(int row) const {
+        return m_records.at(row).isFavourite();
+    }
+
+private Q_SLOTS:
+    void onTrackUpdated(SoundCloudTrack *track) {
+        for (int i = 0; i < m_records.size(); i++) {
+            if (m_records.at(i).id() == track->id()) {
+                m_records[i].setFavourite(track->isFavourite());
+                m_records[i].setFavouriteCount(track->favouriteCount());
+            }
+        }
+    }
+
+private:
+    QList<TrackRecord> m_records;
+};
+
+class tst_Bench_SoundCloudRegistry : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    
+    void deliversToSameId();
+    
+    void favourite_data();
+    void favourite();
+    
+    void modelUpdatesSameId();
+    
+    void favouriteModels_data();
+    void favouriteModels();
+
+private:
+    void emitSignal(const char *name, SoundCloudTrack *track);
+    
+    SoundCloud *m_soundcloud;
+};
+
+void tst_Bench_SoundCloudRegistry::initTestCase() {
+    // Tracks register with SoundCloud::instance(), so it must exist before any track is created
+    m_soundcloud = new SoundCloud;
+    QCOMPARE(SoundCloud::instance(), m_soundcloud);
+}
+
+void tst_Bench_SoundCloudRegistry::cleanupTestCase() {
+    delete m_soundcloud;
+}
+
+void tst_Bench_SoundCloudRegistry::emitSignal(const char *name, SoundCloudTrack *track) {
+    QVERIFY(QMetaObject::invokeMethod(m_soundcloud, name, Qt::DirectConnection, Q_ARG(SoundCloudTrack*, track)));
+}
+
+void tst_Bench_SoundCloudRegistry::deliversToSameId() {
+    QObject parent;
+    SoundCloudTrack *same = new SoundCloudTrack(trackRecord("1", false), &parent);
+    SoundCloudTrack *other = new SoundCloudTrack(trackRecord("2", false), &parent);
+    
+    // Deleted tracks are no longer registered
+    delete new SoundCloudTrack(trackRecord("1", false), &parent);
+    
+    SoundCloudTrack favourited(trackRecord("1", true));
+    emitSignal("trackFavourited", &favourited);
+    QVERIFY(same->isFavourite());
+    QVERIFY(!other->isFavourite());
+    
+    // A track whose id changes is registered with its new id
+    other->loadTrack(&favourited);
+    QCOMPARE(other->id(), QString("1"));
+    
+    SoundCloudTrack unfavourited(trackRecord("1", false));
+    emitSignal("trackUnfavourited", &unfavourited);
+    QVERIFY(!same->isFavourite());
+    QVERIFY(!other->isFavourite());
+    QVERIFY(!favourited.isFavourite());
+}
+
+void tst_Bench_SoundCloudRegistry::favourite_data() {
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("broadcast");
+    
+    QTest::newRow("registry, 100 tracks") << 100 << false;
+    QTest::newRow("registry, 1000 tracks") << 1000 << false;
+    QTest::newRow("registry, 10000 tracks") << 10000 << false;
+    QTest::newRow("broadcast, 100 tracks") << 100 << true;
+    QTest::newRow("broadcast, 1000 tracks") << 1000 << true;
+    QTest::newRow("broadcast, 10000 tracks") << 10000 << true;
+}
+
+void tst_Bench_SoundCloudRegistry::favourite() {
+    // One track shares the id of the favourited track among count others, so the registry does the same work
+    // whatever the count, while the broadcast calls a slot on every track
+    QFETCH(int, count);
+    QFETCH(bool, broadcast);
+    
+    QObject parent;
+    
+    for (int i = 0; i < count; i++) {
+        SoundCloudTrack *track = new SoundCloudTrack(trackRecord(QString::number(i), false), &parent);
+        
+        if (broadcast) {
+            new BroadcastReceiver(m_soundcloud, track);
+        }
+    }
+    
+    SoundCloudTrack *target = new SoundCloudTrack(trackRecord("target", false), &parent);
+    SoundCloudTrack favourited(trackRecord("target", true));
+    const QMetaObject *metaObject = m_soundcloud->metaObject();
+    const QMetaMethod signal = metaObject->method(metaObject->indexOfSignal("trackFavourited(SoundCloudTrack*)"));
+    
+    QBENCHMARK {
+        signal.invoke(m_soundcloud, Qt::DirectConnection, Q_ARG(SoundCloudTrack*, &favourited));
+    }
+    
+    QVERIFY(target->isFavourite());
+}
+
+void tst_Bench_SoundCloudRegistry::modelUpdatesSameId() {
+    SoundCloudTrackModel model;
+    model.append(trackRecord("1", false));
+    model.append(trackRecord("2", false));
+    model.append(trackRecord("1", false));
+    
+    SoundCloudTrack favourited(trackRecord("1", true));
+    emitSignal("trackFavourited", &favourited);
+    QVERIFY(model.data(model.index(0), SoundCloudTrackModel::FavouriteRole).toBool());
+    QVERIFY(!model.data(model.index(1), SoundCloudTrackModel::FavouriteRole).toBool());
+    QVERIFY(model.data(model.index(2), SoundCloudTrackModel::FavouriteRole).toBool());
+    
+    // The rows of each id follow rows that are inserted and removed
+    model.insert(0, trackRecord("3", false));
+    model.remove(2);
+    QCOMPARE(model.rowCount(), 3);
+    
+    SoundCloudTrack unfavourited(trackRecord("1", false));
+    emitSignal("trackUnfavourited", &unfavourited);
+    QVERIFY(!model.data(model.index(1), SoundCloudTrackModel::FavouriteRole).toBool());
+    QVERIFY(!model.data(model.index(2), SoundCloudTrackModel::FavouriteRole).toBool());
+    
+    SoundCloudTrack favouritedOther(trackRecord("2", true));
+    emitSignal("trackFavourited", &favouritedOther);
+    QVERIFY(!model.data(model.index(0), SoundCloudTrackModel::FavouriteRole).toBool());
+    QVERIFY(!model.data(model.index(1), SoundCloudTrackModel::FavouriteRole).toBool());
+    QVERIFY(!model.data(model.index(2), SoundCloudTrackModel::FavouriteRole).toBool());
+    
+    // The track that was favourited has been updated by the track that was unfavourited
+    model.remove(0);
+    SoundCloudTrack favouritedAgain(trackRecord("1", true));
+    emitSignal("trackFavourited", &favouritedAgain);
+    QCOMPARE(model.data(model.index(0), SoundCloudTrackModel::IdRole).toString(), QString("1"));
+    QVERIFY(model.data(model.index(0), SoundCloudTrackModel::FavouriteRole).toBool());
+    QVERIFY(model.data(model.index(1), SoundCloudTrackModel::FavouriteRole).toBool());
+}
+
+void tst_Bench_SoundCloudRegistry::favouriteModels_data() {
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("scan");
+    
+    QTest::newRow("indexed rows, 10 models of 1000 tracks") << 10 << false;
+    QTest::newRow("indexed rows, 100 models of 1000 tracks") << 100 << false;
+    QTest::newRow("scanned rows, 10 models of 1000 tracks") << 10 << true;
+    QTest::newRow("scanned rows, 100 models of 1000 tracks") << 100 << true;
+}
+
+void tst_Bench_SoundCloudRegistry::favouriteModels() {
+    // Each model holds one row with the id of the favourited track among 1000 others
+    QFETCH(int, count);
+    QFETCH(bool, scan);
+    
+    QList<TrackRecord> records;
+    
+    for (int i = 0; i < 1000; i++) {
+        records << trackRecord(QString::number(i), false);
+    }
+    
+    records << trackRecord("target", false);
+    
+    QObject parent;
+    QList<SoundCloudTrackModel*> models;
+    QList<ScanningModel*> scanningModels;
+    
+    for (int i = 0; i < count; i++) {
+        if (scan) {
+            scanningModels << new ScanningModel(m_soundcloud, records, &parent);
+        }
+        else {
+            SoundCloudTrackModel *model = new SoundCloudTrackModel(&parent);
+            
+            foreach (const TrackRecord &record, records) {
+                model->append(record);
+            }
+            
+            models << model;
+        }
+    }
+    
+    SoundCloudTrack favourited(trackRecord("target", true));
+    const QMetaObject *metaObject = m_soundcloud->metaObject();
+    const QMetaMethod signal = metaObject->method(metaObject->indexOfSignal("trackFavourited(SoundCloudTrack*)"));
+    
+    QBENCHMARK {
+        signal.invoke(m_soundcloud, Qt::DirectConnection, Q_ARG(SoundCloudTrack*, &favourited));
+    }
+    
+    const int row = records.size() - 1;
+    
+    foreach (const SoundCloudTrackModel *model, models) {
+        QVERIFY(model->data(model->index(row), SoundCloudTrackModel::FavouriteRole).toBool());
+    }
+    
+    foreach (const ScanningModel *model, scanningModels) {
+        QVERIFY(model->isFavourite(row));
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_Bench_SoundCloudRegistry)
+#include "tst_bench_soundcloudregistry.moc"
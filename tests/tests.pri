@@ -0,0 +1,5 @@
+QT += testlib
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+APP_SRC = $$PWD/../app/src